@@ -1,40 +1,11 @@
-QT += core gui widgets sql
+# Корневой проект: генератор встроенного курса, приложение, утилита coursectl и тесты
+TEMPLATE = subdirs
 
-CONFIG += c++17
+SUBDIRS = coursegen app coursectl tests
 
-TARGET = CourseProject
-TEMPLATE = app
+coursegen.subdir = tools/coursegen
+coursectl.subdir = tools/coursectl
 
-DESTDIR = bin
-
-SOURCES += \
-    src/main.cpp \
-    src/db/DatabaseManager.cpp \
-    src/core/CryptoUtils.cpp \
-    src/core/CourseManager.cpp \
-    src/ui/LoginDialog.cpp \
-    src/ui/AdminWindow.cpp \
-    src/ui/StudentWindow.cpp
-
-HEADERS += \
-    src/db/DatabaseManager.h \
-    src/models/Structures.h \
-    src/core/CryptoUtils.h \
-    src/core/CourseManager.h \
-    src/ui/LoginDialog.h \
-    src/ui/AdminWindow.h \
-    src/ui/StudentWindow.h
-
-# Include paths
-INCLUDEPATH += src
-
-# PostgreSQL support
-unix {
-    CONFIG += link_pkgconfig
-    PKGCONFIG += libpq
-}
-
-# Debug configuration
-CONFIG(debug, debug|release) {
-    DEFINES += DEBUG
-}
\ No newline at end of file
+app.subdir = src
+# Приложение собирается после coursegen: он нужен для CONFIG+=embed_course
+app.depends = coursegen
@@ -1,5 +1,7 @@
 -- Database schema for HTTP Proxy Learning System
 -- Created: 2025-12-15
+-- Migration 1: initial schema. Statements are idempotent so that databases
+-- created from the former data/schema.sql can be brought under migrations.
 
 -- Users table for authentication and user management
 CREATE TABLE IF NOT EXISTS users (
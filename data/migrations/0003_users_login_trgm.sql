@@ -0,0 +1,14 @@
+-- Migration 3: substring login search in the admin window (login ILIKE '%text%')
+-- The trigram index is optional: search works without it, only slower.
+-- Creating the extension needs CREATE rights on the database (or an
+-- extension that is not installed on the server); without them the
+-- migration is still recorded and startup continues.
+DO $$
+BEGIN
+    CREATE EXTENSION IF NOT EXISTS pg_trgm;
+    CREATE INDEX IF NOT EXISTS idx_users_login_trgm ON users USING gin (login gin_trgm_ops);
+EXCEPTION
+    WHEN insufficient_privilege OR undefined_file THEN
+        RAISE NOTICE 'pg_trgm is not available (%), login search runs without the trigram index', SQLERRM;
+END
+$$;
@@ -0,0 +1,60 @@
+-- Migration 4: per-question attempt log with monthly partitions and rollups
+-- for the admin statistics tab.
+
+-- Append-only log of every answer. Rows are never updated; old months are
+-- removed by dropping their partition. No foreign key: the log is written
+-- with COPY and should not check users on every row.
+CREATE TABLE IF NOT EXISTS question_attempts (
+    user_id INTEGER NOT NULL,
+    chapter_id INTEGER NOT NULL,
+    question_index INTEGER NOT NULL,
+    chosen_option INTEGER NOT NULL,
+    correct BOOLEAN NOT NULL,
+    latency_ms INTEGER NOT NULL,
+    outcome TEXT,
+    answered_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+) PARTITION BY RANGE (answered_at);
+
+-- Rows arrive in time order, a BRIN index stays tiny
+CREATE INDEX IF NOT EXISTS idx_question_attempts_answered_at ON question_attempts USING brin (answered_at);
+CREATE INDEX IF NOT EXISTS idx_question_attempts_user_id ON question_attempts(user_id, answered_at);
+
+-- Creates the partition for the month containing month_day.
+-- Called by the client before each write for the months in the batch.
+CREATE OR REPLACE FUNCTION create_question_attempts_partition(month_day DATE) RETURNS VOID AS $$
+DECLARE
+    month_start DATE := date_trunc('month', month_day)::date;
+    partition_name TEXT := 'question_attempts_' || to_char(month_day, 'YYYY_MM');
+BEGIN
+    IF to_regclass(partition_name) IS NOT NULL THEN
+        RETURN;
+    END IF;
+    EXECUTE format('CREATE TABLE %I PARTITION OF question_attempts FOR VALUES FROM (%L) TO (%L)',
+                   partition_name, month_start, (month_start + INTERVAL '1 month')::date);
+EXCEPTION
+    -- Another client created the partition concurrently
+    WHEN duplicate_table THEN
+        NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT create_question_attempts_partition(CURRENT_DATE);
+SELECT create_question_attempts_partition((CURRENT_DATE + INTERVAL '1 month')::date);
+
+-- Rollups, updated in the same transaction as the log write.
+-- Difficulty = 1 - correct / attempts, average latency = total_latency_ms / attempts.
+CREATE TABLE IF NOT EXISTS question_stats (
+    chapter_id INTEGER NOT NULL,
+    question_index INTEGER NOT NULL,
+    attempts BIGINT NOT NULL DEFAULT 0,
+    correct BIGINT NOT NULL DEFAULT 0,
+    total_latency_ms BIGINT NOT NULL DEFAULT 0,
+    PRIMARY KEY (chapter_id, question_index)
+);
+
+-- Pass rate = tests_passed / (tests_passed + tests_failed)
+CREATE TABLE IF NOT EXISTS chapter_stats (
+    chapter_id INTEGER PRIMARY KEY,
+    tests_passed BIGINT NOT NULL DEFAULT 0,
+    tests_failed BIGINT NOT NULL DEFAULT 0
+);
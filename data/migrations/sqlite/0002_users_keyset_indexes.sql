@@ -0,0 +1,3 @@
+-- Migration 2: keyset pagination of the admin users table sorted by role or creation time
+CREATE INDEX IF NOT EXISTS idx_users_role_id ON users(role, id);
+CREATE INDEX IF NOT EXISTS idx_users_created_at_id ON users(created_at, id);
@@ -0,0 +1,3 @@
+-- Migration 3: substring login search in the admin window.
+-- SQLite has no trigram index; login LIKE '%text%' scans the users table.
+-- The migration is kept empty so that schema versions match PostgreSQL.
@@ -0,0 +1,32 @@
+-- Migration 4: per-question attempt log and rollups (SQLite backend)
+-- SQLite has no partitioning: the log is a plain table, the rollups match
+-- ../0004_question_attempts.sql.
+
+CREATE TABLE IF NOT EXISTS question_attempts (
+    user_id INTEGER NOT NULL,
+    chapter_id INTEGER NOT NULL,
+    question_index INTEGER NOT NULL,
+    chosen_option INTEGER NOT NULL,
+    correct BOOLEAN NOT NULL,
+    latency_ms INTEGER NOT NULL,
+    outcome TEXT,
+    answered_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE INDEX IF NOT EXISTS idx_question_attempts_answered_at ON question_attempts(answered_at);
+CREATE INDEX IF NOT EXISTS idx_question_attempts_user_id ON question_attempts(user_id, answered_at);
+
+CREATE TABLE IF NOT EXISTS question_stats (
+    chapter_id INTEGER NOT NULL,
+    question_index INTEGER NOT NULL,
+    attempts INTEGER NOT NULL DEFAULT 0,
+    correct INTEGER NOT NULL DEFAULT 0,
+    total_latency_ms INTEGER NOT NULL DEFAULT 0,
+    PRIMARY KEY (chapter_id, question_index)
+);
+
+CREATE TABLE IF NOT EXISTS chapter_stats (
+    chapter_id INTEGER PRIMARY KEY,
+    tests_passed INTEGER NOT NULL DEFAULT 0,
+    tests_failed INTEGER NOT NULL DEFAULT 0
+);
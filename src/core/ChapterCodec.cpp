@@ -0,0 +1,62 @@
+#include "core/ChapterCodec.h"
+
+namespace {
+
+QByteArray storeCompress(const QByteArray& data) {
+    return data;
+}
+
+QByteArray storeDecompress(const QByteArray& data, bool* ok) {
+    *ok = true;
+    return data;
+}
+
+QByteArray zlibCompress(const QByteArray& data) {
+    return qCompress(data, 9);
+}
+
+QByteArray zlibFastCompress(const QByteArray& data) {
+    return qCompress(data, 1);
+}
+
+QByteArray zlibDecompress(const QByteArray& data, bool* ok) {
+    // qUncompress возвращает пустой массив при поврежденных данных
+    QByteArray result = qUncompress(data);
+    *ok = !result.isEmpty() || data.size() <= 4;
+    return result;
+}
+
+// Таблица кодеков: идентификаторы записываются в файлы и не должны меняться
+const ChapterCodec CODECS[] = {
+    { ChapterCodec::None,     "none",      storeCompress,    storeDecompress },
+    { ChapterCodec::Zlib,     "zlib",      zlibCompress,     zlibDecompress },
+    { ChapterCodec::ZlibFast, "zlib-fast", zlibFastCompress, zlibDecompress },
+};
+
+} // namespace
+
+const ChapterCodec* ChapterCodec::byId(quint32 codecId) {
+    for (const ChapterCodec& codec : CODECS) {
+        if (codec.id == codecId) {
+            return &codec;
+        }
+    }
+    return nullptr;
+}
+
+const ChapterCodec* ChapterCodec::byName(const QString& codecName) {
+    for (const ChapterCodec& codec : CODECS) {
+        if (codecName == QLatin1String(codec.name)) {
+            return &codec;
+        }
+    }
+    return nullptr;
+}
+
+QList<const ChapterCodec*> ChapterCodec::available() {
+    QList<const ChapterCodec*> codecs;
+    for (const ChapterCodec& codec : CODECS) {
+        codecs.append(&codec);
+    }
+    return codecs;
+}
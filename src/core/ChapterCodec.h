@@ -0,0 +1,50 @@
+#ifndef CHAPTERCODEC_H
+#define CHAPTERCODEC_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+
+/**
+ * @brief Кодек сжатия блоков глав в бинарном файле курса.
+ * Идентификатор кодека хранится в заголовке файла. Новый кодек
+ * добавляется записью в таблицу кодеков в ChapterCodec.cpp.
+ * Сжатие выполняется до шифрования, распаковка - после расшифровки.
+ */
+struct ChapterCodec {
+    enum Id : quint32 {
+        None = 0,
+        Zlib = 1,
+        ZlibFast = 2
+    };
+
+    using CompressFunction = QByteArray (*)(const QByteArray& data);
+    using DecompressFunction = QByteArray (*)(const QByteArray& data, bool* ok);
+
+    quint32 id;
+    const char* name;
+    CompressFunction compress;
+    DecompressFunction decompress;
+
+    /**
+     * @brief Находит кодек по идентификатору из заголовка файла.
+     * @param codecId Идентификатор кодека
+     * @return Указатель на кодек или nullptr, если кодек неизвестен
+     */
+    static const ChapterCodec* byId(quint32 codecId);
+
+    /**
+     * @brief Находит кодек по имени ("none", "zlib", "zlib-fast").
+     * @param codecName Имя кодека
+     * @return Указатель на кодек или nullptr, если кодек неизвестен
+     */
+    static const ChapterCodec* byName(const QString& codecName);
+
+    /**
+     * @brief Получает список всех зарегистрированных кодеков.
+     * @return Список кодеков
+     */
+    static QList<const ChapterCodec*> available();
+};
+
+#endif // CHAPTERCODEC_H
@@ -0,0 +1,97 @@
+#include "core/CipherPipeline.h"
+#include <QThreadPool>
+#include <memory>
+
+namespace {
+
+// Отдельный пул, чтобы шифрование не конкурировало с другими задачами globalInstance()
+QThreadPool* cipherThreadPool() {
+    static QThreadPool pool;
+    return &pool;
+}
+
+} // namespace
+
+CipherPipeline::CipherPipeline(const XorKey& key)
+    : m_key(key), m_firstPendingTicket(0) {
+}
+
+CipherPipeline::~CipherPipeline() {
+    waitAll();
+}
+
+qint64 CipherPipeline::submit(char* data, qsizetype size, qint64 keyOffset) {
+    const XorKey* key = &m_key;
+
+    for (qsizetype chunkStart = 0; chunkStart < size; chunkStart += CHUNK_SIZE) {
+        qsizetype chunkSize = qMin(CHUNK_SIZE, size - chunkStart);
+        char* chunkData = data + chunkStart;
+        qint64 chunkOffset = keyOffset + chunkStart;
+
+        run([=]() {
+            CryptoUtils::xorInPlace(chunkData, chunkSize, *key, chunkOffset);
+        });
+    }
+
+    return m_firstPendingTicket + static_cast<qint64>(m_pending.size()) - 1;
+}
+
+qint64 CipherPipeline::run(std::function<void()> job) {
+    auto task = std::make_shared<std::packaged_task<void()>>(std::move(job));
+    m_pending.push_back(task->get_future());
+    cipherThreadPool()->start([task]() { (*task)(); });
+    return m_firstPendingTicket + static_cast<qint64>(m_pending.size()) - 1;
+}
+
+const XorKey& CipherPipeline::key() const {
+    return m_key;
+}
+
+void CipherPipeline::waitFor(qint64 ticket) {
+    while (!m_pending.empty() && m_firstPendingTicket <= ticket) {
+        m_pending.front().get();
+        m_pending.pop_front();
+        ++m_firstPendingTicket;
+    }
+}
+
+void CipherPipeline::waitAll() {
+    waitFor(m_firstPendingTicket + static_cast<qint64>(m_pending.size()));
+}
+
+bool CipherPipeline::readDecrypted(QIODevice* device, char* data, qsizetype size, qint64 keyOffset) {
+    qsizetype done = 0;
+    while (done < size) {
+        qsizetype chunkSize = qMin(CHUNK_SIZE, size - done);
+        if (device->read(data + done, chunkSize) != chunkSize) {
+            waitAll();
+            return false;
+        }
+
+        // Фрагмент расшифровывается в пуле, пока читается следующий
+        submit(data + done, chunkSize, keyOffset + done);
+        done += chunkSize;
+    }
+
+    waitAll();
+    return true;
+}
+
+void CipherPipeline::xorInPlaceParallel(char* data, qsizetype size, const XorKey& key, qint64 keyOffset) {
+    if (size <= CHUNK_SIZE) {
+        CryptoUtils::xorInPlace(data, size, key, keyOffset);
+        return;
+    }
+
+    CipherPipeline pipeline(key);
+    pipeline.submit(data, size, keyOffset);
+    pipeline.waitAll();
+}
+
+void CipherPipeline::setMaxThreadCount(int threads) {
+    cipherThreadPool()->setMaxThreadCount(qMax(1, threads));
+}
+
+int CipherPipeline::maxThreadCount() {
+    return cipherThreadPool()->maxThreadCount();
+}
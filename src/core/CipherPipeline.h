@@ -0,0 +1,111 @@
+#ifndef CIPHERPIPELINE_H
+#define CIPHERPIPELINE_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <deque>
+#include <functional>
+#include <future>
+#include "core/CryptoUtils.h"
+
+/**
+ * @brief Конвейер многопоточного XOR шифрования по фрагментам.
+ * Данные делятся на фрагменты CHUNK_SIZE байт, которые шифруются
+ * в пуле потоков, пока вызывающий поток читает или записывает файл.
+ * Для каждого фрагмента фаза ключа вычисляется из его смещения
+ * в потоке данных, поэтому результат совпадает с последовательным XOR.
+ */
+class CipherPipeline
+{
+public:
+    // Размер фрагмента, обрабатываемого одной задачей пула
+    static constexpr qsizetype CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Конструктор конвейера.
+     * @param key Подготовленный ключ шифрования
+     */
+    explicit CipherPipeline(const XorKey& key);
+
+    /**
+     * @brief Деструктор, дожидается завершения всех задач.
+     */
+    ~CipherPipeline();
+
+    /**
+     * @brief Ставит буфер в очередь на шифрование на месте.
+     * Буфер должен оставаться валидным до завершения waitFor().
+     * @param data Указатель на буфер
+     * @param size Размер буфера в байтах
+     * @param keyOffset Позиция буфера в потоке данных (фаза ключа)
+     * @return Номер задания для waitFor()
+     */
+    qint64 submit(char* data, qsizetype size, qint64 keyOffset);
+
+    /**
+     * @brief Ставит произвольную задачу в очередь пула, например
+     * сжатие и шифрование блока одной задачей.
+     * @param job Задача для выполнения в пуле потоков
+     * @return Номер задания для waitFor()
+     */
+    qint64 run(std::function<void()> job);
+
+    /**
+     * @brief Получает подготовленный ключ конвейера.
+     * @return Ссылка на ключ
+     */
+    const XorKey& key() const;
+
+    /**
+     * @brief Дожидается завершения задания и всех заданий до него.
+     * @param ticket Номер задания, полученный из submit()
+     */
+    void waitFor(qint64 ticket);
+
+    /**
+     * @brief Дожидается завершения всех заданий.
+     */
+    void waitAll();
+
+    /**
+     * @brief Читает данные из устройства и расшифровывает их конвейером:
+     * пока пул расшифровывает прочитанный фрагмент, читается следующий.
+     * @param device Устройство для чтения
+     * @param data Буфер назначения
+     * @param size Количество байт для чтения
+     * @param keyOffset Позиция данных в потоке (фаза ключа)
+     * @return true если все данные прочитаны, false в противном случае
+     */
+    bool readDecrypted(QIODevice* device, char* data, qsizetype size, qint64 keyOffset = 0);
+
+    /**
+     * @brief Шифрует или дешифрует буфер на месте во всех потоках пула.
+     * Небольшие буферы обрабатываются в вызывающем потоке.
+     * @param data Указатель на буфер
+     * @param size Размер буфера в байтах
+     * @param key Подготовленный ключ
+     * @param keyOffset Позиция буфера в потоке данных (фаза ключа)
+     */
+    static void xorInPlaceParallel(char* data, qsizetype size, const XorKey& key, qint64 keyOffset = 0);
+
+    /**
+     * @brief Изменяет число потоков пула шифрования (по умолчанию - число ядер).
+     * @param threads Число потоков
+     */
+    static void setMaxThreadCount(int threads);
+
+    /**
+     * @brief Получает число потоков пула шифрования.
+     * @return Количество потоков
+     */
+    static int maxThreadCount();
+
+private:
+    Q_DISABLE_COPY(CipherPipeline)
+
+    XorKey m_key;
+    std::deque<std::future<void>> m_pending;
+    qint64 m_firstPendingTicket;
+};
+
+#endif // CIPHERPIPELINE_H
@@ -0,0 +1,56 @@
+#ifndef COURSEFORMAT_H
+#define COURSEFORMAT_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Константы бинарного формата файла курса (course.bin).
+ *
+ * Формат v1: MAGIC_V1, затем один зашифрованный QByteArray со всем курсом.
+ *
+ * Формат v2: заголовок фиксированного размера, независимо зашифрованные
+ * блоки глав и таблица смещений (индекс) в конце файла:
+ *   [MAGIC_V2][version][chapterCount][indexOffset]
+ *   [блок главы 0][блок главы 1]...
+ *   [offset, length] x chapterCount
+ * Версия 3 добавляет в конец заголовка идентификатор кодека сжатия
+ * (ChapterCodec::Id), блоки глав сжимаются до шифрования.
+ * Версия 4 добавляет контрольные суммы CRC32C: в заголовке - сумма
+ * заголовка и таблицы смещений, в каждой записи индекса - сумма
+ * зашифрованного блока главы. Блоки проверяются лениво, при обращении.
+ * Все числа записываются в big-endian (порядок QDataStream).
+ */
+namespace CourseFormat {
+
+constexpr quint32 MAGIC_V1 = 0x434F5253; // "CORS" in hex
+constexpr quint32 MAGIC_V2 = 0x434F5232; // "COR2" in hex
+
+constexpr quint32 VERSION = 4;
+
+// magic + version + chapterCount + indexOffset
+constexpr qint64 HEADER_SIZE_V2 = 4 + 4 + 4 + 8;
+// + codec
+constexpr qint64 HEADER_SIZE_V3 = HEADER_SIZE_V2 + 4;
+// + headerChecksum
+constexpr qint64 HEADER_SIZE = HEADER_SIZE_V3 + 4;
+// offset + length
+constexpr qint64 INDEX_ENTRY_SIZE_V3 = 8 + 4;
+// + checksum
+constexpr qint64 INDEX_ENTRY_SIZE = INDEX_ENTRY_SIZE_V3 + 4;
+
+/**
+ * @brief Запись таблицы смещений: положение блока главы в файле.
+ */
+struct IndexEntry {
+    quint64 offset;
+    quint32 length;
+    quint32 checksum;
+
+    IndexEntry() : offset(0), length(0), checksum(0) {}
+    IndexEntry(quint64 blockOffset, quint32 blockLength, quint32 blockChecksum = 0)
+        : offset(blockOffset), length(blockLength), checksum(blockChecksum) {}
+};
+
+} // namespace CourseFormat
+
+#endif // COURSEFORMAT_H
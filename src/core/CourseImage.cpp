@@ -0,0 +1,443 @@
+#include "core/CourseImage.h"
+#include "core/CourseManager.h"
+#include "core/CourseJournal.h"
+#include "core/CipherPipeline.h"
+#include <QDataStream>
+#include <QtEndian>
+#include <QDebug>
+
+CourseImage::CourseImage()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_journalData(nullptr)
+    , m_journalLength(0)
+    , m_codec(nullptr)
+    , m_formatVersion(0) {
+}
+
+CourseImage::~CourseImage() {
+    close();
+}
+
+bool CourseImage::open(const QString& binPath, const QString& key) {
+    close();
+
+    m_file.setFileName(binPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open binary file for reading:" << binPath;
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(quint32))) {
+        qWarning() << "Invalid file format - file is too small:" << binPath;
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "Cannot map binary file:" << m_file.errorString();
+        close();
+        return false;
+    }
+
+    quint32 magicNumber = qFromBigEndian<quint32>(m_data);
+
+    if (magicNumber == CourseFormat::MAGIC_V1) {
+        // Старый формат без индекса - курс расшифровывается целиком
+        close();
+        m_legacyCourse = CourseManager::loadCourseFromBinary(binPath, key);
+        if (m_legacyCourse.chapters.isEmpty()) {
+            return false;
+        }
+        m_key = XorKey(key);
+        m_formatVersion = 1;
+        openJournal(binPath);
+        return true;
+    }
+
+    if (!openImage(key)) {
+        close();
+        return false;
+    }
+
+    openJournal(binPath);
+    return true;
+}
+
+bool CourseImage::openMemory(const uchar* data, qint64 size, const QString& key) {
+    close();
+
+    if (!data || size < static_cast<qint64>(sizeof(quint32))) {
+        qWarning() << "Invalid embedded course image";
+        return false;
+    }
+
+    // Блоки глав ссылаются прямо на переданную память, без копирования
+    m_data = data;
+    m_size = size;
+    if (!openImage(key)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CourseImage::openImage(const QString& key) {
+    quint32 magicNumber = qFromBigEndian<quint32>(m_data);
+
+    if (magicNumber != CourseFormat::MAGIC_V2 || m_size < CourseFormat::HEADER_SIZE_V2) {
+        qWarning() << "Invalid file format - magic number mismatch";
+        return false;
+    }
+
+    quint32 version = qFromBigEndian<quint32>(m_data + 4);
+    quint32 chapterCount = qFromBigEndian<quint32>(m_data + 8);
+    quint64 indexOffset = qFromBigEndian<quint64>(m_data + 12);
+
+    if (version < 2 || version > CourseFormat::VERSION) {
+        qWarning() << "Unsupported course format version:" << version;
+        return false;
+    }
+
+    // Версия 2 не содержит кодека: блоки глав хранятся без сжатия
+    qint64 headerSize = CourseFormat::HEADER_SIZE_V2;
+    quint32 codecId = ChapterCodec::None;
+    if (version >= 3) {
+        headerSize = version >= 4 ? CourseFormat::HEADER_SIZE : CourseFormat::HEADER_SIZE_V3;
+        if (m_size < headerSize) {
+            qWarning() << "Invalid file format - truncated header";
+            return false;
+        }
+        codecId = qFromBigEndian<quint32>(m_data + CourseFormat::HEADER_SIZE_V2);
+    }
+
+    // С версии 4 записи индекса содержат контрольную сумму блока
+    const bool hasChecksums = version >= 4;
+    const qint64 entrySize = hasChecksums ? CourseFormat::INDEX_ENTRY_SIZE : CourseFormat::INDEX_ENTRY_SIZE_V3;
+
+    m_codec = ChapterCodec::byId(codecId);
+    if (!m_codec) {
+        qWarning() << "Unsupported chapter compression codec:" << codecId;
+        return false;
+    }
+
+    // Проверка границ таблицы смещений до обращения к ней
+    quint64 fileSize = static_cast<quint64>(m_size);
+    if (indexOffset < static_cast<quint64>(headerSize) || indexOffset > fileSize
+        || chapterCount > (fileSize - indexOffset) / static_cast<quint64>(entrySize)) {
+        qWarning() << "Invalid file format - corrupted chapter index";
+        return false;
+    }
+
+    // Сумма заголовка проверяется сразу: без нее нельзя доверять индексу
+    if (hasChecksums) {
+        quint32 expected = qFromBigEndian<quint32>(m_data + CourseFormat::HEADER_SIZE_V3);
+        quint32 actual = CryptoUtils::crc32c(m_data, CourseFormat::HEADER_SIZE_V3);
+        actual = CryptoUtils::crc32c(m_data + indexOffset, chapterCount * entrySize, actual);
+        if (actual != expected) {
+            qWarning() << "Invalid file format - header checksum mismatch, expected"
+                       << Qt::hex << expected << "actual" << actual;
+            return false;
+        }
+    }
+
+    m_blocks.resize(static_cast<int>(chapterCount));
+    const uchar* entryData = m_data + indexOffset;
+    for (quint32 i = 0; i < chapterCount; ++i) {
+        CourseFormat::IndexEntry entry(qFromBigEndian<quint64>(entryData),
+                                       qFromBigEndian<quint32>(entryData + 8),
+                                       hasChecksums ? qFromBigEndian<quint32>(entryData + 12) : 0);
+        entryData += entrySize;
+
+        if (entry.offset < static_cast<quint64>(headerSize)
+            || entry.offset > indexOffset || entry.length > indexOffset - entry.offset) {
+            qWarning() << "Invalid file format - chapter block" << i << "is out of bounds";
+            return false;
+        }
+
+        m_blocks[static_cast<int>(i)] = BlockRef{m_data + entry.offset, entry.length, m_codec,
+                                                 entry.checksum, hasChecksums,
+                                                 static_cast<qint64>(entry.offset), false};
+    }
+
+    m_key = XorKey(key);
+    m_formatVersion = static_cast<int>(version);
+    return true;
+}
+
+bool CourseImage::openJournal(const QString& binPath) {
+    m_journalFile.setFileName(CourseJournal::journalPath(binPath));
+    if (!m_journalFile.exists()) {
+        return false;
+    }
+
+    if (!m_journalFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open course journal:" << m_journalFile.fileName();
+        return false;
+    }
+
+    qint64 journalSize = m_journalFile.size();
+    m_journalData = journalSize > 0 ? m_journalFile.map(0, journalSize) : nullptr;
+    if (!m_journalData) {
+        m_journalFile.close();
+        return false;
+    }
+
+    // Записи применяются по порядку: последняя версия главы побеждает
+    const QVector<CourseJournal::Record> records = CourseJournal::parseRecords(m_journalData, journalSize);
+    for (const CourseJournal::Record& record : records) {
+        m_journalLength = record.offset + record.length;
+
+        // Заголовок записи не покрыт ее контрольной суммой: индекс главы
+        // сравнивается без знака, чтобы большое значение не стало отрицательным
+        const ChapterCodec* codec = ChapterCodec::byId(record.codecId);
+        if (!codec || record.chapterIndex >= static_cast<quint32>(chapterCount())) {
+            qWarning() << "Skipping invalid journal record for chapter" << record.chapterIndex;
+            continue;
+        }
+        const int index = static_cast<int>(record.chapterIndex);
+
+        BlockRef block{m_journalData + record.offset, record.length, codec,
+                       record.checksum, record.hasChecksum, record.offset, true};
+        if (m_formatVersion == 1) {
+            QString errorMessage;
+            if (!decodeBlock(block, index, m_legacyCourse.chapters[index], &errorMessage)) {
+                qWarning() << "Skipping journal record:" << errorMessage;
+            }
+        } else {
+            m_blocks[index] = block;
+        }
+    }
+
+    if (!records.isEmpty()) {
+        qDebug() << "Applied" << records.size() << "journal records to course";
+    }
+    return true;
+}
+
+void CourseImage::close() {
+    if (m_journalData) {
+        m_journalFile.unmap(const_cast<uchar*>(m_journalData));
+        m_journalData = nullptr;
+    }
+    if (m_journalFile.isOpen()) {
+        m_journalFile.close();
+    }
+    m_journalLength = 0;
+
+    if (m_data) {
+        // Память, переданная в openMemory(), принадлежит вызывающей стороне
+        if (m_file.isOpen()) {
+            m_file.unmap(const_cast<uchar*>(m_data));
+        }
+        m_data = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_blocks.clear();
+    m_key = XorKey();
+    m_codec = nullptr;
+    m_legacyCourse = Course();
+    m_formatVersion = 0;
+}
+
+bool CourseImage::isOpen() const {
+    return m_formatVersion != 0;
+}
+
+int CourseImage::formatVersion() const {
+    return m_formatVersion;
+}
+
+const ChapterCodec* CourseImage::codec() const {
+    return m_codec;
+}
+
+int CourseImage::chapterCount() const {
+    if (m_formatVersion == 1) {
+        return m_legacyCourse.chapters.size();
+    }
+    return m_blocks.size();
+}
+
+bool CourseImage::readChapter(int index, Chapter& chapter, QString* errorMessage) const {
+    if (index < 0 || index >= chapterCount()) {
+        return fail(errorMessage, QString("Chapter index out of range: %1").arg(index));
+    }
+
+    if (m_formatVersion == 1) {
+        chapter = m_legacyCourse.chapters.at(index);
+        return true;
+    }
+
+    return decodeBlock(m_blocks[index], index, chapter, errorMessage);
+}
+
+bool CourseImage::verifyChapter(int index, QString* errorMessage) const {
+    if (index < 0 || index >= chapterCount()) {
+        return fail(errorMessage, QString("Chapter index out of range: %1").arg(index));
+    }
+
+    if (m_formatVersion == 1) {
+        return true;
+    }
+
+    return verifyBlock(m_blocks[index], index, errorMessage);
+}
+
+bool CourseImage::verify(QStringList* errors) const {
+    // Полная проверка читает только зашифрованные блоки, без расшифровки
+    bool valid = true;
+    for (int i = 0; i < m_blocks.size(); ++i) {
+        QString errorMessage;
+        if (!verifyBlock(m_blocks[i], i, &errorMessage)) {
+            valid = false;
+            if (errors) {
+                errors->append(errorMessage);
+            }
+        }
+    }
+    return valid;
+}
+
+bool CourseImage::verifyBlock(const BlockRef& block, int index, QString* errorMessage) const {
+    if (!block.hasChecksum) {
+        return true;
+    }
+
+    quint32 actual = CryptoUtils::crc32c(block.data, block.length);
+    if (actual != block.checksum) {
+        return fail(errorMessage, QString("Chapter %1 is corrupted at %2: checksum mismatch (expected %3, actual %4)")
+                                      .arg(index)
+                                      .arg(location(block))
+                                      .arg(block.checksum, 8, 16, QLatin1Char('0'))
+                                      .arg(actual, 8, 16, QLatin1Char('0')));
+    }
+    return true;
+}
+
+bool CourseImage::decodeBlock(const BlockRef& block, int index, Chapter& chapter, QString* errorMessage,
+                              bool parallelCipher) const {
+    // Поврежденный блок не расшифровывается: иначе QDataStream
+    // прочитал бы случайные длины строк и списков
+    if (!verifyBlock(block, index, errorMessage)) {
+        return false;
+    }
+
+    // Отображение доступно только для чтения: блок копируется один раз
+    // и расшифровывается на месте
+    QByteArray decryptedData(reinterpret_cast<const char*>(block.data),
+                             static_cast<qsizetype>(block.length));
+    // Внутри задачи пула блок расшифровывается в ее потоке: ожидание
+    // других задач того же пула могло бы занять все его потоки
+    if (parallelCipher) {
+        CipherPipeline::xorInPlaceParallel(decryptedData.data(), decryptedData.size(), m_key);
+    } else {
+        CryptoUtils::xorInPlace(decryptedData.data(), decryptedData.size(), m_key);
+    }
+
+    // Распаковка выполняется только для запрошенной главы
+    bool decompressed = false;
+    QByteArray chapterData = block.codec->decompress(decryptedData, &decompressed);
+    if (!decompressed) {
+        return fail(errorMessage, QString("Failed to decompress chapter %1 at %2 with codec %3")
+                                      .arg(index).arg(location(block), QString::fromLatin1(block.codec->name)));
+    }
+
+    Chapter decoded;
+    QDataStream chapterStream(&chapterData, QIODevice::ReadOnly);
+    chapterStream >> decoded;
+
+    if (chapterStream.status() != QDataStream::Ok) {
+        return fail(errorMessage, QString("Failed to decode chapter %1 at %2").arg(index).arg(location(block)));
+    }
+
+    chapter = decoded;
+    return true;
+}
+
+QString CourseImage::location(const BlockRef& block) {
+    return QString("%1 offset %2, length %3")
+        .arg(block.inJournal ? "journal" : "file")
+        .arg(block.offset)
+        .arg(block.length);
+}
+
+bool CourseImage::fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+    return false;
+}
+
+bool CourseImage::toCourse(Course& course, QString* errorMessage) const {
+    if (m_formatVersion == 1) {
+        course = m_legacyCourse;
+        return true;
+    }
+
+    Course decoded;
+    decoded.chapters.resize(m_blocks.size());
+    QVector<QString> errors(m_blocks.size());
+    Chapter* chapters = decoded.chapters.data();
+    QString* chapterErrors = errors.data();
+
+    // Проверка, расшифровка, распаковка и десериализация глав выполняются
+    // в пуле; каждая задача пишет только в свои элементы chapters и errors
+    CipherPipeline pipeline(m_key);
+    int first = 0;
+    while (first < m_blocks.size()) {
+        int last = first;
+        qsizetype groupBytes = 0;
+        while (last < m_blocks.size() && (last == first || groupBytes < CipherPipeline::CHUNK_SIZE)) {
+            groupBytes += m_blocks[last].length;
+            ++last;
+        }
+
+        pipeline.run([this, first, last, chapters, chapterErrors]() {
+            for (int i = first; i < last; ++i) {
+                decodeBlock(m_blocks[i], i, chapters[i], &chapterErrors[i], false);
+            }
+        });
+        first = last;
+    }
+    pipeline.waitAll();
+
+    // Ошибка первой поврежденной главы, как при последовательном чтении
+    for (int i = 0; i < errors.size(); ++i) {
+        if (!errors.at(i).isEmpty()) {
+            return fail(errorMessage, errors.at(i));
+        }
+    }
+    course = decoded;
+    return true;
+}
+
+bool CourseImage::toCompactCourse(CompactCourse& compact, QString* errorMessage) const {
+    if (m_formatVersion == 1) {
+        compact = CompactCourse::fromCourse(m_legacyCourse);
+        return true;
+    }
+
+    CompactCourse decoded;
+    for (int i = 0; i < chapterCount(); ++i) {
+        Chapter chapter;
+        if (!readChapter(i, chapter, errorMessage)) {
+            return false;
+        }
+        if (!decoded.appendChapter(chapter)) {
+            return fail(errorMessage, QString("Compact course string arena overflow at chapter %1").arg(i));
+        }
+    }
+    decoded.squeeze();
+    compact = decoded;
+    return true;
+}
+
+qint64 CourseImage::journalLength() const {
+    return m_journalLength;
+}
@@ -0,0 +1,171 @@
+#ifndef COURSEIMAGE_H
+#define COURSEIMAGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QVector>
+#include "core/CourseFormat.h"
+#include "core/CryptoUtils.h"
+#include "core/ChapterCodec.h"
+#include "models/Structures.h"
+#include "models/CompactCourse.h"
+
+/**
+ * @brief Отображенный в память файл курса с ленивой расшифровкой глав.
+ * Файл формата v2 открывается через QFile::map (mmap), при открытии
+ * читаются только заголовок и таблица смещений. Каждая глава
+ * расшифровывается, распаковывается и десериализуется при обращении к ней.
+ * Файлы формата v1 загружаются целиком через CourseManager.
+ * Если рядом с файлом есть журнал изменений (CourseJournal), его записи
+ * накладываются поверх глав базового файла.
+ */
+class CourseImage
+{
+public:
+    CourseImage();
+    ~CourseImage();
+
+    /**
+     * @brief Открывает бинарный файл курса.
+     * @param binPath Путь к бинарному файлу
+     * @param key Ключ для расшифровки данных
+     * @return true если файл открыт успешно, false в противном случае
+     */
+    bool open(const QString& binPath, const QString& key);
+
+    /**
+     * @brief Открывает образ курса, уже находящийся в памяти.
+     * Используется для курса, встроенного в исполняемый файл при сборке.
+     * Данные не копируются и должны оставаться доступными до close().
+     * Поддерживаются форматы v2 и выше, журнал изменений не применяется.
+     * @param data Указатель на образ курса
+     * @param size Размер образа в байтах
+     * @param key Ключ для расшифровки данных
+     * @return true если образ открыт успешно, false в противном случае
+     */
+    bool openMemory(const uchar* data, qint64 size, const QString& key);
+
+    /**
+     * @brief Закрывает файл и освобождает отображение.
+     */
+    void close();
+
+    /**
+     * @brief Проверяет, открыт ли курс.
+     * @return true если курс открыт, false в противном случае
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Получает версию формата открытого файла.
+     * @return 1, 2, 3 или 4, 0 если файл не открыт
+     */
+    int formatVersion() const;
+
+    /**
+     * @brief Получает кодек сжатия блоков глав.
+     * @return Указатель на кодек, nullptr для формата v1
+     */
+    const ChapterCodec* codec() const;
+
+    /**
+     * @brief Получает количество глав курса.
+     * @return Количество глав
+     */
+    int chapterCount() const;
+
+    /**
+     * @brief Проверяет контрольную сумму и расшифровывает главу.
+     * @param index Индекс главы
+     * @param chapter Результат; не изменяется при ошибке
+     * @param errorMessage Описание ошибки (номер главы, смещение блока и причина), может быть nullptr
+     * @return true если глава прочитана успешно, false в противном случае
+     */
+    bool readChapter(int index, Chapter& chapter, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Проверяет контрольную сумму блока главы без расшифровки.
+     * Для форматов без контрольных сумм (до v4) всегда возвращает true.
+     * @param index Индекс главы
+     * @param errorMessage Описание ошибки, может быть nullptr
+     * @return true если блок главы не поврежден
+     */
+    bool verifyChapter(int index, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Проверяет контрольные суммы всех блоков глав.
+     * @param errors Список найденных ошибок, может быть nullptr
+     * @return true если ни один блок не поврежден
+     */
+    bool verify(QStringList* errors = nullptr) const;
+
+    /**
+     * @brief Расшифровывает все главы в объект Course.
+     * Главы декодируются параллельно в пуле CipherPipeline: группы глав
+     * общим размером около CipherPipeline::CHUNK_SIZE - задачи пула.
+     * Поврежденная глава не заменяется пустой: курс не возвращается целиком.
+     * @param course Результат; не изменяется при ошибке
+     * @param errorMessage Описание ошибки первой непрочитанной главы, может быть nullptr
+     * @return true если прочитаны все главы, false в противном случае
+     */
+    bool toCourse(Course& course, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Расшифровывает все главы в компактное представление.
+     * Главы декодируются по одной, полный Course в памяти не создается.
+     * @param compact Результат; не изменяется при ошибке
+     * @param errorMessage Описание ошибки, может быть nullptr
+     * @return true если прочитаны все главы, false в противном случае
+     */
+    bool toCompactCourse(CompactCourse& compact, QString* errorMessage = nullptr) const;
+
+    /**
+     * @brief Получает длину примененной части журнала изменений.
+     * @return Количество байт журнала, 0 если журнала нет
+     */
+    qint64 journalLength() const;
+
+private:
+    Q_DISABLE_COPY(CourseImage)
+
+    /**
+     * @brief Ссылка на зашифрованный блок главы в базовом файле или журнале.
+     */
+    struct BlockRef {
+        const uchar* data;
+        quint32 length;
+        const ChapterCodec* codec;
+        quint32 checksum;
+        bool hasChecksum;
+        // Смещение блока в базовом файле или в журнале - для сообщений об ошибках
+        qint64 offset;
+        bool inJournal;
+    };
+
+    bool openImage(const QString& key);
+    bool openJournal(const QString& binPath);
+    bool verifyBlock(const BlockRef& block, int index, QString* errorMessage) const;
+    bool decodeBlock(const BlockRef& block, int index, Chapter& chapter, QString* errorMessage,
+                     bool parallelCipher = true) const;
+    static QString location(const BlockRef& block);
+    static bool fail(QString* errorMessage, const QString& message);
+
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    QVector<BlockRef> m_blocks;
+    XorKey m_key;
+
+    QFile m_journalFile;
+    const uchar* m_journalData;
+    qint64 m_journalLength;
+
+    const ChapterCodec* m_codec;
+
+    // Курс формата v1, загруженный целиком
+    Course m_legacyCourse;
+    int m_formatVersion;
+};
+
+#endif // COURSEIMAGE_H
@@ -0,0 +1,279 @@
+#include "core/CourseJournal.h"
+#include "core/CourseImage.h"
+#include "core/CourseManager.h"
+#include "core/CryptoUtils.h"
+#include <QFile>
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtEndian>
+#include <QDebug>
+#include <atomic>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+// Дописывание и слияние журнала внутри процесса выполняются по очереди
+QMutex& journalMutex() {
+    static QMutex mutex;
+    return mutex;
+}
+
+std::atomic<bool> compactionRunning(false);
+
+// Заменяет файл другим одной операцией: читатели видят старый или новый файл.
+// rename() в Windows не заменяет существующий файл, там используется MoveFileEx
+bool replaceFile(const QString& sourcePath, const QString& targetPath) {
+#ifdef Q_OS_WIN
+    return MoveFileExW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(sourcePath).utf16()),
+                       reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(targetPath).utf16()),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(QFile::encodeName(sourcePath).constData(), QFile::encodeName(targetPath).constData()) == 0;
+#endif
+}
+
+} // namespace
+
+QString CourseJournal::journalPath(const QString& binPath) {
+    return binPath + ".journal";
+}
+
+bool CourseJournal::appendChapter(const QString& binPath, int chapterIndex, const Chapter& chapter,
+                                  const QString& key, quint32 codecId) {
+    const ChapterCodec* codec = ChapterCodec::byId(codecId);
+    if (!codec || chapterIndex < 0) {
+        qWarning() << "Invalid journal record for chapter" << chapterIndex;
+        return false;
+    }
+
+    // Запись готовится до блокировки: сериализация, сжатие и шифрование одной главы
+    QByteArray chapterData;
+    QDataStream chapterStream(&chapterData, QIODevice::WriteOnly);
+    chapterStream << chapter;
+    QByteArray block = codec->compress(chapterData);
+    CryptoUtils::xorInPlace(block.data(), block.size(), XorKey(key));
+    const quint32 checksum = CryptoUtils::crc32c(block.constData(), block.size());
+
+    QMutexLocker locker(&journalMutex());
+
+    QFile file(journalPath(binPath));
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open course journal for writing:" << file.fileName();
+        return false;
+    }
+
+    // Конец последней целой записи: оборванная при сбое запись затирается
+    qint64 validLength = 0;
+    quint32 version = VERSION;
+    if (file.size() >= HEADER_SIZE) {
+        const uchar* data = file.map(0, file.size());
+        if (!data) {
+            qWarning() << "Cannot map course journal:" << file.errorString();
+            return false;
+        }
+
+        const quint32 magic = qFromBigEndian<quint32>(data);
+        if (magic == MAGIC) {
+            // Записи дописываются в формате существующего журнала
+            version = qFromBigEndian<quint32>(data + 4);
+            validLength = HEADER_SIZE;
+            const QVector<Record> records = parseRecords(data, file.size());
+            if (!records.isEmpty()) {
+                validLength = records.last().offset + records.last().length;
+            }
+        }
+        file.unmap(const_cast<uchar*>(data));
+
+        // Журнал с поврежденным заголовком не перезаписывается: в нем
+        // могут быть еще не слитые с курсом изменения
+        if (magic != MAGIC) {
+            qWarning() << "Invalid course journal header, refusing to append:" << file.fileName();
+            return false;
+        }
+    }
+
+    if (version == 0 || version > VERSION) {
+        qWarning() << "Unsupported course journal version:" << version;
+        return false;
+    }
+
+    if (validLength == 0) {
+        // Нового журнала или оборванного при создании заголовка
+        file.resize(0);
+        QDataStream headerStream(&file);
+        headerStream << MAGIC << VERSION;
+        validLength = HEADER_SIZE;
+    } else if (validLength < file.size()) {
+        qWarning() << "Discarding truncated journal record in" << file.fileName();
+        file.resize(validLength);
+    }
+
+    QByteArray record;
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+    recordStream << static_cast<quint32>(chapterIndex) << codec->id << static_cast<quint32>(block.size());
+    if (version >= 2) {
+        recordStream << checksum;
+    }
+    record.append(block);
+
+    file.seek(validLength);
+    if (file.write(record) != record.size() || !file.flush()) {
+        qWarning() << "Failed to append course journal record:" << file.errorString();
+        file.resize(validLength);
+        return false;
+    }
+
+    return true;
+}
+
+QVector<CourseJournal::Record> CourseJournal::parseRecords(const uchar* data, qint64 size) {
+    QVector<Record> records;
+    if (!data || size < HEADER_SIZE || qFromBigEndian<quint32>(data) != MAGIC) {
+        return records;
+    }
+
+    const quint32 version = qFromBigEndian<quint32>(data + 4);
+    if (version == 0 || version > VERSION) {
+        return records;
+    }
+
+    const qint64 recordHeaderSize = version >= 2 ? RECORD_HEADER_SIZE : RECORD_HEADER_SIZE_V1;
+    qint64 pos = HEADER_SIZE;
+    while (size - pos >= recordHeaderSize) {
+        Record record;
+        record.chapterIndex = qFromBigEndian<quint32>(data + pos);
+        record.codecId = qFromBigEndian<quint32>(data + pos + 4);
+        record.length = qFromBigEndian<quint32>(data + pos + 8);
+        record.hasChecksum = version >= 2;
+        record.checksum = record.hasChecksum ? qFromBigEndian<quint32>(data + pos + 12) : 0;
+        record.offset = pos + recordHeaderSize;
+
+        if (record.length > size - record.offset) {
+            // Запись оборвана - дальше журнал не читается
+            break;
+        }
+
+        records.append(record);
+        pos = record.offset + record.length;
+    }
+
+    return records;
+}
+
+bool CourseJournal::openImage(CourseImage& image, const QString& binPath, const QString& key) {
+    QMutexLocker locker(&journalMutex());
+    return image.open(binPath, key);
+}
+
+bool CourseJournal::needsCompaction(const QString& binPath) {
+    QFile file(journalPath(binPath));
+    return file.exists() && file.size() > COMPACTION_THRESHOLD;
+}
+
+bool CourseJournal::compact(const QString& binPath, const QString& key) {
+    const QString path = journalPath(binPath);
+    const QString compactedPath = binPath + ".compact";
+
+    // Снимок базового файла и журнала; главы расшифровываются без блокировки,
+    // так как дописывание не меняет уже отображенные байты
+    CourseImage image;
+    if (!openImage(image, binPath, key)) {
+        return false;
+    }
+    const qint64 appliedLength = qMax(image.journalLength(), HEADER_SIZE);
+
+    // Непрочитанная глава прерывает слияние: журнал с ее исправной копией
+    // остается на месте, поврежденный блок не заменяется пустой главой
+    Course course;
+    QString errorMessage;
+    if (!image.toCourse(course, &errorMessage)) {
+        qWarning().noquote() << "Course journal compaction aborted:" << errorMessage;
+        return false;
+    }
+
+    quint32 codecId = image.codec() ? image.codec()->id : static_cast<quint32>(ChapterCodec::Zlib);
+    if (!CourseManager::saveCourseToBinary(course, compactedPath, key, codecId)) {
+        QFile::remove(compactedPath);
+        return false;
+    }
+    image.close();
+
+    QMutexLocker locker(&journalMutex());
+
+    // Записи, добавленные во время слияния, переносятся в новый журнал
+    // с той же версией формата записей
+    const quint32 version = readVersion(path);
+    QByteArray tail;
+    QFile journal(path);
+    if (journal.open(QIODevice::ReadOnly)) {
+        if (journal.size() > appliedLength && journal.seek(appliedLength)) {
+            tail = journal.readAll();
+        }
+        journal.close();
+    }
+
+    if (!replaceFile(compactedPath, binPath)) {
+        qWarning() << "Failed to replace course file with compacted image:" << binPath;
+        QFile::remove(compactedPath);
+        return false;
+    }
+
+    // Если журнал не переписан, остается прежний: его записи, уже слитые
+    // с курсом, при открытии применяются повторно с тем же результатом
+    if (tail.isEmpty()) {
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qWarning() << "Failed to remove compacted course journal:" << path;
+            return false;
+        }
+    } else {
+        QSaveFile newJournal(path);
+        bool written = newJournal.open(QIODevice::WriteOnly);
+        if (written) {
+            QDataStream headerStream(&newJournal);
+            headerStream << MAGIC << version;
+            written = headerStream.status() == QDataStream::Ok && newJournal.write(tail) == tail.size();
+        }
+        if (!written || !newJournal.commit()) {
+            qWarning() << "Failed to rewrite course journal after compaction:" << path << newJournal.errorString();
+            return false;
+        }
+    }
+
+    qDebug() << "Course journal compacted into" << binPath;
+    return true;
+}
+
+quint32 CourseJournal::readVersion(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return VERSION;
+    }
+
+    quint32 magic = 0;
+    quint32 version = VERSION;
+    QDataStream stream(&file);
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != MAGIC) {
+        return VERSION;
+    }
+    return version;
+}
+
+void CourseJournal::compactInBackground(const QString& binPath, const QString& key) {
+    if (compactionRunning.exchange(true)) {
+        return;
+    }
+
+    QThreadPool::globalInstance()->start([binPath, key]() {
+        compact(binPath, key);
+        compactionRunning = false;
+    });
+}
@@ -0,0 +1,119 @@
+#ifndef COURSEJOURNAL_H
+#define COURSEJOURNAL_H
+
+#include <QString>
+#include <QVector>
+#include "core/ChapterCodec.h"
+#include "models/Structures.h"
+
+class CourseImage;
+
+/**
+ * @brief Журнал изменений глав рядом с файлом курса (course.bin.journal).
+ * Сохранение главы дописывает в журнал одну зашифрованную запись вместо
+ * перезаписи всего курса. CourseImage при открытии накладывает записи
+ * журнала поверх базового файла: последняя запись главы побеждает.
+ * Когда журнал превышает COMPACTION_THRESHOLD, он сливается с базовым
+ * файлом в фоновом потоке.
+ *
+ * Формат: [MAGIC][version], затем записи
+ *   [chapterIndex][codecId][length][checksum][зашифрованный блок главы]
+ * checksum - CRC32C зашифрованного блока (с версии 2 журнала).
+ * Незавершенная запись в конце файла (сбой при записи) игнорируется.
+ */
+class CourseJournal
+{
+public:
+    /**
+     * @brief Запись журнала: положение блока главы в файле журнала.
+     */
+    struct Record {
+        quint32 chapterIndex;
+        quint32 codecId;
+        qint64 offset;
+        quint32 length;
+        quint32 checksum;
+        bool hasChecksum;
+    };
+
+    // Размер журнала, после которого запускается слияние с базовым файлом
+    static constexpr qint64 COMPACTION_THRESHOLD = 4 * 1024 * 1024;
+
+    /**
+     * @brief Получает путь к журналу для файла курса.
+     * @param binPath Путь к бинарному файлу курса
+     * @return Путь к файлу журнала
+     */
+    static QString journalPath(const QString& binPath);
+
+    /**
+     * @brief Дописывает в журнал новую версию одной главы.
+     * Время сохранения зависит только от размера главы.
+     * @param binPath Путь к бинарному файлу курса
+     * @param chapterIndex Индекс измененной главы
+     * @param chapter Новое содержимое главы
+     * @param key Ключ для шифрования данных
+     * @param codecId Кодек сжатия записи (ChapterCodec::Id)
+     * @return true если запись добавлена успешно, false в противном случае
+     */
+    static bool appendChapter(const QString& binPath, int chapterIndex, const Chapter& chapter,
+                              const QString& key, quint32 codecId = ChapterCodec::Zlib);
+
+    /**
+     * @brief Разбирает записи журнала, отображенного в память.
+     * @param data Указатель на содержимое журнала
+     * @param size Размер журнала в байтах
+     * @return Список корректных записей в порядке добавления
+     */
+    static QVector<Record> parseRecords(const uchar* data, qint64 size);
+
+    /**
+     * @brief Открывает базовый файл курса вместе с журналом.
+     * Выполняется под той же блокировкой, что дописывание и слияние:
+     * образ не может получить базовый файл до слияния и журнал после него.
+     * @param image Открываемый образ курса
+     * @param binPath Путь к бинарному файлу курса
+     * @param key Ключ для расшифровки данных
+     * @return true если образ открыт успешно, false в противном случае
+     */
+    static bool openImage(CourseImage& image, const QString& binPath, const QString& key);
+
+    /**
+     * @brief Проверяет, превысил ли журнал порог слияния.
+     * @param binPath Путь к бинарному файлу курса
+     * @return true если журнал нужно слить с базовым файлом
+     */
+    static bool needsCompaction(const QString& binPath);
+
+    /**
+     * @brief Сливает журнал с базовым файлом курса.
+     * Записи, добавленные во время слияния, переносятся в новый журнал.
+     * @param binPath Путь к бинарному файлу курса
+     * @param key Ключ для шифрования данных
+     * @return true если слияние прошло успешно, false в противном случае
+     */
+    static bool compact(const QString& binPath, const QString& key);
+
+    /**
+     * @brief Запускает compact() в пуле потоков, если слияние еще не идет.
+     * @param binPath Путь к бинарному файлу курса
+     * @param key Ключ для шифрования данных
+     */
+    static void compactInBackground(const QString& binPath, const QString& key);
+
+private:
+    static constexpr quint32 MAGIC = 0x434F524A; // "CORJ" in hex
+    static constexpr quint32 VERSION = 2;
+    // magic + version
+    static constexpr qint64 HEADER_SIZE = 4 + 4;
+    // chapterIndex + codecId + length
+    static constexpr qint64 RECORD_HEADER_SIZE_V1 = 4 + 4 + 4;
+    // + checksum
+    static constexpr qint64 RECORD_HEADER_SIZE = RECORD_HEADER_SIZE_V1 + 4;
+
+    static quint32 readVersion(const QString& path);
+
+    CourseJournal() = delete;
+};
+
+#endif // COURSEJOURNAL_H
@@ -0,0 +1,171 @@
+#include "core/CourseJsonReader.h"
+#include <QJsonDocument>
+#include <QDebug>
+
+CourseJsonReader::CourseJsonReader(const QString& jsonPath)
+    : m_file(jsonPath), m_pos(0), m_finished(false), m_failed(false) {
+}
+
+bool CourseJsonReader::open() {
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(QString("Cannot open JSON file: %1").arg(m_file.fileName()));
+    }
+
+    // Метка порядка байт UTF-8 пропускается, как в QJsonDocument::fromJson
+    if (ensureAvailable(3) && m_buffer.startsWith("\xEF\xBB\xBF")) {
+        m_pos += 3;
+    }
+
+    if (!skipWhitespace() || m_buffer.at(m_pos) != '[') {
+        return fail("JSON document is not an array");
+    }
+
+    ++m_pos;
+    return true;
+}
+
+bool CourseJsonReader::readNext(QJsonObject& chapterObject) {
+    while (!m_finished && !m_failed) {
+        if (!skipWhitespace()) {
+            return fail("Unexpected end of JSON document");
+        }
+
+        char c = m_buffer.at(m_pos);
+        if (c == ']') {
+            m_finished = true;
+            break;
+        }
+        if (c == ',') {
+            ++m_pos;
+            continue;
+        }
+
+        int valueLength = 0;
+        if (!scanValue(valueLength)) {
+            return false;
+        }
+
+        // Элементы, не являющиеся объектами, пропускаются как в loadCourseFromJSON
+        if (c != '{') {
+            m_pos += valueLength;
+            continue;
+        }
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(m_buffer.mid(m_pos, valueLength), &parseError);
+        m_pos += valueLength;
+
+        if (parseError.error != QJsonParseError::NoError) {
+            return fail(QString("JSON parse error: %1").arg(parseError.errorString()));
+        }
+
+        chapterObject = doc.object();
+        return true;
+    }
+
+    return false;
+}
+
+bool CourseJsonReader::hasError() const {
+    return m_failed;
+}
+
+QString CourseJsonReader::errorString() const {
+    return m_lastError;
+}
+
+bool CourseJsonReader::ensureAvailable(int count) {
+    while (m_buffer.size() - m_pos < count) {
+        if (m_file.atEnd()) {
+            return false;
+        }
+
+        // Уже разобранная часть буфера больше не нужна
+        if (m_pos > 0) {
+            m_buffer.remove(0, m_pos);
+            m_pos = 0;
+        }
+
+        QByteArray chunk = m_file.read(READ_CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            return false;
+        }
+        m_buffer.append(chunk);
+    }
+
+    return true;
+}
+
+bool CourseJsonReader::skipWhitespace() {
+    while (ensureAvailable(1)) {
+        char c = m_buffer.at(m_pos);
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            return true;
+        }
+        ++m_pos;
+    }
+    return false;
+}
+
+bool CourseJsonReader::scanValue(int& valueEnd) {
+    // Поиск конца значения, начинающегося с m_pos: учитываются вложенность
+    // скобок и строки с экранированием. Позиции считаются относительно m_pos,
+    // так как ensureAvailable() может сдвинуть буфер.
+    const char first = m_buffer.at(m_pos);
+    const bool isContainer = (first == '{' || first == '[');
+    const bool isString = (first == '"');
+
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+
+    for (int i = 0; ; ++i) {
+        if (!ensureAvailable(i + 1)) {
+            if (!isContainer && !isString) {
+                valueEnd = i;
+                return true;
+            }
+            return fail("Unexpected end of JSON document");
+        }
+
+        char c = m_buffer.at(m_pos + i);
+
+        if (inString) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                inString = false;
+                if (isString) {
+                    valueEnd = i + 1;
+                    return true;
+                }
+            }
+            continue;
+        }
+
+        if (c == '"') {
+            inString = true;
+        } else if (isContainer) {
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    valueEnd = i + 1;
+                    return true;
+                }
+            }
+        } else if (c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            valueEnd = i;
+            return true;
+        }
+    }
+}
+
+bool CourseJsonReader::fail(const QString& message) {
+    m_failed = true;
+    m_lastError = message;
+    qWarning() << message;
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef COURSEJSONREADER_H
+#define COURSEJSONREADER_H
+
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+#include <QJsonObject>
+
+/**
+ * @brief Потоковое чтение глав из JSON файла курса.
+ * Файл читается блоками фиксированного размера, из верхнего массива
+ * по одному выделяются объекты глав. В памяти одновременно находится
+ * только текущая глава и один блок чтения, а не весь документ.
+ */
+class CourseJsonReader
+{
+public:
+    /**
+     * @brief Конструктор потокового чтения.
+     * @param jsonPath Путь к JSON файлу с данными курса
+     */
+    explicit CourseJsonReader(const QString& jsonPath);
+
+    /**
+     * @brief Открывает файл и проверяет начало верхнего массива.
+     * @return true если файл открыт успешно, false в противном случае
+     */
+    bool open();
+
+    /**
+     * @brief Читает следующий объект главы.
+     * Элементы массива, не являющиеся объектами, пропускаются.
+     * @param chapterObject Объект главы для заполнения
+     * @return true если объект прочитан, false в конце массива или при ошибке
+     */
+    bool readNext(QJsonObject& chapterObject);
+
+    /**
+     * @brief Проверяет, произошла ли ошибка чтения или разбора.
+     * @return true если была ошибка, false в противном случае
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Получает текст последней ошибки.
+     * @return Строка с описанием ошибки
+     */
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CourseJsonReader)
+
+    static const qint64 READ_CHUNK_SIZE = 64 * 1024;
+
+    bool ensureAvailable(int count);
+    bool skipWhitespace();
+    bool scanValue(int& valueEnd);
+    bool fail(const QString& message);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    int m_pos;
+    bool m_finished;
+    bool m_failed;
+    QString m_lastError;
+};
+
+#endif // COURSEJSONREADER_H
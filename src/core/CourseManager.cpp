@@ -1,12 +1,49 @@
 #include "CourseManager.h"
 #include "CryptoUtils.h"
+#include "CourseImage.h"
+#include "CourseWriter.h"
+#include "CourseJsonReader.h"
+#include "CipherPipeline.h"
+#include "CourseJournal.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QDebug>
 
+Chapter CourseManager::chapterFromJson(const QJsonObject& chapterObj) {
+    Chapter chapter;
+    chapter.id = chapterObj["id"].toInt();
+    chapter.title = chapterObj["title"].toString();
+    chapter.content = chapterObj["content"].toString();
+
+    // Парсинг вопросов для текущей главы
+    QJsonArray questionsArray = chapterObj["questions"].toArray();
+    for (const QJsonValue& questionValue : questionsArray) {
+        if (!questionValue.isObject()) {
+            continue;
+        }
+
+        QJsonObject questionObj = questionValue.toObject();
+
+        Question question;
+        question.q_text = questionObj["q_text"].toString();
+        question.correct_index = questionObj["correct_index"].toInt();
+
+        // Парсинг вариантов ответов
+        QJsonArray optionsArray = questionObj["options"].toArray();
+        for (const QJsonValue& optionValue : optionsArray) {
+            question.options.append(optionValue.toString());
+        }
+
+        chapter.questions.append(question);
+    }
+
+    return chapter;
+}
+
 Course CourseManager::loadCourseFromJSON(const QString& jsonPath) {
     Course course;
 
@@ -40,71 +77,93 @@ Course CourseManager::loadCourseFromJSON(const QString& jsonPath) {
             continue;
         }
 
-        QJsonObject chapterObj = chapterValue.toObject();
+        course.chapters.append(chapterFromJson(chapterValue.toObject()));
+    }
 
-        Chapter chapter;
-        chapter.id = chapterObj["id"].toInt();
-        chapter.title = chapterObj["title"].toString();
-        chapter.content = chapterObj["content"].toString();
+    return course;
+}
 
-        // Парсинг вопросов для текущей главы
-        QJsonArray questionsArray = chapterObj["questions"].toArray();
-        for (const QJsonValue& questionValue : questionsArray) {
-            if (!questionValue.isObject()) {
-                continue;
-            }
+bool CourseManager::compileJsonToBinary(const QString& jsonPath, const QString& binPath, const QString& key,
+                                        quint32 codecId) {
+    CourseJsonReader reader(jsonPath);
+    if (!reader.open()) {
+        return false;
+    }
 
-            QJsonObject questionObj = questionValue.toObject();
+    CourseWriter writer(binPath, key, codecId);
+    if (!writer.open()) {
+        return false;
+    }
 
-            Question question;
-            question.q_text = questionObj["q_text"].toString();
-            question.correct_index = questionObj["correct_index"].toInt();
+    // Каждая глава разбирается и сразу записывается, курс целиком в памяти не собирается
+    int chapterCount = 0;
+    QJsonObject chapterObj;
+    while (reader.readNext(chapterObj)) {
+        if (!writer.writeChapter(chapterFromJson(chapterObj))) {
+            return false;
+        }
+        ++chapterCount;
+    }
 
-            // Парсинг вариантов ответов
-            QJsonArray optionsArray = questionObj["options"].toArray();
-            for (const QJsonValue& optionValue : optionsArray) {
-                question.options.append(optionValue.toString());
-            }
+    if (reader.hasError()) {
+        return false;
+    }
 
-            chapter.questions.append(question);
-        }
+    if (chapterCount == 0) {
+        qWarning() << "JSON file contains no chapters:" << jsonPath;
+        return false;
+    }
 
-        course.chapters.append(chapter);
+    if (!writer.finish()) {
+        return false;
     }
 
-    return course;
+    // Новый курс полностью заменяет старый вместе с журналом изменений
+    QFile::remove(CourseJournal::journalPath(binPath));
+    return true;
 }
 
-bool CourseManager::saveCourseToBinary(const Course& course, const QString& binPath, const QString& key) {
-    QFile file(binPath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Cannot open binary file for writing:" << binPath;
+bool CourseManager::saveCourseToBinary(const Course& course, const QString& binPath, const QString& key,
+                                       quint32 codecId) {
+    // Запись в формате v2: каждая глава - отдельный сжатый и зашифрованный блок
+    CourseWriter writer(binPath, key, codecId);
+    if (!writer.open()) {
         return false;
     }
 
-    // Сериализация курса в QByteArray
-    QByteArray courseData;
-    QDataStream courseStream(&courseData, QIODevice::WriteOnly);
-    courseStream << course;
-
-    // Шифрование сериализованных данных
-    QByteArray encryptedData = CryptoUtils::xorEncryptDecrypt(courseData, key);
+    for (const Chapter& chapter : course.chapters) {
+        if (!writer.writeChapter(chapter)) {
+            return false;
+        }
+    }
 
-    // Запись магического числа и зашифрованных данных в файл
-    QDataStream fileStream(&file);
-    fileStream << MAGIC_NUMBER;
-    fileStream << encryptedData;
+    if (!writer.finish()) {
+        return false;
+    }
 
-    file.close();
+    // Полная перезапись уже содержит все изменения из журнала
+    QFile::remove(CourseJournal::journalPath(binPath));
     return true;
 }
 
-Course CourseManager::loadCourseFromBinary(const QString& binPath, const QString& key) {
+namespace {
+
+// Ошибка загрузки: пишется в лог и возвращается вызывающей стороне
+void reportLoadError(QString* errorMessage, const QString& message) {
+    qWarning().noquote() << message;
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+}
+
+Course CourseManager::loadCourseFromBinary(const QString& binPath, const QString& key, QString* errorMessage) {
     Course course;
 
     QFile file(binPath);
     if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Cannot open binary file for reading:" << binPath;
+        reportLoadError(errorMessage, QString("Cannot open binary file for reading: %1").arg(binPath));
         return course;
     }
 
@@ -114,23 +173,92 @@ Course CourseManager::loadCourseFromBinary(const QString& binPath, const QString
     quint32 magicNumber;
     fileStream >> magicNumber;
 
-    if (magicNumber != MAGIC_NUMBER) {
-        qWarning() << "Invalid file format - magic number mismatch";
+    if (magicNumber == CourseFormat::MAGIC_V2) {
+        // Формат v2 с индексом глав - расшифровка всех глав по очереди;
+        // поврежденная глава не заменяется пустой, курс не загружается
+        file.close();
+        CourseImage image;
+        if (!image.open(binPath, key)) {
+            reportLoadError(errorMessage, QString("Cannot open course file or header is corrupted: %1").arg(binPath));
+            return course;
+        }
+        QString chapterError;
+        if (!image.toCourse(course, &chapterError)) {
+            reportLoadError(errorMessage, QString("%1: %2").arg(binPath, chapterError));
+        }
+        return course;
+    }
+
+    if (magicNumber != CourseFormat::MAGIC_V1) {
+        reportLoadError(errorMessage, QString("Invalid file format - magic number mismatch: %1").arg(binPath));
+        file.close();
+        return course;
+    }
+
+    // Длина зашифрованного блока в формате сериализации QByteArray
+    quint32 shortLength;
+    fileStream >> shortLength;
+    quint64 dataLength = shortLength;
+    if (shortLength == 0xFFFFFFFEu) {
+        fileStream >> dataLength;
+    } else if (shortLength == 0xFFFFFFFFu) {
+        dataLength = 0;
+    }
+
+    if (fileStream.status() != QDataStream::Ok
+        || dataLength > static_cast<quint64>(file.size() - file.pos())) {
+        reportLoadError(errorMessage, QString("Invalid file format - truncated course data at offset %1: %2")
+                                          .arg(file.pos()).arg(binPath));
         file.close();
         return course;
     }
 
-    // Чтение зашифрованных данных
-    QByteArray encryptedData;
-    fileStream >> encryptedData;
+    // Чтение и расшифровка зашифрованных данных конвейером: пока пул
+    // потоков расшифровывает прочитанный фрагмент, читается следующий
+    const qint64 dataOffset = file.pos();
+    QByteArray decryptedData(static_cast<qsizetype>(dataLength), Qt::Uninitialized);
+    CipherPipeline pipeline((XorKey(key)));
+    bool readOk = pipeline.readDecrypted(&file, decryptedData.data(), decryptedData.size());
     file.close();
 
-    // Расшифровка данных
-    QByteArray decryptedData = CryptoUtils::xorEncryptDecrypt(encryptedData, key);
+    if (!readOk) {
+        reportLoadError(errorMessage, QString("Failed to read course data: %1").arg(binPath));
+        return course;
+    }
 
     // Десериализация курса из расшифрованных данных
     QDataStream courseStream(&decryptedData, QIODevice::ReadOnly);
     courseStream >> course;
 
+    if (courseStream.status() != QDataStream::Ok) {
+        reportLoadError(errorMessage, QString("Failed to decode course data at offset %1, length %2: %3")
+                                          .arg(dataOffset).arg(dataLength).arg(binPath));
+        return Course();
+    }
+
     return course;
-}
\ No newline at end of file
+}
+
+bool CourseManager::verifyCourseFile(const QString& binPath, const QString& key, QStringList* errors) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Заголовок и индекс проверяются при открытии
+    CourseImage image;
+    if (!image.open(binPath, key)) {
+        if (errors) {
+            errors->append(QString("Cannot open course file or header is corrupted: %1").arg(binPath));
+        }
+        return false;
+    }
+
+    if (image.formatVersion() < 4) {
+        qDebug() << "Course format version" << image.formatVersion() << "has no checksums, nothing to verify";
+        return true;
+    }
+
+    bool valid = image.verify(errors);
+    qDebug() << "Verified" << image.chapterCount() << "chapters of" << binPath
+             << "in" << timer.elapsed() << "ms using" << CryptoUtils::crc32cKernelName() << "CRC32C";
+    return valid;
+}
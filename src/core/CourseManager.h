@@ -2,7 +2,10 @@
 #define COURSEMANAGER_H
 
 #include <QString>
+#include <QStringList>
+#include <QJsonObject>
 #include "models/Structures.h"
+#include "core/ChapterCodec.h"
 
 /**
  * @brief Класс для управления курсами.
@@ -20,24 +23,56 @@ public:
     static Course loadCourseFromJSON(const QString& jsonPath);
     
     /**
-     * @brief Сохраняет курс в зашифрованный бинарный файл.
+     * @brief Потоково преобразует JSON файл курса в зашифрованный бинарный файл.
+     * Главы читаются и записываются по одной, поэтому пиковое потребление
+     * памяти порядка одной главы. Результат побайтно совпадает с
+     * loadCourseFromJSON() + saveCourseToBinary().
+     * @param jsonPath Путь к JSON файлу с данными курса
+     * @param binPath Путь к бинарному файлу для сохранения
+     * @param key Ключ для шифрования данных
+     * @param codecId Кодек сжатия глав (ChapterCodec::Id)
+     * @return true если преобразование прошло успешно, false в противном случае
+     */
+    static bool compileJsonToBinary(const QString& jsonPath, const QString& binPath, const QString& key,
+                                    quint32 codecId = ChapterCodec::Zlib);
+    
+    /**
+     * @brief Сохраняет курс в зашифрованный бинарный файл (формат v2).
      * @param course Объект курса для сохранения
      * @param binPath Путь к бинарному файлу для сохранения
      * @param key Ключ для шифрования данных
+     * @param codecId Кодек сжатия глав (ChapterCodec::Id)
      * @return true если сохранение прошло успешно, false в противном случае
      */
-    static bool saveCourseToBinary(const Course& course, const QString& binPath, const QString& key);
+    static bool saveCourseToBinary(const Course& course, const QString& binPath, const QString& key,
+                                   quint32 codecId = ChapterCodec::Zlib);
     
     /**
      * @brief Загружает курс из зашифрованного бинарного файла.
+     * Поддерживаются форматы v1 и v2, все главы расшифровываются сразу.
+     * Для ленивой загрузки по главам используется CourseImage.
      * @param binPath Путь к бинарному файлу
      * @param key Ключ для расшифровки данных
-     * @return Объект Course с загруженными данными
+     * @param errorMessage Описание ошибки (для поврежденной главы - ее номер
+     * и смещение блока), может быть nullptr
+     * @return Объект Course с загруженными данными, пустой при любой ошибке
      */
-    static Course loadCourseFromBinary(const QString& binPath, const QString& key);
+    static Course loadCourseFromBinary(const QString& binPath, const QString& key, QString* errorMessage = nullptr);
+
+    /**
+     * @brief Проверяет целостность бинарного файла курса.
+     * Проверяются контрольные суммы заголовка и всех блоков глав (формат v4),
+     * главы при этом не расшифровываются.
+     * @param binPath Путь к бинарному файлу
+     * @param key Ключ для расшифровки данных
+     * @param errors Список найденных ошибок, может быть nullptr
+     * @return true если файл не поврежден, false в противном случае
+     */
+    static bool verifyCourseFile(const QString& binPath, const QString& key, QStringList* errors = nullptr);
 
 private:
-    static const quint32 MAGIC_NUMBER = 0x434F5253; // "CORS" in hex
+    static Chapter chapterFromJson(const QJsonObject& chapterObj);
+
     CourseManager() = delete;
 };
 
@@ -0,0 +1,96 @@
+#include "core/CourseRepository.h"
+#include "core/CourseJournal.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+CourseRepository& CourseRepository::getInstance() {
+    static CourseRepository instance;
+    return instance;
+}
+
+bool CourseRepository::load(const QString& binPath, const QString& key) {
+    QMutexLocker locker(&m_writeMutex);
+
+    // Курс уже открыт - повторная расшифровка не нужна
+    if (binPath == m_binPath && std::atomic_load(&m_snapshot)) {
+        return true;
+    }
+
+    auto image = std::make_shared<CourseImage>();
+    if (!CourseJournal::openImage(*image, binPath, key)) {
+        return false;
+    }
+
+    m_binPath = binPath;
+    m_key = key;
+    publish(std::move(image));
+    return true;
+}
+
+bool CourseRepository::loadMemory(const uchar* data, qint64 size, const QString& key) {
+    QMutexLocker locker(&m_writeMutex);
+
+    auto image = std::make_shared<CourseImage>();
+    if (!image->openMemory(data, size, key)) {
+        return false;
+    }
+
+    // Без пути к файлу курс не перечитывается и не сохраняется
+    m_binPath.clear();
+    m_key = key;
+    publish(std::move(image));
+    return true;
+}
+
+CourseRepository::Snapshot CourseRepository::snapshot() const {
+    return std::atomic_load(&m_snapshot);
+}
+
+bool CourseRepository::reload() {
+    QMutexLocker locker(&m_writeMutex);
+
+    if (m_binPath.isEmpty()) {
+        return false;
+    }
+
+    // Слияние журнала в фоне подменяет базовый файл и журнал под блокировкой
+    // журнала; открытие без нее могло взять старый файл с новым журналом
+    // и потерять все слитые изменения
+    auto image = std::make_shared<CourseImage>();
+    if (!CourseJournal::openImage(*image, m_binPath, m_key)) {
+        // Старый снимок остается действующим
+        return false;
+    }
+
+    publish(std::move(image));
+    return true;
+}
+
+bool CourseRepository::saveChapter(int chapterIndex, const Chapter& chapter) {
+    QString binPath;
+    QString key;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        binPath = m_binPath;
+        key = m_key;
+    }
+
+    if (binPath.isEmpty() || !CourseJournal::appendChapter(binPath, chapterIndex, chapter, key)) {
+        return false;
+    }
+
+    // Слияние журнала с базовым файлом не блокирует вызывающий поток
+    if (CourseJournal::needsCompaction(binPath)) {
+        CourseJournal::compactInBackground(binPath, key);
+    }
+
+    if (!reload()) {
+        qWarning() << "Chapter saved, but the course snapshot was not refreshed";
+    }
+    return true;
+}
+
+void CourseRepository::publish(Snapshot image) {
+    qDebug() << "Publishing course snapshot with" << image->chapterCount() << "chapters";
+    std::atomic_store(&m_snapshot, std::move(image));
+}
@@ -0,0 +1,84 @@
+#ifndef COURSEREPOSITORY_H
+#define COURSEREPOSITORY_H
+
+#include <QString>
+#include <QMutex>
+#include <memory>
+#include "core/CourseImage.h"
+
+/**
+ * @brief Общее для процесса хранилище открытого курса.
+ * Реализует паттерн Singleton. Курс открывается один раз, читатели
+ * получают неизменяемый снимок std::shared_ptr<const CourseImage>.
+ * Сохранение изменений публикует новый снимок атомарно (в стиле RCU):
+ * читатели продолжают работать со своей версией без блокировок и
+ * переходят на новую, когда сами запросят snapshot().
+ */
+class CourseRepository
+{
+public:
+    using Snapshot = std::shared_ptr<const CourseImage>;
+
+    /**
+     * @brief Получает единственный экземпляр класса (Singleton).
+     * @return Ссылка на экземпляр CourseRepository
+     */
+    static CourseRepository& getInstance();
+
+    /**
+     * @brief Открывает бинарный файл курса и публикует первый снимок.
+     * @param binPath Путь к бинарному файлу
+     * @param key Ключ для расшифровки данных
+     * @return true если курс открыт успешно, false в противном случае
+     */
+    bool load(const QString& binPath, const QString& key);
+
+    /**
+     * @brief Открывает образ курса в памяти и публикует первый снимок.
+     * Курс, открытый из памяти, доступен только для чтения:
+     * reload() и saveChapter() для него возвращают false.
+     * @param data Указатель на образ курса (должен жить до конца процесса)
+     * @param size Размер образа в байтах
+     * @param key Ключ для расшифровки данных
+     * @return true если курс открыт успешно, false в противном случае
+     */
+    bool loadMemory(const uchar* data, qint64 size, const QString& key);
+
+    /**
+     * @brief Получает текущий снимок курса без блокировок.
+     * @return Снимок курса или nullptr, если курс не загружен
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Повторно открывает файл курса с журналом и публикует новый снимок.
+     * @return true если новый снимок опубликован, false в противном случае
+     */
+    bool reload();
+
+    /**
+     * @brief Сохраняет главу в журнал курса и публикует новый снимок.
+     * @param chapterIndex Индекс измененной главы
+     * @param chapter Новое содержимое главы
+     * @return true если глава сохранена успешно, false в противном случае
+     */
+    bool saveChapter(int chapterIndex, const Chapter& chapter);
+
+    // Prevent copying
+    CourseRepository(const CourseRepository&) = delete;
+    CourseRepository& operator=(const CourseRepository&) = delete;
+
+private:
+    CourseRepository() = default;
+
+    void publish(Snapshot image);
+
+    // Писатели (load/reload/saveChapter) выполняются по очереди
+    QMutex m_writeMutex;
+    QString m_binPath;
+    QString m_key;
+    // Доступ только через std::atomic_load/std::atomic_store
+    Snapshot m_snapshot;
+};
+
+#endif // COURSEREPOSITORY_H
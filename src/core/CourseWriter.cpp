@@ -0,0 +1,143 @@
+#include "core/CourseWriter.h"
+#include <QDataStream>
+#include <QDebug>
+
+CourseWriter::CourseWriter(const QString& binPath, const QString& key, quint32 codecId)
+    : m_file(binPath)
+    , m_codec(ChapterCodec::byId(codecId))
+    , m_pendingBytes(0)
+    , m_pipeline(XorKey(key))
+    , m_failed(false) {
+}
+
+bool CourseWriter::open() {
+    if (!m_codec) {
+        return fail("Unknown chapter compression codec");
+    }
+
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        return fail(QString("Cannot open binary file for writing: %1").arg(m_file.fileName()));
+    }
+
+    // Место под заголовок, он будет записан после таблицы смещений
+    QByteArray placeholder(CourseFormat::HEADER_SIZE, '\0');
+    if (m_file.write(placeholder) != placeholder.size()) {
+        return fail(QString("Failed to write header: %1").arg(m_file.errorString()));
+    }
+
+    return true;
+}
+
+bool CourseWriter::writeChapter(const Chapter& chapter) {
+    if (m_failed || !m_file.isOpen()) {
+        return false;
+    }
+
+    PendingBlock block;
+    {
+        QDataStream chapterStream(&block.data, QIODevice::WriteOnly);
+        chapterStream << chapter;
+    }
+    block.chapterId = chapter.id;
+    block.rawSize = block.data.size();
+    block.checksum = 0;
+    m_pendingBlocks.push_back(std::move(block));
+
+    // Каждый блок сжимается и шифруется независимо, с начала ключа, в пуле потоков;
+    // контрольная сумма считается по зашифрованному блоку
+    PendingBlock* queued = &m_pendingBlocks.back();
+    const ChapterCodec* codec = m_codec;
+    const XorKey* key = &m_pipeline.key();
+    m_pendingBytes += queued->rawSize;
+    queued->ticket = m_pipeline.run([queued, codec, key]() {
+        queued->data = codec->compress(queued->data);
+        CryptoUtils::xorInPlace(queued->data.data(), queued->data.size(), *key);
+        queued->checksum = CryptoUtils::crc32c(queued->data.constData(), queued->data.size());
+    });
+
+    return writePending(MAX_PENDING_BYTES);
+}
+
+bool CourseWriter::writePending(qsizetype keepBytes) {
+    // Блоки записываются строго по порядку глав, по мере готовности
+    while (!m_pendingBlocks.empty() && (m_pendingBytes > keepBytes || keepBytes == 0)) {
+        PendingBlock& block = m_pendingBlocks.front();
+        m_pipeline.waitFor(block.ticket);
+
+        quint64 offset = static_cast<quint64>(m_file.pos());
+        if (m_file.write(block.data) != block.data.size()) {
+            return fail(QString("Failed to write chapter %1: %2").arg(block.chapterId).arg(m_file.errorString()));
+        }
+
+        m_index.append(CourseFormat::IndexEntry(offset, static_cast<quint32>(block.data.size()), block.checksum));
+        m_pendingBytes -= block.rawSize;
+        m_pendingBlocks.pop_front();
+    }
+
+    return true;
+}
+
+bool CourseWriter::finish() {
+    if (m_failed || !m_file.isOpen()) {
+        return false;
+    }
+
+    if (!writePending(0)) {
+        return false;
+    }
+
+    quint64 indexOffset = static_cast<quint64>(m_file.pos());
+
+    QByteArray indexData;
+    {
+        QDataStream indexStream(&indexData, QIODevice::WriteOnly);
+        for (const CourseFormat::IndexEntry& entry : m_index) {
+            indexStream << entry.offset << entry.length << entry.checksum;
+        }
+    }
+
+    // Заголовок записывается последним: число глав и смещение индекса уже известны
+    QByteArray headerData;
+    {
+        QDataStream headerStream(&headerData, QIODevice::WriteOnly);
+        headerStream << CourseFormat::MAGIC_V2;
+        headerStream << CourseFormat::VERSION;
+        headerStream << static_cast<quint32>(m_index.size());
+        headerStream << indexOffset;
+        headerStream << m_codec->id;
+    }
+
+    // Контрольная сумма заголовка охватывает и таблицу смещений
+    quint32 headerChecksum = CryptoUtils::crc32c(headerData.constData(), headerData.size());
+    headerChecksum = CryptoUtils::crc32c(indexData.constData(), indexData.size(), headerChecksum);
+
+    QDataStream fileStream(&m_file);
+    fileStream.writeRawData(indexData.constData(), static_cast<int>(indexData.size()));
+    m_file.seek(0);
+    fileStream.writeRawData(headerData.constData(), static_cast<int>(headerData.size()));
+    fileStream << headerChecksum;
+
+    if (fileStream.status() != QDataStream::Ok) {
+        return fail(QString("Failed to write index: %1").arg(m_file.errorString()));
+    }
+
+    if (!m_file.commit()) {
+        return fail(QString("Failed to commit binary file: %1").arg(m_file.errorString()));
+    }
+
+    return true;
+}
+
+QString CourseWriter::errorString() const {
+    return m_lastError;
+}
+
+bool CourseWriter::fail(const QString& message) {
+    m_failed = true;
+    m_lastError = message;
+    qWarning() << message;
+    if (m_file.isOpen()) {
+        m_file.cancelWriting();
+    }
+    return false;
+}
@@ -0,0 +1,91 @@
+#ifndef COURSEWRITER_H
+#define COURSEWRITER_H
+
+#include <QString>
+#include <QSaveFile>
+#include <QVector>
+#include <deque>
+#include "core/CourseFormat.h"
+#include "core/CryptoUtils.h"
+#include "core/CipherPipeline.h"
+#include "core/ChapterCodec.h"
+#include "models/Structures.h"
+
+/**
+ * @brief Последовательная запись курса в бинарный формат v2.
+ * Главы записываются по одной отдельными зашифрованными блоками,
+ * таблица смещений и заголовок дописываются в finish().
+ * Блоки сжимаются выбранным кодеком и шифруются в пуле потоков
+ * CipherPipeline, пока вызывающий поток сериализует следующие главы
+ * и пишет уже готовые блоки.
+ * Файл заменяется атомарно (QSaveFile), поэтому уже открытые
+ * отображения старого файла остаются корректными.
+ */
+class CourseWriter
+{
+public:
+    /**
+     * @brief Конструктор записи курса.
+     * @param binPath Путь к бинарному файлу для сохранения
+     * @param key Ключ для шифрования блоков глав
+     * @param codecId Кодек сжатия блоков глав (ChapterCodec::Id)
+     */
+    CourseWriter(const QString& binPath, const QString& key, quint32 codecId = ChapterCodec::Zlib);
+
+    /**
+     * @brief Открывает временный файл и резервирует место под заголовок.
+     * @return true если файл открыт успешно, false в противном случае
+     */
+    bool open();
+
+    /**
+     * @brief Сериализует, шифрует и записывает одну главу.
+     * @param chapter Глава для записи
+     * @return true если запись прошла успешно, false в противном случае
+     */
+    bool writeChapter(const Chapter& chapter);
+
+    /**
+     * @brief Записывает таблицу смещений и заголовок, фиксирует файл.
+     * @return true если файл сохранен успешно, false в противном случае
+     */
+    bool finish();
+
+    /**
+     * @brief Получает текст последней ошибки.
+     * @return Строка с описанием ошибки
+     */
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CourseWriter)
+
+    /**
+     * @brief Блок главы, поставленный в очередь на шифрование.
+     */
+    struct PendingBlock {
+        QByteArray data;
+        qsizetype rawSize;
+        quint32 checksum;
+        qint64 ticket;
+        int chapterId;
+    };
+
+    // Объем зашифровываемых блоков, после которого запись ждет пул
+    static constexpr qsizetype MAX_PENDING_BYTES = 16 * CipherPipeline::CHUNK_SIZE;
+
+    bool writePending(qsizetype keepBytes);
+    bool fail(const QString& message);
+
+    QSaveFile m_file;
+    const ChapterCodec* m_codec;
+    QVector<CourseFormat::IndexEntry> m_index;
+    std::deque<PendingBlock> m_pendingBlocks;
+    qsizetype m_pendingBytes;
+    // Объявлен после очереди: при уничтожении сначала дожидается задач
+    CipherPipeline m_pipeline;
+    QString m_lastError;
+    bool m_failed;
+};
+
+#endif // COURSEWRITER_H
@@ -1,24 +1,526 @@
 #include "CryptoUtils.h"
 #include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CRYPTOUTILS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Префикс самоописывающего хеша пароля
+const QLatin1String PBKDF2_PREFIX("$pbkdf2-sha256$");
+
+/**
+ * @brief Разбирает хеш $pbkdf2-sha256$итерации$соль$ключ.
+ */
+bool parsePbkdf2Hash(const QString& hash, int* iterations, QByteArray* salt, QByteArray* key) {
+    if (!hash.startsWith(PBKDF2_PREFIX)) {
+        return false;
+    }
+
+    const QStringList parts = hash.mid(PBKDF2_PREFIX.size()).split('$');
+    if (parts.size() != 3) {
+        return false;
+    }
+
+    bool ok = false;
+    *iterations = parts.at(0).toInt(&ok);
+    if (!ok || *iterations <= 0) {
+        return false;
+    }
+
+    if (salt) {
+        *salt = QByteArray::fromBase64(parts.at(1).toLatin1());
+    }
+    if (key) {
+        *key = QByteArray::fromBase64(parts.at(2).toLatin1());
+        if (key->isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Сравнивает хеши за время, не зависящее от позиции первого различия.
+ */
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    char difference = 0;
+    for (qsizetype i = 0; i < a.size(); ++i) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
+
+// Ядро XOR: keyBlock - повторенный ключ, phase - текущая позиция в ключе (< keySize)
+using XorKernel = void (*)(char* data, qsizetype size, const char* keyBlock, int keySize, int phase);
+
+void xorKernelScalar(char* data, qsizetype size, const char* keyBlock, int keySize, int phase) {
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] ^= keyBlock[phase];
+        if (++phase == keySize) {
+            phase = 0;
+        }
+    }
+}
+
+#ifdef CRYPTOUTILS_X86_KERNELS
+
+// Вектор ключа читается из блока с текущей фазы; после каждого вектора
+// фаза сдвигается на (ширина % keySize), что не требует деления в цикле
+__attribute__((target("sse2")))
+void xorKernelSse2(char* data, qsizetype size, const char* keyBlock, int keySize, int phase) {
+    const int step = 16 % keySize;
+    qsizetype i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i keyVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keyBlock + phase));
+        __m128i dataVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(dataVector, keyVector));
+
+        phase += step;
+        if (phase >= keySize) {
+            phase -= keySize;
+        }
+    }
+
+    xorKernelScalar(data + i, size - i, keyBlock, keySize, phase);
+}
+
+__attribute__((target("avx2")))
+void xorKernelAvx2(char* data, qsizetype size, const char* keyBlock, int keySize, int phase) {
+    const int step = 32 % keySize;
+    qsizetype i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i keyVector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keyBlock + phase));
+        __m256i dataVector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_xor_si256(dataVector, keyVector));
+
+        phase += step;
+        if (phase >= keySize) {
+            phase -= keySize;
+        }
+    }
+
+    xorKernelSse2(data + i, size - i, keyBlock, keySize, phase);
+}
+
+#endif // CRYPTOUTILS_X86_KERNELS
+
+struct XorDispatch {
+    XorKernel kernel;
+    const char* name;
+};
+
+XorDispatch selectXorKernel() {
+#ifdef CRYPTOUTILS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return XorDispatch{xorKernelAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return XorDispatch{xorKernelSse2, "sse2"};
+    }
+#endif
+    return XorDispatch{xorKernelScalar, "scalar"};
+}
+
+const XorDispatch& xorDispatch() {
+    static const XorDispatch dispatch = selectXorKernel();
+    return dispatch;
+}
+
+// Ядро CRC32C (Castagnoli): crc - промежуточное значение без финальной инверсии
+using Crc32cKernel = quint32 (*)(quint32 crc, const uchar* data, qsizetype size);
+
+// Таблицы slicing-by-8 для полинома 0x82F63B78 (отраженная форма)
+struct Crc32cTables {
+    quint32 table[8][256];
+
+    Crc32cTables() {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            }
+            table[0][i] = crc;
+        }
+        for (int slice = 1; slice < 8; ++slice) {
+            for (quint32 i = 0; i < 256; ++i) {
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const Crc32cTables& crc32cTables() {
+    static const Crc32cTables tables;
+    return tables;
+}
+
+quint32 crc32cKernelTable(quint32 crc, const uchar* data, qsizetype size) {
+    const Crc32cTables& t = crc32cTables();
+    qsizetype i = 0;
+
+    // По 8 байт за шаг: порядок байт little-endian собирается вручную
+    for (; i + 8 <= size; i += 8) {
+        quint32 low = crc ^ (quint32(data[i]) | quint32(data[i + 1]) << 8
+                             | quint32(data[i + 2]) << 16 | quint32(data[i + 3]) << 24);
+        crc = t.table[7][low & 0xFF] ^ t.table[6][(low >> 8) & 0xFF]
+            ^ t.table[5][(low >> 16) & 0xFF] ^ t.table[4][low >> 24]
+            ^ t.table[3][data[i + 4]] ^ t.table[2][data[i + 5]]
+            ^ t.table[1][data[i + 6]] ^ t.table[0][data[i + 7]];
+    }
+
+    for (; i < size; ++i) {
+        crc = (crc >> 8) ^ t.table[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef CRYPTOUTILS_X86_KERNELS
+
+__attribute__((target("sse4.2")))
+quint32 crc32cKernelSse42(quint32 crc, const uchar* data, qsizetype size) {
+    qsizetype i = 0;
+
+#if defined(__x86_64__)
+    quint64 crc64 = crc;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<quint32>(crc64);
+#endif
+
+    for (; i + 4 <= size; i += 4) {
+        quint32 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+
+    for (; i < size; ++i) {
+        crc = _mm_crc32_u8(crc, data[i]);
+    }
+    return crc;
+}
+
+#endif // CRYPTOUTILS_X86_KERNELS
+
+struct Crc32cDispatch {
+    Crc32cKernel kernel;
+    const char* name;
+};
+
+Crc32cDispatch selectCrc32cKernel() {
+#ifdef CRYPTOUTILS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Crc32cDispatch{crc32cKernelSse42, "sse4.2"};
+    }
+#endif
+    return Crc32cDispatch{crc32cKernelTable, "table"};
+}
+
+const Crc32cDispatch& crc32cDispatch() {
+    static const Crc32cDispatch dispatch = selectCrc32cKernel();
+    return dispatch;
+}
+
+// SHA-256 (FIPS 180-4) для PBKDF2. QCryptographicHash не копирует состояние,
+// поэтому HMAC на нем заново хеширует ipad/opad и выделяет память на каждой
+// итерации; здесь состояния после блоков ipad и opad считаются один раз
+const quint32 SHA256_INITIAL[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+const quint32 SHA256_ROUND[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline quint32 rotateRight(quint32 value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+void sha256Compress(quint32 state[8], const uchar* block) {
+    quint32 w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = quint32(block[4 * i]) << 24 | quint32(block[4 * i + 1]) << 16
+             | quint32(block[4 * i + 2]) << 8 | quint32(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        const quint32 s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const quint32 s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    quint32 a = state[0], b = state[1], c = state[2], d = state[3];
+    quint32 e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const quint32 t1 = h + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25))
+                         + ((e & f) ^ (~e & g)) + SHA256_ROUND[i] + w[i];
+        const quint32 t2 = (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22))
+                         + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+/**
+ * @brief Досчитывает SHA-256 от промежуточного состояния.
+ * @param initial Состояние после prefixLength байт (кратно 64)
+ * @param digest Результат, 32 байта
+ */
+void sha256Finish(const quint32 initial[8], quint64 prefixLength, const uchar* data, qsizetype size, uchar* digest) {
+    quint32 state[8];
+    std::memcpy(state, initial, sizeof(state));
+    const quint64 bitLength = (prefixLength + quint64(size)) * 8;
+
+    for (; size >= 64; data += 64, size -= 64) {
+        sha256Compress(state, data);
+    }
+
+    // Дополнение: 0x80, нули и длина сообщения в битах (big-endian)
+    uchar tail[128] = {};
+    std::memcpy(tail, data, size_t(size));
+    tail[size] = 0x80;
+    const int tailSize = size + 9 <= 64 ? 64 : 128;
+    for (int i = 0; i < 8; ++i) {
+        tail[tailSize - 1 - i] = uchar(bitLength >> (8 * i));
+    }
+    sha256Compress(state, tail);
+    if (tailSize == 128) {
+        sha256Compress(state, tail + 64);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = uchar(state[i] >> 24);
+        digest[4 * i + 1] = uchar(state[i] >> 16);
+        digest[4 * i + 2] = uchar(state[i] >> 8);
+        digest[4 * i + 3] = uchar(state[i]);
+    }
+}
+
+} // namespace
+
+XorKey::XorKey()
+    : m_keySize(0) {
+}
+
+XorKey::XorKey(const QString& key)
+    : m_keySize(0) {
+    QByteArray keyBytes = key.toUtf8();
+    m_keySize = static_cast<int>(keyBytes.size());
+    if (m_keySize == 0) {
+        return;
+    }
+
+    // Ключ повторяется, пока блок не покроет фазу + один вектор
+    const int blockSize = m_keySize + BLOCK_PADDING;
+    m_block.reserve(blockSize + m_keySize);
+    while (m_block.size() < blockSize) {
+        m_block.append(keyBytes);
+    }
+}
+
+bool XorKey::isEmpty() const {
+    return m_keySize == 0;
+}
+
+int XorKey::size() const {
+    return m_keySize;
+}
+
+const char* XorKey::block() const {
+    return m_block.constData();
+}
 
 QByteArray CryptoUtils::xorEncryptDecrypt(const QByteArray& data, const QString& key) {
     if (data.isEmpty() || key.isEmpty()) {
         return data;
     }
 
-    QByteArray keyBytes = key.toUtf8();
     QByteArray result = data;
+    xorInPlace(result.data(), result.size(), XorKey(key));
+    return result;
+}
 
-    // Применение XOR шифрования с циклическим использованием ключа
-    for (int i = 0; i < result.size(); ++i) {
-        result[i] = result[i] ^ keyBytes[i % keyBytes.size()];
+void CryptoUtils::xorInPlace(char* data, qsizetype size, const XorKey& key, qint64 keyOffset) {
+    if (size <= 0 || key.isEmpty()) {
+        return;
     }
 
-    return result;
+    int phase = static_cast<int>(keyOffset % key.size());
+    xorDispatch().kernel(data, size, key.block(), key.size(), phase);
+}
+
+void CryptoUtils::xorInPlaceScalar(char* data, qsizetype size, const XorKey& key, qint64 keyOffset) {
+    if (size <= 0 || key.isEmpty()) {
+        return;
+    }
+
+    int phase = static_cast<int>(keyOffset % key.size());
+    xorKernelScalar(data, size, key.block(), key.size(), phase);
+}
+
+const char* CryptoUtils::xorKernelName() {
+    return xorDispatch().name;
+}
+
+quint32 CryptoUtils::crc32c(const void* data, qsizetype size, quint32 crc) {
+    if (size <= 0) {
+        return crc;
+    }
+    return ~crc32cDispatch().kernel(~crc, static_cast<const uchar*>(data), size);
+}
+
+quint32 CryptoUtils::crc32cTable(const void* data, qsizetype size, quint32 crc) {
+    if (size <= 0) {
+        return crc;
+    }
+    return ~crc32cKernelTable(~crc, static_cast<const uchar*>(data), size);
 }
 
-QString CryptoUtils::hashPassword(const QString& password) {
-    QByteArray passwordBytes = password.toUtf8();
-    QByteArray hash = QCryptographicHash::hash(passwordBytes, QCryptographicHash::Sha256);
-    return hash.toHex();
-}
\ No newline at end of file
+const char* CryptoUtils::crc32cKernelName() {
+    return crc32cDispatch().name;
+}
+
+QString CryptoUtils::hashPassword(const QString& password, int iterations) {
+    if (iterations <= 0) {
+        iterations = passwordIterations();
+    }
+
+    QByteArray salt(PBKDF2_SALT_SIZE, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(salt.data()), PBKDF2_SALT_SIZE / 4);
+
+    const QByteArray key = pbkdf2Sha256(password.toUtf8(), salt, iterations, PBKDF2_KEY_SIZE);
+    return QString(PBKDF2_PREFIX) + QString::number(iterations) + '$' + QString::fromLatin1(salt.toBase64())
+        + '$' + QString::fromLatin1(key.toBase64());
+}
+
+bool CryptoUtils::verifyPassword(const QString& password, const QString& storedHash) {
+    if (storedHash.startsWith(PBKDF2_PREFIX)) {
+        int iterations = 0;
+        QByteArray salt;
+        QByteArray expected;
+        if (!parsePbkdf2Hash(storedHash, &iterations, &salt, &expected)) {
+            return false;
+        }
+        return constantTimeEquals(pbkdf2Sha256(password.toUtf8(), salt, iterations, expected.size()), expected);
+    }
+
+    // Прежний формат: несоленый SHA-256 в hex, до перехода на PBKDF2
+    if (storedHash.size() == 64) {
+        const QByteArray actual = QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256).toHex();
+        return constantTimeEquals(actual, storedHash.toLatin1().toLower());
+    }
+    return false;
+}
+
+bool CryptoUtils::needsRehash(const QString& storedHash, int iterations) {
+    if (iterations <= 0) {
+        iterations = passwordIterations();
+    }
+
+    int storedIterations = 0;
+    if (!parsePbkdf2Hash(storedHash, &storedIterations, nullptr, nullptr)) {
+        return true;
+    }
+    return storedIterations < iterations;
+}
+
+int CryptoUtils::passwordIterations() {
+    static const int iterations = [] {
+        const int configured = qEnvironmentVariableIntValue("COURSE_PBKDF2_ITERATIONS");
+        return configured > 0 ? configured : DEFAULT_PBKDF2_ITERATIONS;
+    }();
+    return iterations;
+}
+
+QByteArray CryptoUtils::pbkdf2Sha256(const QByteArray& password, const QByteArray& salt, int iterations, int keyLength) {
+    constexpr int blockSize = 64;
+    constexpr int digestSize = 32;
+
+    // Ключ HMAC длиннее блока заменяется его хешем; состояния SHA-256 после
+    // блоков ipad и opad считаются один раз, итерация - два сжатия без выделений
+    QByteArray key = password.size() > blockSize
+        ? QCryptographicHash::hash(password, QCryptographicHash::Sha256) : password;
+    key.append(QByteArray(blockSize - key.size(), '\0'));
+    uchar innerPad[blockSize];
+    uchar outerPad[blockSize];
+    for (int i = 0; i < blockSize; ++i) {
+        innerPad[i] = static_cast<uchar>(key[i] ^ 0x36);
+        outerPad[i] = static_cast<uchar>(key[i] ^ 0x5c);
+    }
+    quint32 innerState[8];
+    quint32 outerState[8];
+    std::memcpy(innerState, SHA256_INITIAL, sizeof(innerState));
+    std::memcpy(outerState, SHA256_INITIAL, sizeof(outerState));
+    sha256Compress(innerState, innerPad);
+    sha256Compress(outerState, outerPad);
+
+    auto hmac = [&](const uchar* message, qsizetype size, uchar* mac) {
+        uchar innerDigest[digestSize];
+        sha256Finish(innerState, blockSize, message, size, innerDigest);
+        sha256Finish(outerState, blockSize, innerDigest, digestSize, mac);
+    };
+
+    QByteArray derived;
+    derived.reserve(keyLength + digestSize);
+    QByteArray message = salt;
+    message.append(4, '\0');
+    for (quint32 blockIndex = 1; derived.size() < keyLength; ++blockIndex) {
+        // U1 = HMAC(P, S || INT(i)), Ui = HMAC(P, Ui-1), T = U1 ^ ... ^ Uc
+        uchar* index = reinterpret_cast<uchar*>(message.data()) + salt.size();
+        index[0] = uchar(blockIndex >> 24);
+        index[1] = uchar(blockIndex >> 16);
+        index[2] = uchar(blockIndex >> 8);
+        index[3] = uchar(blockIndex);
+
+        uchar u[digestSize];
+        uchar block[digestSize];
+        hmac(reinterpret_cast<const uchar*>(message.constData()), message.size(), u);
+        std::memcpy(block, u, digestSize);
+        for (int iteration = 1; iteration < iterations; ++iteration) {
+            hmac(u, digestSize, u);
+            for (int i = 0; i < digestSize; ++i) {
+                block[i] ^= u[i];
+            }
+        }
+        derived.append(reinterpret_cast<const char*>(block), digestSize);
+    }
+
+    derived.truncate(keyLength);
+    return derived;
+}
@@ -4,6 +4,49 @@
 #include <QByteArray>
 #include <QString>
 
+/**
+ * @brief Подготовленный ключ XOR шифрования.
+ * Ключ один раз переводится в UTF-8 и повторяется в блок, из которого
+ * векторные ядра читают ключевой поток с любой фазы без деления по модулю.
+ */
+class XorKey
+{
+public:
+    XorKey();
+
+    /**
+     * @brief Конструктор подготовленного ключа.
+     * @param key Ключ для шифрования
+     */
+    explicit XorKey(const QString& key);
+
+    /**
+     * @brief Проверяет, пуст ли ключ.
+     * @return true если ключ пуст, false в противном случае
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Получает длину ключа в байтах.
+     * @return Длина ключа в UTF-8
+     */
+    int size() const;
+
+    /**
+     * @brief Получает повторенный блок ключа.
+     * Длина блока не меньше size() + BLOCK_PADDING байт.
+     * @return Указатель на начало блока
+     */
+    const char* block() const;
+
+    // Запас блока для чтения одного вектора с любой фазы ключа
+    static const int BLOCK_PADDING = 64;
+
+private:
+    QByteArray m_block;
+    int m_keySize;
+};
+
 /**
  * @brief Класс для криптографических операций.
  * Предоставляет статические методы для шифрования/дешифрования данных
@@ -19,16 +62,113 @@ public:
      * @return Зашифрованные/расшифрованные данные
      */
     static QByteArray xorEncryptDecrypt(const QByteArray& data, const QString& key);
-    
+
+    /**
+     * @brief Шифрует или дешифрует буфер на месте, без копирования.
+     * Ядро (AVX2, SSE2 или скалярное) выбирается по возможностям процессора
+     * при первом вызове, результат всех ядер побайтно совпадает.
+     * @param data Указатель на буфер
+     * @param size Размер буфера в байтах
+     * @param key Подготовленный ключ
+     * @param keyOffset Позиция буфера в потоке данных (фаза ключа)
+     */
+    static void xorInPlace(char* data, qsizetype size, const XorKey& key, qint64 keyOffset = 0);
+
+    /**
+     * @brief Скалярный вариант xorInPlace(), эталон для проверки векторных ядер.
+     * @param data Указатель на буфер
+     * @param size Размер буфера в байтах
+     * @param key Подготовленный ключ
+     * @param keyOffset Позиция буфера в потоке данных (фаза ключа)
+     */
+    static void xorInPlaceScalar(char* data, qsizetype size, const XorKey& key, qint64 keyOffset = 0);
+
+    /**
+     * @brief Получает название ядра XOR, выбранного для текущего процессора.
+     * @return "avx2", "sse2" или "scalar"
+     */
+    static const char* xorKernelName();
+
+    /**
+     * @brief Вычисляет контрольную сумму CRC32C (Castagnoli).
+     * Используется инструкция SSE4.2 crc32, если процессор ее поддерживает,
+     * иначе табличный алгоритм. Сумму можно продолжить по частям,
+     * передав результат предыдущего вызова в crc.
+     * @param data Указатель на данные
+     * @param size Размер данных в байтах
+     * @param crc Контрольная сумма предыдущей части данных
+     * @return Контрольная сумма CRC32C
+     */
+    static quint32 crc32c(const void* data, qsizetype size, quint32 crc = 0);
+
+    /**
+     * @brief Табличный вариант crc32c(), эталон для проверки аппаратного ядра.
+     * @param data Указатель на данные
+     * @param size Размер данных в байтах
+     * @param crc Контрольная сумма предыдущей части данных
+     * @return Контрольная сумма CRC32C
+     */
+    static quint32 crc32cTable(const void* data, qsizetype size, quint32 crc = 0);
+
     /**
-     * @brief Хеширует пароль для безопасного хранения.
+     * @brief Получает название ядра CRC32C, выбранного для текущего процессора.
+     * @return "sse4.2" или "table"
+     */
+    static const char* crc32cKernelName();
+
+    // Число итераций PBKDF2 по умолчанию; переопределяется COURSE_PBKDF2_ITERATIONS
+    static constexpr int DEFAULT_PBKDF2_ITERATIONS = 100000;
+    // Длина соли и ключа PBKDF2 в байтах
+    static constexpr int PBKDF2_SALT_SIZE = 16;
+    static constexpr int PBKDF2_KEY_SIZE = 32;
+
+    /**
+     * @brief Хеширует пароль для безопасного хранения (PBKDF2-HMAC-SHA256
+     * со случайной солью).
+     * Хеш описывает сам себя: $pbkdf2-sha256$итерации$соль$ключ
+     * (соль и ключ в Base64), поэтому стоимость можно повысить позже,
+     * не трогая уже сохраненные хеши.
      * @param password Пароль для хеширования
+     * @param iterations Число итераций; 0 - passwordIterations()
      * @return Хешированный пароль в виде строки
      */
-    static QString hashPassword(const QString& password);
+    static QString hashPassword(const QString& password, int iterations = 0);
+
+    /**
+     * @brief Проверяет пароль по сохраненному хешу.
+     * Поддерживает формат PBKDF2 и прежний несоленый SHA-256 (64 hex символа).
+     * @param password Введенный пароль
+     * @param storedHash Хеш из базы данных
+     * @return true если пароль верный
+     */
+    static bool verifyPassword(const QString& password, const QString& storedHash);
+
+    /**
+     * @brief Проверяет, нужно ли пересчитать хеш с текущей стоимостью.
+     * @param storedHash Хеш из базы данных
+     * @param iterations Требуемое число итераций; 0 - passwordIterations()
+     * @return true для прежнего SHA-256 и PBKDF2 с меньшим числом итераций
+     */
+    static bool needsRehash(const QString& storedHash, int iterations = 0);
+
+    /**
+     * @brief Получает текущее число итераций PBKDF2.
+     * @return COURSE_PBKDF2_ITERATIONS или DEFAULT_PBKDF2_ITERATIONS
+     */
+    static int passwordIterations();
+
+    /**
+     * @brief Вычисляет PBKDF2-HMAC-SHA256 (RFC 8018).
+     * @param password Пароль
+     * @param salt Соль
+     * @param iterations Число итераций
+     * @param keyLength Длина ключа в байтах
+     * @return Производный ключ
+     */
+    static QByteArray pbkdf2Sha256(const QByteArray& password, const QByteArray& salt, int iterations, int keyLength);
 
 private:
     CryptoUtils() = delete;
 };
 
-#endif // CRYPTOUTILS_H
\ No newline at end of file
+#endif // CRYPTOUTILS_H
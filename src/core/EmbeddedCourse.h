@@ -0,0 +1,33 @@
+#ifndef EMBEDDEDCOURSE_H
+#define EMBEDDEDCOURSE_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Образ курса, встроенный в исполняемый файл при сборке.
+ * Реализация генерируется утилитой tools/coursegen из
+ * data/course_source.json и компилируется только в сборке с
+ * CONFIG+=embed_course (определен макрос EMBEDDED_COURSE).
+ * Образ хранится в формате course.bin и открывается через
+ * CourseImage::openMemory() без копирования.
+ */
+class EmbeddedCourse
+{
+public:
+    /**
+     * @brief Получает указатель на встроенный образ курса.
+     * @return Указатель на начало образа
+     */
+    static const uchar* data();
+
+    /**
+     * @brief Получает размер встроенного образа курса.
+     * @return Размер в байтах
+     */
+    static qint64 size();
+
+private:
+    EmbeddedCourse() = delete;
+};
+
+#endif // EMBEDDEDCOURSE_H
@@ -0,0 +1,69 @@
+#include "core/PasswordHasher.h"
+#include "core/CryptoUtils.h"
+#include <QThread>
+#include <QDebug>
+
+PasswordHasher::PasswordHasher()
+    : m_pending(0), m_maxPending(DEFAULT_MAX_PENDING) {
+    // Одно ядро остается потоку интерфейса и рабочему потоку базы данных
+    int threads = qEnvironmentVariableIntValue("COURSE_HASH_THREADS");
+    if (threads <= 0) {
+        threads = qMax(1, QThread::idealThreadCount() - 1);
+    }
+    m_pool.setMaxThreadCount(threads);
+    m_pool.setObjectName("PasswordHasher");
+
+    const int maxPending = qEnvironmentVariableIntValue("COURSE_HASH_QUEUE");
+    if (maxPending > 0) {
+        m_maxPending = maxPending;
+    }
+
+    qDebug() << "Password hasher:" << threads << "threads," << CryptoUtils::passwordIterations()
+             << "PBKDF2 iterations, queue limit" << m_maxPending.load();
+}
+
+PasswordHasher::~PasswordHasher() {
+    m_pool.waitForDone();
+}
+
+PasswordHasher& PasswordHasher::getInstance() {
+    static PasswordHasher instance;
+    return instance;
+}
+
+QFuture<QString> PasswordHasher::hash(const QString& password, int iterations) {
+    return submit(QString(), [password, iterations]() {
+        return CryptoUtils::hashPassword(password, iterations);
+    });
+}
+
+QFuture<PasswordHasher::Verification> PasswordHasher::verify(const QString& password, const QString& storedHash,
+                                                             int iterations) {
+    return submit(Verification(), [password, storedHash, iterations]() {
+        Verification verification;
+        verification.accepted = true;
+        verification.valid = CryptoUtils::verifyPassword(password, storedHash);
+
+        // Хеш пересчитывается, пока открытый пароль известен: другого случая не будет
+        if (verification.valid && CryptoUtils::needsRehash(storedHash, iterations)) {
+            verification.upgradedHash = CryptoUtils::hashPassword(password, iterations);
+        }
+        return verification;
+    });
+}
+
+int PasswordHasher::pendingCount() const {
+    return m_pending;
+}
+
+int PasswordHasher::maxPending() const {
+    return m_maxPending;
+}
+
+void PasswordHasher::setMaxPending(int maxPending) {
+    m_maxPending = qMax(1, maxPending);
+}
+
+void PasswordHasher::setMaxThreads(int threads) {
+    m_pool.setMaxThreadCount(qMax(1, threads));
+}
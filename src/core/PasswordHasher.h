@@ -0,0 +1,127 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QString>
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Сервис хеширования паролей на ограниченном пуле потоков.
+ * Реализует паттерн Singleton. PBKDF2 намеренно медленный, поэтому
+ * хеширование не выполняется ни в потоке интерфейса, ни в рабочем потоке
+ * DatabaseManager: задачи выполняются в собственном QThreadPool.
+ *
+ * Очередь ограничена maxPending() задачами (выполняемые и ожидающие).
+ * Когда очередь заполнена, новая задача не ставится и future сразу
+ * завершается с признаком отказа: при массовом входе в начале занятия
+ * клиент получает ответ "повторите позже" вместо растущей задержки.
+ */
+class PasswordHasher
+{
+public:
+    /**
+     * @brief Результат проверки пароля.
+     * accepted == false - задача отклонена из-за заполненной очереди.
+     * upgradedHash - новый хеш с текущей стоимостью, если пароль верный,
+     * а сохраненный хеш устарел (SHA-256 или меньше итераций).
+     */
+    struct Verification {
+        bool accepted;
+        bool valid;
+        QString upgradedHash;
+
+        Verification() : accepted(false), valid(false) {}
+    };
+
+    // Предел очереди по умолчанию; переопределяется COURSE_HASH_QUEUE
+    static constexpr int DEFAULT_MAX_PENDING = 512;
+
+    /**
+     * @brief Получает единственный экземпляр класса (Singleton).
+     * @return Ссылка на экземпляр PasswordHasher
+     */
+    static PasswordHasher& getInstance();
+
+    /**
+     * @brief Хеширует пароль в пуле (CryptoUtils::hashPassword).
+     * @param password Пароль
+     * @param iterations Число итераций; 0 - текущая стоимость
+     * @return Future с хешем; пустая строка, если очередь заполнена
+     */
+    QFuture<QString> hash(const QString& password, int iterations = 0);
+
+    /**
+     * @brief Проверяет пароль в пуле и при необходимости пересчитывает хеш.
+     * @param password Введенный пароль
+     * @param storedHash Хеш из базы данных
+     * @param iterations Стоимость, ниже которой хеш пересчитывается; 0 - текущая
+     * @return Future с результатом проверки
+     */
+    QFuture<Verification> verify(const QString& password, const QString& storedHash, int iterations = 0);
+
+    /**
+     * @brief Получает число выполняемых и ожидающих задач.
+     * @return Количество задач
+     */
+    int pendingCount() const;
+
+    int maxPending() const;
+
+    /**
+     * @brief Изменяет предел очереди.
+     * @param maxPending Максимум выполняемых и ожидающих задач
+     */
+    void setMaxPending(int maxPending);
+
+    /**
+     * @brief Изменяет число потоков хеширования.
+     * @param threads Число потоков
+     */
+    void setMaxThreads(int threads);
+
+    // Prevent copying
+    PasswordHasher(const PasswordHasher&) = delete;
+    PasswordHasher& operator=(const PasswordHasher&) = delete;
+
+private:
+    PasswordHasher();
+    ~PasswordHasher();
+
+    /**
+     * @brief Ставит функцию в пул, если очередь не заполнена.
+     * @param rejected Результат для отклоненной задачи
+     */
+    template<typename T, typename Function>
+    QFuture<T> submit(const T& rejected, Function function);
+
+    QThreadPool m_pool;
+    std::atomic<int> m_pending;
+    std::atomic<int> m_maxPending;
+};
+
+template<typename T, typename Function>
+QFuture<T> PasswordHasher::submit(const T& rejected, Function function) {
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+
+    // Место в очереди занимается до постановки задачи
+    if (++m_pending > m_maxPending) {
+        --m_pending;
+        promise->addResult(rejected);
+        promise->finish();
+        return future;
+    }
+
+    m_pool.start([this, promise, function]() {
+        promise->addResult(function());
+        promise->finish();
+        --m_pending;
+    });
+    return future;
+}
+
+#endif // PASSWORDHASHER_H
@@ -0,0 +1,258 @@
+#include "core/QuizEngine.h"
+#include <QDebug>
+
+QuizEngine::QuizEngine(CourseProvider courseProvider, QuizSink* sink, QObject* parent)
+    : QObject(parent)
+    , m_courseProvider(std::move(courseProvider))
+    , m_sink(sink)
+    , m_phase(Phase::Idle)
+    , m_chapterIndex(0)
+    , m_decodedChapterIndex(-1) {
+    if (m_courseProvider) {
+        m_course = m_courseProvider();
+    }
+}
+
+bool QuizEngine::hasCourse() const {
+    return m_course && m_course->chapterCount() > 0;
+}
+
+void QuizEngine::start(int lastChapterId, const QString& lastStatus) {
+    if (!hasCourse()) {
+        return;
+    }
+
+    int chapterIndex = 0;
+    if (lastChapterId >= 0) {
+        if (lastStatus == "completed") {
+            // Глава сдана - переход к следующей
+            chapterIndex = lastChapterId + 1;
+            if (chapterIndex >= chapterCount()) {
+                emit courseCompleted();
+                chapterIndex = chapterCount() - 1;
+            }
+        } else {
+            // Глава не сдана или начата - продолжение с нее же
+            chapterIndex = lastChapterId;
+        }
+    }
+
+    if (chapterIndex < 0 || chapterIndex >= chapterCount()) {
+        chapterIndex = 0;
+    }
+    openChapter(chapterIndex);
+}
+
+bool QuizEngine::startTest() {
+    if (m_phase != Phase::Theory || currentChapter().questions.isEmpty()) {
+        return false;
+    }
+
+    m_test = TestState();
+    m_phase = Phase::Testing;
+    showQuestion();
+    return true;
+}
+
+bool QuizEngine::answer(int chosenOption) {
+    if (m_phase != Phase::Testing) {
+        return false;
+    }
+
+    const Chapter& chapter = currentChapter();
+    if (m_test.questionIndex >= chapter.questions.size()) {
+        return false;
+    }
+    const Question& question = chapter.questions.at(m_test.questionIndex);
+    if (chosenOption < 0 || chosenOption >= question.options.size()) {
+        return false;
+    }
+
+    QuizAnswer record;
+    record.chapterIndex = m_chapterIndex;
+    record.questionIndex = m_test.questionIndex;
+    record.chosenOption = chosenOption;
+    record.correct = chosenOption == question.correct_index;
+    record.latencyMs = static_cast<int>(m_questionTimer.elapsed());
+    record.outcome = applyAnswer(m_test, record.correct, static_cast<int>(chapter.questions.size()));
+
+    if (m_sink) {
+        m_sink->recordAnswer(record);
+        if (record.outcome != QuizOutcome::None) {
+            m_sink->recordOutcome(m_chapterIndex, record.outcome);
+        }
+    }
+
+    if (record.outcome == QuizOutcome::Passed) {
+        // Повторные ответы из обработчиков сигналов не принимаются
+        m_phase = Phase::Theory;
+        emit testPassed(m_chapterIndex);
+        moveToNextChapter();
+    } else if (record.correct) {
+        showQuestion();
+    } else {
+        emit answerWrong(m_test.errors, MAX_ERRORS);
+        if (record.outcome == QuizOutcome::Failed) {
+            m_phase = Phase::Theory;
+            emit testFailed(m_chapterIndex, m_test.errors);
+            openChapter(m_chapterIndex);
+        } else {
+            // Время на сообщение об ошибке не учитывается
+            m_questionTimer.start();
+        }
+    }
+    return true;
+}
+
+QuizEngine::Phase QuizEngine::phase() const {
+    return m_phase;
+}
+
+int QuizEngine::chapterIndex() const {
+    return m_chapterIndex;
+}
+
+int QuizEngine::chapterCount() const {
+    return m_course ? m_course->chapterCount() : 0;
+}
+
+int QuizEngine::questionIndex() const {
+    return m_test.questionIndex;
+}
+
+int QuizEngine::errorCount() const {
+    return m_test.errors;
+}
+
+const Chapter& QuizEngine::currentChapter() {
+    if (m_course && m_decodedChapterIndex != m_chapterIndex) {
+        m_decodedChapterIndex = m_chapterIndex;
+
+        // Поврежденная глава показывается пустой, с точным описанием ошибки
+        QString errorMessage;
+        if (!m_course->readChapter(m_chapterIndex, m_chapter, &errorMessage)) {
+            qWarning() << errorMessage;
+            m_chapter = Chapter();
+            emit chapterUnreadable(m_chapterIndex, errorMessage);
+        }
+    }
+    return m_chapter;
+}
+
+void QuizEngine::openChapter(int chapterIndex) {
+    m_chapterIndex = chapterIndex;
+    m_test = TestState();
+    m_phase = Phase::Theory;
+    currentChapter();
+    emit chapterOpened(m_chapterIndex);
+}
+
+void QuizEngine::showQuestion() {
+    emit questionShown(m_test.questionIndex);
+    m_questionTimer.start();
+}
+
+void QuizEngine::moveToNextChapter() {
+    // Между главами переходим на последний опубликованный снимок курса
+    CourseSnapshot latest = m_courseProvider ? m_courseProvider() : CourseSnapshot();
+    if (latest && latest != m_course && latest->chapterCount() > 0) {
+        m_course = latest;
+        m_decodedChapterIndex = -1;
+    }
+
+    int chapterIndex = m_chapterIndex + 1;
+    if (chapterIndex >= chapterCount()) {
+        emit courseCompleted();
+        chapterIndex = chapterCount() - 1;
+    }
+    openChapter(chapterIndex);
+}
+
+QuizEngine::AnswerKey QuizEngine::answerKey(const Chapter& chapter) {
+    AnswerKey key;
+    key.correctOptions.reserve(chapter.questions.size());
+    key.optionCounts.reserve(chapter.questions.size());
+    for (const Question& question : chapter.questions) {
+        key.correctOptions.append(question.correct_index);
+        key.optionCounts.append(static_cast<int>(question.options.size()));
+    }
+    return key;
+}
+
+QuizEngine::GradeResult QuizEngine::grade(const AnswerKey& key, const int* options, qsizetype count, int maxErrors) {
+    GradeResult result;
+    const int questionCount = static_cast<int>(key.correctOptions.size());
+    // Для главы без вопросов тест не начинается
+    if (questionCount == 0 || key.optionCounts.size() != questionCount) {
+        return result;
+    }
+
+    const int* correctOptions = key.correctOptions.constData();
+    const int* optionCounts = key.optionCounts.constData();
+    TestState state;
+    qsizetype answered = 0;
+    while (answered < count && state.outcome == QuizOutcome::None) {
+        const int option = options[answered];
+        // Несуществующий вариант отклоняется, как в answer()
+        if (option >= 0 && option < optionCounts[state.questionIndex]) {
+            applyAnswer(state, option == correctOptions[state.questionIndex], questionCount, maxErrors);
+        }
+        ++answered;
+    }
+
+    result.outcome = state.outcome;
+    result.answered = static_cast<int>(answered);
+    result.errors = state.errors;
+    result.questionIndex = state.questionIndex;
+    return result;
+}
+
+QuizEngine::BatchSummary QuizEngine::gradeBatch(const AnswerKey& key, const QList<int>& options,
+                                                const QList<qsizetype>& offsets, QList<GradeResult>* results,
+                                                int maxErrors) {
+    BatchSummary summary;
+    if (offsets.size() < 2) {
+        return summary;
+    }
+    if (offsets.constFirst() < 0) {
+        qWarning() << "Quiz batch: negative offset:" << offsets.constFirst();
+        return summary;
+    }
+    for (qsizetype i = 1; i < offsets.size(); ++i) {
+        if (offsets.at(i) < offsets.at(i - 1)) {
+            qWarning() << "Quiz batch: offsets decrease at" << i << ":" << offsets.at(i - 1) << ">" << offsets.at(i);
+            return summary;
+        }
+    }
+    if (offsets.constLast() > options.size()) {
+        qWarning() << "Quiz batch: offsets exceed the answers array:" << offsets.constLast() << ">" << options.size();
+        return summary;
+    }
+
+    const qsizetype sequences = offsets.size() - 1;
+    if (results) {
+        results->clear();
+        results->reserve(sequences);
+    }
+
+    const int* data = options.constData();
+    const qsizetype* bounds = offsets.constData();
+    for (qsizetype i = 0; i < sequences; ++i) {
+        const GradeResult result = grade(key, data + bounds[i], bounds[i + 1] - bounds[i], maxErrors);
+        switch (result.outcome) {
+        case QuizOutcome::Passed:
+            summary.passed++;
+            break;
+        case QuizOutcome::Failed:
+            summary.failed++;
+            break;
+        case QuizOutcome::None:
+            summary.incomplete++;
+            break;
+        }
+        if (results) {
+            results->append(result);
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,317 @@
+#ifndef QUIZENGINE_H
+#define QUIZENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QElapsedTimer>
+#include <functional>
+#include <memory>
+#include "core/CourseImage.h"
+#include "models/Structures.h"
+
+/**
+ * @brief Итог теста по главе.
+ */
+enum class QuizOutcome : quint8 {
+    // Тест не завершен
+    None,
+    Passed,
+    Failed
+};
+
+/**
+ * @brief Ответ на вопрос теста, передаваемый в QuizSink.
+ * outcome заполняется для ответа, завершившего тест.
+ */
+struct QuizAnswer {
+    int chapterIndex;
+    int questionIndex;
+    int chosenOption;
+    bool correct;
+    int latencyMs;
+    QuizOutcome outcome;
+
+    QuizAnswer()
+        : chapterIndex(-1), questionIndex(-1), chosenOption(-1), correct(false),
+          latencyMs(0), outcome(QuizOutcome::None) {}
+};
+
+/**
+ * @brief Получатель ответов и итогов тестов (журнал ответов, прогресс).
+ * Реализация для базы данных - DatabaseQuizSink; без получателя
+ * QuizEngine ничего не сохраняет.
+ */
+class QuizSink
+{
+public:
+    virtual ~QuizSink() = default;
+
+    /**
+     * @brief Сохраняет ответ на вопрос.
+     * @param answer Ответ
+     */
+    virtual void recordAnswer(const QuizAnswer& answer) = 0;
+
+    /**
+     * @brief Сохраняет итог теста по главе.
+     * @param chapterIndex Индекс главы
+     * @param outcome Passed или Failed
+     */
+    virtual void recordOutcome(int chapterIndex, QuizOutcome outcome) = 0;
+};
+
+/**
+ * @brief Логика прохождения курса без интерфейса.
+ * Хранит текущую главу, вопрос и число ошибок; тест по главе сдан, если
+ * на все вопросы дан правильный ответ, и не сдан после MAX_ERRORS ошибок.
+ * Неверный ответ не переводит к следующему вопросу.
+ *
+ * О смене состояния сообщают сигналы, которые окно студента показывает
+ * пользователю; ответы и итоги сохраняются через QuizSink. Сигналы
+ * испускаются синхронно, поэтому модальное сообщение в обработчике
+ * задерживает следующий шаг, а время ответа на вопрос считается с момента,
+ * когда обработчики questionShown() и answerWrong() вернули управление.
+ *
+ * Для проверки изменений курса на записанных ответах служит пакетный
+ * интерфейс (answerKey, grade, gradeBatch): те же правила без объекта,
+ * сигналов и расшифровки глав.
+ */
+class QuizEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    using CourseSnapshot = std::shared_ptr<const CourseImage>;
+    using CourseProvider = std::function<CourseSnapshot()>;
+
+    // Число ошибок, после которого тест не засчитывается
+    static constexpr int MAX_ERRORS = 3;
+
+    /**
+     * @brief Этап прохождения курса.
+     */
+    enum class Phase {
+        // Прогресс еще не загружен
+        Idle,
+        Theory,
+        Testing
+    };
+
+    /**
+     * @brief Состояние одного прохождения теста.
+     */
+    struct TestState {
+        int questionIndex;
+        int errors;
+        QuizOutcome outcome;
+
+        TestState() : questionIndex(0), errors(0), outcome(QuizOutcome::None) {}
+    };
+
+    /**
+     * @brief Правильные варианты и число вариантов вопросов главы по порядку.
+     */
+    struct AnswerKey {
+        QList<int> correctOptions;
+        QList<int> optionCounts;
+    };
+
+    /**
+     * @brief Итог проверки одной последовательности ответов.
+     * answered - ответов до завершения теста, включая отклоненные;
+     * остальные не учитываются.
+     */
+    struct GradeResult {
+        QuizOutcome outcome;
+        int answered;
+        int errors;
+        int questionIndex;
+
+        GradeResult() : outcome(QuizOutcome::None), answered(0), errors(0), questionIndex(0) {}
+    };
+
+    /**
+     * @brief Итоги пакетной проверки.
+     */
+    struct BatchSummary {
+        qint64 passed;
+        qint64 failed;
+        qint64 incomplete;
+
+        BatchSummary() : passed(0), failed(0), incomplete(0) {}
+    };
+
+    /**
+     * @brief Создает движок курса.
+     * @param courseProvider Источник снимка курса; вызывается при создании
+     * и при переходе между главами, чтобы подхватить изменения курса
+     * @param sink Получатель ответов и итогов, может быть nullptr
+     * @param parent Родительский объект
+     */
+    explicit QuizEngine(CourseProvider courseProvider, QuizSink* sink = nullptr, QObject* parent = nullptr);
+
+    /**
+     * @brief Проверяет, что курс открыт и содержит главы.
+     */
+    bool hasCourse() const;
+
+    /**
+     * @brief Переходит к главе по последнему сохраненному прогрессу.
+     * @param lastChapterId Индекс последней главы или -1
+     * @param lastStatus Статус последней главы ("completed", "fail")
+     */
+    void start(int lastChapterId, const QString& lastStatus);
+
+    /**
+     * @brief Начинает тест по текущей главе.
+     * @return false если в главе нет вопросов или тест уже идет
+     */
+    bool startTest();
+
+    /**
+     * @brief Принимает ответ на текущий вопрос.
+     * @param chosenOption Индекс выбранного варианта
+     * @return false если тест не идет или вариант не существует
+     */
+    bool answer(int chosenOption);
+
+    Phase phase() const;
+    int chapterIndex() const;
+    int chapterCount() const;
+    int questionIndex() const;
+    int errorCount() const;
+
+    /**
+     * @brief Получает текущую главу (расшифровывается при смене главы).
+     * Поврежденная глава возвращается пустой.
+     */
+    const Chapter& currentChapter();
+
+    /**
+     * @brief Применяет ответ к состоянию теста по правилам курса.
+     * @param state Состояние теста, завершенный тест не меняется
+     * @param correct true если ответ правильный
+     * @param questionCount Число вопросов главы
+     * @param maxErrors Число ошибок, после которого тест не засчитывается
+     * @return Итог теста после ответа
+     */
+    static inline QuizOutcome applyAnswer(TestState& state, bool correct, int questionCount,
+                                          int maxErrors = MAX_ERRORS);
+
+    /**
+     * @brief Составляет ключ ответов главы для пакетной проверки.
+     * @param chapter Глава курса
+     * @return Правильные варианты вопросов
+     */
+    static AnswerKey answerKey(const Chapter& chapter);
+
+    /**
+     * @brief Проверяет одну последовательность выбранных вариантов.
+     * Как и answer(), несуществующий вариант отклоняется: он не считается
+     * ни ошибкой, ни ответом на вопрос.
+     * @param key Ключ ответов главы
+     * @param options Выбранные варианты по порядку
+     * @param count Число ответов
+     * @param maxErrors Число ошибок, после которого тест не засчитывается
+     * @return Итог проверки
+     */
+    static GradeResult grade(const AnswerKey& key, const int* options, qsizetype count, int maxErrors = MAX_ERRORS);
+
+    /**
+     * @brief Проверяет пакет последовательностей, уложенных в один массив.
+     * Последовательность i занимает options[offsets[i], offsets[i + 1]),
+     * поэтому offsets содержит на один элемент больше числа последовательностей.
+     * Пакет не проверяется, если границы отрицательны, убывают или выходят
+     * за пределы options.
+     * @param key Ключ ответов главы
+     * @param options Выбранные варианты всех последовательностей подряд
+     * @param offsets Границы последовательностей
+     * @param results Итог каждой последовательности, может быть nullptr
+     * @param maxErrors Число ошибок, после которого тест не засчитывается
+     * @return Число сданных, несданных и незавершенных тестов
+     */
+    static BatchSummary gradeBatch(const AnswerKey& key, const QList<int>& options, const QList<qsizetype>& offsets,
+                                   QList<GradeResult>* results = nullptr, int maxErrors = MAX_ERRORS);
+
+signals:
+    /**
+     * @brief Открыта теория главы.
+     * @param chapterIndex Индекс главы
+     */
+    void chapterOpened(int chapterIndex);
+
+    /**
+     * @brief Показан вопрос теста.
+     * @param questionIndex Индекс вопроса в главе
+     */
+    void questionShown(int questionIndex);
+
+    /**
+     * @brief Неверный ответ; при errors == maxErrors следует testFailed().
+     * @param errors Ошибок в текущем тесте
+     * @param maxErrors Допустимое число ошибок
+     */
+    void answerWrong(int errors, int maxErrors);
+
+    /**
+     * @brief Тест по главе сдан; затем открывается следующая глава.
+     * @param chapterIndex Индекс главы
+     */
+    void testPassed(int chapterIndex);
+
+    /**
+     * @brief Тест по главе не сдан; затем снова открывается теория главы.
+     * @param chapterIndex Индекс главы
+     * @param errors Допущено ошибок
+     */
+    void testFailed(int chapterIndex, int errors);
+
+    /**
+     * @brief Пройдены все главы курса.
+     */
+    void courseCompleted();
+
+    /**
+     * @brief Главу не удалось расшифровать, она показывается пустой.
+     * @param chapterIndex Индекс главы
+     * @param error Описание ошибки
+     */
+    void chapterUnreadable(int chapterIndex, const QString& error);
+
+private:
+    void openChapter(int chapterIndex);
+    void showQuestion();
+    void moveToNextChapter();
+
+    CourseProvider m_courseProvider;
+    QuizSink* m_sink;
+    CourseSnapshot m_course;
+
+    Phase m_phase;
+    int m_chapterIndex;
+    TestState m_test;
+    // Время с показа текущего вопроса
+    QElapsedTimer m_questionTimer;
+
+    // В памяти расшифрована только текущая глава
+    Chapter m_chapter;
+    int m_decodedChapterIndex;
+};
+
+QuizOutcome QuizEngine::applyAnswer(TestState& state, bool correct, int questionCount, int maxErrors) {
+    if (state.outcome != QuizOutcome::None) {
+        return state.outcome;
+    }
+
+    if (correct) {
+        if (++state.questionIndex >= questionCount) {
+            state.outcome = QuizOutcome::Passed;
+        }
+    } else if (++state.errors >= maxErrors) {
+        state.outcome = QuizOutcome::Failed;
+    }
+    return state.outcome;
+}
+
+#endif // QUIZENGINE_H
@@ -0,0 +1,265 @@
+#include "core/StartupOrchestrator.h"
+#include <QEventLoop>
+#include <QThread>
+#include <QSet>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+
+// Итог этапа, зафиксированный в потоке, где этап завершился
+struct Completion {
+    QString error;
+    qint64 finishedMs;
+    QString thread;
+};
+
+}
+
+StartupOrchestrator::StartupOrchestrator(const QElapsedTimer& clock, QObject* parent)
+    : QObject(parent), m_clock(clock) {
+    m_pool.setObjectName("Startup");
+}
+
+StartupOrchestrator::~StartupOrchestrator() {
+    m_pool.waitForDone();
+}
+
+void StartupOrchestrator::addPhase(const QString& name, const QStringList& dependencies, Task task) {
+    addAsyncPhase(name, dependencies, [this, name, task]() {
+        return QtConcurrent::run(&m_pool, [name, task]() {
+            QThread::currentThread()->setObjectName("Startup:" + name);
+            return task();
+        });
+    });
+}
+
+void StartupOrchestrator::addAsyncPhase(const QString& name, const QStringList& dependencies, AsyncTask launch) {
+    if (indexOf(name) >= 0) {
+        qWarning() << "Startup phase is already defined:" << name;
+        return;
+    }
+
+    Phase phase;
+    phase.name = name;
+    phase.dependencies = dependencies;
+    phase.launch = std::move(launch);
+    phase.state = State::Pending;
+    phase.startedMs = -1;
+    phase.finishedMs = -1;
+    m_phases.append(phase);
+}
+
+void StartupOrchestrator::start() {
+    // Этапы, которые могут когда-нибудь начаться: все их зависимости
+    // существуют и не образуют цикл
+    QSet<QString> reachable;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Phase& phase : m_phases) {
+            if (reachable.contains(phase.name)) {
+                continue;
+            }
+            bool ready = true;
+            for (const QString& dependency : phase.dependencies) {
+                if (!reachable.contains(dependency)) {
+                    ready = false;
+                    break;
+                }
+            }
+            if (ready) {
+                reachable.insert(phase.name);
+                changed = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (!reachable.contains(m_phases.at(i).name)) {
+            finishPhase(i, "Unknown dependency or dependency cycle", m_clock.elapsed(), QString());
+        }
+    }
+
+    launchReady();
+}
+
+bool StartupOrchestrator::waitFor(const QStringList& names) {
+    if (!isSettled(names)) {
+        QEventLoop loop;
+        auto check = [this, &names, &loop]() {
+            if (isSettled(names)) {
+                loop.quit();
+            }
+        };
+        connect(this, &StartupOrchestrator::phaseFinished, &loop, check);
+        connect(this, &StartupOrchestrator::phaseFailed, &loop, check);
+        loop.exec();
+    }
+
+    for (const QString& name : names) {
+        if (state(name) != State::Finished) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StartupOrchestrator::mark(const QString& name) {
+    m_marks.append(qMakePair(name, m_clock.elapsed()));
+}
+
+StartupOrchestrator::State StartupOrchestrator::state(const QString& name) const {
+    const int index = indexOf(name);
+    return index >= 0 ? m_phases.at(index).state : State::Failed;
+}
+
+bool StartupOrchestrator::hasFailed() const {
+    return !m_error.isEmpty();
+}
+
+QString StartupOrchestrator::errorString() const {
+    return m_error;
+}
+
+QString StartupOrchestrator::report() const {
+    QStringList lines;
+    lines << "Startup trace (ms since process start):";
+    lines << QString("  %1 %2 %3 %4  %5 %6")
+                 .arg("phase", -20).arg("start", 7).arg("end", 7).arg("took", 7)
+                 .arg("state", -9).arg("thread");
+
+    for (const Phase& phase : m_phases) {
+        const bool started = phase.startedMs >= 0;
+        const bool ended = started && phase.finishedMs >= 0;
+        lines << QString("  %1 %2 %3 %4  %5 %6")
+                     .arg(phase.name, -20)
+                     .arg(started ? QString::number(phase.startedMs) : QString("-"), 7)
+                     .arg(ended ? QString::number(phase.finishedMs) : QString("-"), 7)
+                     .arg(ended ? QString::number(phase.finishedMs - phase.startedMs) : QString("-"), 7)
+                     .arg(stateName(phase.state), -9)
+                     .arg(phase.thread);
+        if (!phase.error.isEmpty()) {
+            lines << QString("  %1 %2").arg(QString(), -20).arg(phase.error);
+        }
+    }
+
+    for (const QPair<QString, qint64>& mark : m_marks) {
+        lines << QString("  %1 %2").arg(mark.first, -20).arg(mark.second, 7);
+    }
+    return lines.join('\n');
+}
+
+int StartupOrchestrator::indexOf(const QString& name) const {
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases.at(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void StartupOrchestrator::launchReady() {
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases.at(i).state != State::Pending) {
+            continue;
+        }
+
+        bool ready = true;
+        for (const QString& dependency : m_phases.at(i).dependencies) {
+            if (state(dependency) != State::Finished) {
+                ready = false;
+                break;
+            }
+        }
+        if (ready) {
+            launchPhase(i);
+        }
+    }
+}
+
+void StartupOrchestrator::launchPhase(int index) {
+    Phase& phase = m_phases[index];
+    phase.state = State::Running;
+    phase.startedMs = m_clock.elapsed();
+
+    // Время окончания фиксируется в потоке этапа, а не при доставке
+    // результата в поток интерфейса (он может быть занят диалогом)
+    const QElapsedTimer clock = m_clock;
+    phase.launch()
+        .then([clock](const QString& error) {
+            return Completion{error, clock.elapsed(), QThread::currentThread()->objectName()};
+        })
+        .then(this, [this, index](const Completion& completion) {
+            finishPhase(index, completion.error, completion.finishedMs, completion.thread);
+        })
+        .onCanceled(this, [this, index]() {
+            finishPhase(index, "Startup phase was canceled", m_clock.elapsed(), QString());
+        });
+}
+
+void StartupOrchestrator::finishPhase(int index, const QString& error, qint64 finishedMs, const QString& thread) {
+    Phase& phase = m_phases[index];
+    phase.finishedMs = finishedMs;
+    phase.thread = thread;
+    const QString name = phase.name;
+    const qint64 elapsedMs = phase.startedMs >= 0 ? finishedMs - phase.startedMs : 0;
+
+    if (!error.isEmpty()) {
+        phase.state = State::Failed;
+        phase.error = error;
+        if (m_error.isEmpty()) {
+            m_error = error;
+        }
+        qWarning().noquote() << "Startup phase" << name << "failed:" << error;
+
+        skipDependents(name);
+        emit phaseFailed(name, error);
+        return;
+    }
+
+    phase.state = State::Finished;
+    qDebug() << "Startup phase" << name << "finished in" << elapsedMs << "ms";
+
+    // Зависящие этапы запускаются до уведомления ожидающих: работа, которую
+    // ожидающий поставит в ту же очередь, окажется после них
+    launchReady();
+    emit phaseFinished(name, elapsedMs);
+}
+
+void StartupOrchestrator::skipDependents(const QString& name) {
+    for (int i = 0; i < m_phases.size(); ++i) {
+        Phase& phase = m_phases[i];
+        if (phase.state == State::Pending && phase.dependencies.contains(name)) {
+            phase.state = State::Skipped;
+            phase.error = QString("Skipped: %1 failed").arg(name);
+            skipDependents(phase.name);
+        }
+    }
+}
+
+bool StartupOrchestrator::isSettled(const QStringList& names) const {
+    for (const QString& name : names) {
+        const State current = state(name);
+        if (current == State::Pending || current == State::Running) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString StartupOrchestrator::stateName(State state) {
+    switch (state) {
+    case State::Pending:
+        return "pending";
+    case State::Running:
+        return "running";
+    case State::Finished:
+        return "finished";
+    case State::Failed:
+        return "failed";
+    case State::Skipped:
+        return "skipped";
+    }
+    return QString();
+}
@@ -0,0 +1,164 @@
+#ifndef STARTUPORCHESTRATOR_H
+#define STARTUPORCHESTRATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QFuture>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief Параллельный запуск приложения по графу зависимостей.
+ * Этап запуска (соединение с базой, миграции, загрузка курса) объявляется
+ * с именем и списком этапов, от которых он зависит. start() запускает все
+ * этапы без зависимостей, каждый следующий - сразу после завершения
+ * последней из его зависимостей. Этапы выполняются вне потока интерфейса:
+ * в собственном пуле потоков (addPhase) или там, куда их отправит функция
+ * запуска (addAsyncPhase, например рабочий поток DatabaseManager).
+ *
+ * Поток интерфейса ждет только нужные ему этапы (waitFor), продолжая
+ * обрабатывать события. Если этап завершился с ошибкой, зависящие от него
+ * этапы не запускаются. Время начала и окончания каждого этапа и отметки
+ * (mark) отсчитываются от запуска процесса; report() формирует таблицу
+ * для --startup-trace.
+ */
+class StartupOrchestrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Состояние этапа.
+     */
+    enum class State {
+        Pending,
+        Running,
+        Finished,
+        Failed,
+        Skipped
+    };
+
+    /**
+     * @brief Этап выполняется в пуле потоков; возвращает текст ошибки,
+     * пустой при успехе.
+     */
+    using Task = std::function<QString()>;
+
+    /**
+     * @brief Этап сам запускает асинхронную работу; future содержит
+     * текст ошибки, пустой при успехе.
+     */
+    using AsyncTask = std::function<QFuture<QString>()>;
+
+    /**
+     * @brief Создает пустой граф этапов.
+     * @param clock Таймер, запущенный в начале main(): от него отсчитывается время этапов
+     * @param parent Родительский объект
+     */
+    explicit StartupOrchestrator(const QElapsedTimer& clock, QObject* parent = nullptr);
+
+    /**
+     * @brief Дожидается этапов, выполняемых в пуле.
+     */
+    ~StartupOrchestrator() override;
+
+    /**
+     * @brief Добавляет этап, выполняемый в пуле потоков запуска.
+     * @param name Уникальное имя этапа
+     * @param dependencies Этапы, которые должны завершиться до начала
+     * @param task Функция этапа
+     */
+    void addPhase(const QString& name, const QStringList& dependencies, Task task);
+
+    /**
+     * @brief Добавляет этап, который сам выбирает поток выполнения.
+     * Функция запуска вызывается в потоке интерфейса и не должна блокировать его.
+     * @param name Уникальное имя этапа
+     * @param dependencies Этапы, которые должны завершиться до начала
+     * @param launch Функция запуска этапа
+     */
+    void addAsyncPhase(const QString& name, const QStringList& dependencies, AsyncTask launch);
+
+    /**
+     * @brief Проверяет граф и запускает этапы без зависимостей.
+     * Этапы с неизвестной зависимостью или в цикле завершаются с ошибкой.
+     */
+    void start();
+
+    /**
+     * @brief Обрабатывает события, пока перечисленные этапы не завершатся.
+     * @param names Имена этапов
+     * @return true если все этапы завершены успешно
+     */
+    bool waitFor(const QStringList& names);
+
+    /**
+     * @brief Запоминает отметку времени для отчета (например, показ окна).
+     * @param name Название отметки
+     */
+    void mark(const QString& name);
+
+    State state(const QString& name) const;
+
+    bool hasFailed() const;
+
+    /**
+     * @brief Получает ошибку первого этапа, завершившегося неудачно.
+     * @return Текст ошибки или пустая строка
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Формирует таблицу времени этапов и отметок.
+     * @return Многострочный текст отчета
+     */
+    QString report() const;
+
+signals:
+    /**
+     * @brief Сигнал об успешном завершении этапа.
+     * @param name Имя этапа
+     * @param elapsedMs Длительность этапа
+     */
+    void phaseFinished(const QString& name, qint64 elapsedMs);
+
+    /**
+     * @brief Сигнал об ошибке этапа; зависящие этапы пропускаются.
+     * @param name Имя этапа
+     * @param error Текст ошибки
+     */
+    void phaseFailed(const QString& name, const QString& error);
+
+private:
+    struct Phase {
+        QString name;
+        QStringList dependencies;
+        AsyncTask launch;
+        State state;
+        qint64 startedMs;
+        qint64 finishedMs;
+        // Поток, в котором этап завершился
+        QString thread;
+        QString error;
+    };
+
+    int indexOf(const QString& name) const;
+    void launchReady();
+    void launchPhase(int index);
+    void finishPhase(int index, const QString& error, qint64 finishedMs, const QString& thread);
+    void skipDependents(const QString& name);
+    bool isSettled(const QStringList& names) const;
+    static QString stateName(State state);
+
+    QElapsedTimer m_clock;
+    QThreadPool m_pool;
+    QList<Phase> m_phases;
+    QList<QPair<QString, qint64>> m_marks;
+    QString m_error;
+};
+
+#endif // STARTUPORCHESTRATOR_H
@@ -0,0 +1,34 @@
+# Ядро курса: модели, формат файла, сжатие и шифрование.
+# Подключается приложением и утилитами из tools/.
+
+INCLUDEPATH += $$PWD/..
+
+# Ключ шифрования курса, общий для приложения и утилит
+COURSE_ENCRYPTION_KEY = SECRET_KEY_123
+DEFINES += COURSE_ENCRYPTION_KEY=\\\"$$COURSE_ENCRYPTION_KEY\\\"
+
+SOURCES += \
+    $$PWD/../models/CompactCourse.cpp \
+    $$PWD/CryptoUtils.cpp \
+    $$PWD/CipherPipeline.cpp \
+    $$PWD/ChapterCodec.cpp \
+    $$PWD/CourseJournal.cpp \
+    $$PWD/CourseManager.cpp \
+    $$PWD/CourseImage.cpp \
+    $$PWD/CourseWriter.cpp \
+    $$PWD/CourseJsonReader.cpp \
+    $$PWD/QuizEngine.cpp
+
+HEADERS += \
+    $$PWD/../models/Structures.h \
+    $$PWD/../models/CompactCourse.h \
+    $$PWD/CryptoUtils.h \
+    $$PWD/CipherPipeline.h \
+    $$PWD/ChapterCodec.h \
+    $$PWD/CourseJournal.h \
+    $$PWD/CourseManager.h \
+    $$PWD/CourseFormat.h \
+    $$PWD/CourseImage.h \
+    $$PWD/CourseWriter.h \
+    $$PWD/CourseJsonReader.h \
+    $$PWD/QuizEngine.h
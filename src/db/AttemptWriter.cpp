@@ -0,0 +1,49 @@
+#include "db/AttemptWriter.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+AttemptWriter::AttemptWriter(QObject* parent)
+    : WriteBehindQueue(DEFAULT_FLUSH_INTERVAL_MS, MAX_BATCH_SIZE, parent) {
+}
+
+void AttemptWriter::enqueue(const QuestionAttempt& attempt) {
+    int pending = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pending.append(attempt);
+        trimPending();
+        pending = m_pending.size();
+    }
+
+    pendingAdded(pending);
+}
+
+QList<QuestionAttempt> AttemptWriter::takePending() {
+    QMutexLocker locker(&m_mutex);
+    QList<QuestionAttempt> attempts;
+    attempts.swap(m_pending);
+    return attempts;
+}
+
+void AttemptWriter::requeue(const QList<QuestionAttempt>& attempts) {
+    {
+        QMutexLocker locker(&m_mutex);
+        // Неудачный пакет старше ответов, поставленных за время записи
+        m_pending = attempts + m_pending;
+        trimPending();
+    }
+
+    pendingRequeued();
+}
+
+int AttemptWriter::pendingSize() const {
+    return m_pending.size();
+}
+
+void AttemptWriter::trimPending() {
+    const int excess = static_cast<int>(m_pending.size()) - MAX_PENDING;
+    if (excess > 0) {
+        m_pending.remove(0, excess);
+        qWarning() << "Attempt log buffer is full, dropped" << excess << "oldest answers";
+    }
+}
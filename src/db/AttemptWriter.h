@@ -0,0 +1,77 @@
+#ifndef ATTEMPTWRITER_H
+#define ATTEMPTWRITER_H
+
+#include "db/WriteBehindQueue.h"
+#include <QString>
+#include <QList>
+#include <QDateTime>
+
+/**
+ * @brief Один ответ студента на вопрос теста.
+ * outcome заполняется только для ответа, завершившего тест главы:
+ * "passed" или "failed".
+ */
+struct QuestionAttempt {
+    int userId;
+    int chapterId;
+    int questionIndex;
+    int chosenOption;
+    bool correct;
+    int latencyMs;
+    QDateTime answeredAt;
+    QString outcome;
+
+    QuestionAttempt()
+        : userId(0), chapterId(0), questionIndex(0), chosenOption(-1), correct(false), latencyMs(0) {}
+};
+
+/**
+ * @brief Буфер журнала ответов на вопросы.
+ * В отличие от ProgressWriter записи не объединяются: журнал только
+ * дополняется. Буфер сбрасывается одной пакетной записью (COPY
+ * в PostgreSQL) по таймеру, при накоплении MAX_BATCH_SIZE ответов и при
+ * завершении приложения. Пока база недоступна, в памяти хранится не
+ * больше MAX_PENDING ответов, самые старые отбрасываются.
+ */
+class AttemptWriter : public WriteBehindQueue
+{
+    Q_OBJECT
+
+public:
+    // Интервал сброса буфера по умолчанию
+    static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 5000;
+    // Число ответов, после которого буфер сбрасывается сразу
+    static constexpr int MAX_BATCH_SIZE = 1000;
+    // Предел буфера на время недоступности базы
+    static constexpr int MAX_PENDING = 50000;
+
+    explicit AttemptWriter(QObject* parent = nullptr);
+
+    /**
+     * @brief Добавляет ответ в буфер. Потокобезопасен.
+     * @param attempt Ответ студента
+     */
+    void enqueue(const QuestionAttempt& attempt);
+
+    /**
+     * @brief Забирает все накопленные ответы.
+     * @return Ответы в порядке поступления
+     */
+    QList<QuestionAttempt> takePending();
+
+    /**
+     * @brief Возвращает в начало буфера ответы, которые не удалось записать.
+     * @param attempts Ответы из неудачного пакета
+     */
+    void requeue(const QList<QuestionAttempt>& attempts);
+
+protected:
+    int pendingSize() const override;
+
+private:
+    void trimPending();
+
+    QList<QuestionAttempt> m_pending;
+};
+
+#endif // ATTEMPTWRITER_H
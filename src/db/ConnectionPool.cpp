@@ -0,0 +1,308 @@
+#include "db/ConnectionPool.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QThread>
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <QDebug>
+
+ConnectionPool::Settings::Settings()
+    : driver("QPSQL")
+    , port(5432)
+    , maxSize(qMax(2, QThread::idealThreadCount()))
+    , idleTimeoutMs(60000)
+    , healthCheckIntervalMs(30000)
+    , acquireTimeoutMs(30000) {
+}
+
+// ---------------------------------------------------------------------------
+// Connection
+
+ConnectionPool::Connection::Connection()
+    : m_pool(nullptr), m_generation(0) {
+}
+
+ConnectionPool::Connection::~Connection() {
+    release();
+}
+
+ConnectionPool::Connection::Connection(Connection&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_database(std::move(other.m_database))
+    , m_generation(other.m_generation)
+    , m_error(std::move(other.m_error)) {
+    other.m_pool = nullptr;
+}
+
+ConnectionPool::Connection& ConnectionPool::Connection::operator=(Connection&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_database = std::move(other.m_database);
+        m_generation = other.m_generation;
+        m_error = std::move(other.m_error);
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+bool ConnectionPool::Connection::isValid() const {
+    return m_pool != nullptr && m_database.isOpen();
+}
+
+QSqlDatabase ConnectionPool::Connection::database() const {
+    return m_database;
+}
+
+quint64 ConnectionPool::Connection::generation() const {
+    return m_generation;
+}
+
+QString ConnectionPool::Connection::errorString() const {
+    return m_error;
+}
+
+void ConnectionPool::Connection::release() {
+    if (m_pool) {
+        m_database = QSqlDatabase();
+        m_pool->releaseSlot();
+        m_pool = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ThreadSlot
+
+ConnectionPool::ThreadSlot::~ThreadSlot() {
+    close();
+}
+
+void ConnectionPool::ThreadSlot::close() {
+    if (connectionName.isEmpty()) {
+        return;
+    }
+
+    // Подготовленные запросы удаляются до закрытия соединения
+    statements.clear();
+
+    // Соединение закрывается в своем потоке: деструктор слота вызывается
+    // QThreadStorage при завершении потока
+    {
+        QSqlDatabase database = QSqlDatabase::database(connectionName, false);
+        if (database.isOpen()) {
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    connectionName.clear();
+
+    QMutexLocker locker(&state->mutex);
+    state->openCount--;
+    state->connectionClosed.wakeOne();
+}
+
+// ---------------------------------------------------------------------------
+// ConnectionPool
+
+ConnectionPool::ConnectionPool(const Settings& settings)
+    : m_settings(settings)
+    , m_state(std::make_shared<State>()) {
+    m_state->maxSize = qMax(1, settings.maxSize);
+}
+
+ConnectionPool::~ConnectionPool() {
+    // Соединение текущего потока закрывается сразу, остальные - при завершении их потоков
+    if (m_slots.hasLocalData()) {
+        m_slots.setLocalData(nullptr);
+    }
+}
+
+bool ConnectionPool::openDatabase(QSqlDatabase& database, const Settings& settings, QString* errorMessage) {
+    database.setHostName(settings.hostName);
+    database.setPort(settings.port);
+    database.setDatabaseName(settings.databaseName);
+    database.setUserName(settings.userName);
+    database.setPassword(settings.password);
+
+    if (!database.open()) {
+        *errorMessage = QString("Failed to connect to database: %1").arg(database.lastError().text());
+        return false;
+    }
+
+    QSqlQuery query(database);
+    for (const QString& statement : settings.initStatements) {
+        if (!query.exec(statement)) {
+            *errorMessage = QString("Failed to configure connection (%1): %2").arg(statement, query.lastError().text());
+            database.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+ConnectionPool::Connection ConnectionPool::acquire() {
+    Connection connection;
+
+    if (!m_slots.hasLocalData()) {
+        ThreadSlot* slot = new ThreadSlot();
+        slot->state = m_state;
+        m_slots.setLocalData(slot);
+    }
+    ThreadSlot* slot = m_slots.localData();
+
+    // Вложенная выдача в том же потоке использует уже проверенное соединение
+    if (slot->checkouts == 0 && !checkSlot(slot, &connection.m_error)) {
+        qWarning() << "Connection pool:" << connection.m_error;
+        return connection;
+    }
+
+    slot->checkouts++;
+    connection.m_pool = this;
+    connection.m_database = QSqlDatabase::database(slot->connectionName, false);
+    connection.m_generation = slot->generation;
+    return connection;
+}
+
+QSqlDatabase ConnectionPool::currentDatabase() const {
+    if (!m_slots.hasLocalData()) {
+        return QSqlDatabase();
+    }
+
+    const ThreadSlot* slot = m_slots.localData();
+    if (slot->checkouts == 0 || slot->connectionName.isEmpty()) {
+        return QSqlDatabase();
+    }
+    return QSqlDatabase::database(slot->connectionName, false);
+}
+
+quint64 ConnectionPool::currentGeneration() const {
+    if (!m_slots.hasLocalData()) {
+        return 0;
+    }
+    return m_slots.localData()->generation;
+}
+
+StatementCache* ConnectionPool::currentStatements() {
+    if (!m_slots.hasLocalData()) {
+        return nullptr;
+    }
+
+    ThreadSlot* slot = m_slots.localData();
+    if (slot->checkouts == 0 || slot->connectionName.isEmpty()) {
+        return nullptr;
+    }
+    return &slot->statements;
+}
+
+void ConnectionPool::setMaxSize(int maxSize) {
+    QMutexLocker locker(&m_state->mutex);
+    m_state->maxSize = qMax(1, maxSize);
+    m_state->connectionClosed.wakeAll();
+}
+
+int ConnectionPool::maxSize() const {
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->maxSize;
+}
+
+int ConnectionPool::openCount() const {
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->openCount;
+}
+
+int ConnectionPool::waitingCount() const {
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->waiting;
+}
+
+bool ConnectionPool::checkSlot(ThreadSlot* slot, QString* errorMessage) {
+    if (slot->connectionName.isEmpty()) {
+        return openSlot(slot, errorMessage);
+    }
+
+    const qint64 idleMs = slot->lastUsed.elapsed();
+    bool healthy = idleMs <= m_settings.idleTimeoutMs;
+
+    if (healthy) {
+        QSqlDatabase database = QSqlDatabase::database(slot->connectionName, false);
+        healthy = database.isOpen();
+
+        // Соединение могло быть разорвано сервером, пока простаивало
+        if (healthy && idleMs > m_settings.healthCheckIntervalMs) {
+            QSqlQuery query(database);
+            healthy = query.exec("SELECT 1");
+            if (!healthy) {
+                qWarning() << "Connection pool: health check failed, reconnecting:" << query.lastError().text();
+            }
+        }
+    }
+
+    if (healthy) {
+        return true;
+    }
+
+    slot->close();
+    return openSlot(slot, errorMessage);
+}
+
+bool ConnectionPool::openSlot(ThreadSlot* slot, QString* errorMessage) {
+    quint64 id = 0;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        QDeadlineTimer deadline(m_settings.acquireTimeoutMs);
+        while (m_state->openCount >= m_state->maxSize) {
+            m_state->waiting++;
+            const bool woken = m_state->connectionClosed.wait(&m_state->mutex, deadline);
+            m_state->waiting--;
+            if (!woken) {
+                *errorMessage = QString("Connection pool exhausted: %1 connections are open").arg(m_state->openCount);
+                return false;
+            }
+        }
+        m_state->openCount++;
+        id = ++m_state->nextId;
+    }
+
+    const QString connectionName = QString("course_db_pool_%1").arg(id);
+    bool opened = false;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase(m_settings.driver, connectionName);
+        opened = openDatabase(database, m_settings, errorMessage);
+    }
+
+    if (!opened) {
+        QSqlDatabase::removeDatabase(connectionName);
+        QMutexLocker locker(&m_state->mutex);
+        m_state->openCount--;
+        m_state->connectionClosed.wakeOne();
+        return false;
+    }
+
+    slot->connectionName = connectionName;
+    slot->generation = id;
+    slot->lastUsed.start();
+    return true;
+}
+
+void ConnectionPool::releaseSlot() {
+    if (!m_slots.hasLocalData()) {
+        return;
+    }
+
+    ThreadSlot* slot = m_slots.localData();
+    if (slot->checkouts == 0 || --slot->checkouts > 0) {
+        return;
+    }
+
+    // Место в пуле отдается ожидающему потоку, а не держится до завершения этого
+    bool contended = false;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        contended = m_state->waiting > 0;
+    }
+    if (contended) {
+        slot->close();
+    } else {
+        slot->lastUsed.restart();
+    }
+}
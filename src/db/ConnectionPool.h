@@ -0,0 +1,211 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+#include <memory>
+#include "db/StatementCache.h"
+
+/**
+ * @brief Пул соединений с базой данных, по одному соединению на поток.
+ * Qt разрешает использовать соединение только в потоке, который его создал,
+ * поэтому каждый поток получает собственное именованное соединение.
+ * Оно открывается при первой выдаче и закрывается при завершении потока
+ * (например, при истечении простаивающего потока QThreadPool).
+ *
+ * - maxSize ограничивает число одновременно открытых соединений: поток без
+ *   соединения ждет, пока другое соединение не закроется. Пока есть
+ *   ожидающие потоки, соединение закрывается при возврате в пул, поэтому
+ *   простаивающий поток не держит место, нужное другому;
+ * - соединение, простаивавшее дольше idleTimeout, переоткрывается при
+ *   следующей выдаче;
+ * - соединение, простаивавшее дольше healthCheckInterval, перед выдачей
+ *   проверяется запросом SELECT 1 и при ошибке переподключается.
+ *
+ * Выдача и возврат выполняются через RAII-объект Connection.
+ * У каждого соединения есть свой StatementCache, который очищается
+ * при закрытии и переподключении соединения.
+ */
+class ConnectionPool
+{
+public:
+    /**
+     * @brief Параметры подключения и ограничения пула.
+     */
+    struct Settings {
+        QString driver;
+        QString hostName;
+        int port;
+        QString databaseName;
+        QString userName;
+        QString password;
+        int maxSize;
+        int idleTimeoutMs;
+        int healthCheckIntervalMs;
+        int acquireTimeoutMs;
+        // Запросы, выполняемые сразу после открытия соединения (например, PRAGMA)
+        QStringList initStatements;
+
+        Settings();
+    };
+
+    /**
+     * @brief Соединение, выданное пулом текущему потоку.
+     * Возвращается в пул при уничтожении или вызове release().
+     * Использовать только в потоке, который его получил.
+     */
+    class Connection
+    {
+    public:
+        Connection();
+        ~Connection();
+
+        Connection(Connection&& other) noexcept;
+        Connection& operator=(Connection&& other) noexcept;
+
+        /**
+         * @brief Проверяет, выдано ли открытое соединение.
+         * @return true если соединение можно использовать
+         */
+        bool isValid() const;
+
+        /**
+         * @brief Получает соединение для QSqlQuery.
+         * @return Открытое соединение текущего потока
+         */
+        QSqlDatabase database() const;
+
+        /**
+         * @brief Получает номер подключения: увеличивается при каждом
+         * переподключении соединения потока.
+         * @return Номер подключения
+         */
+        quint64 generation() const;
+
+        /**
+         * @brief Получает причину, по которой соединение не выдано.
+         * @return Текст ошибки
+         */
+        QString errorString() const;
+
+        /**
+         * @brief Возвращает соединение в пул досрочно.
+         */
+        void release();
+
+    private:
+        friend class ConnectionPool;
+        Q_DISABLE_COPY(Connection)
+
+        ConnectionPool* m_pool;
+        QSqlDatabase m_database;
+        quint64 m_generation;
+        QString m_error;
+    };
+
+    explicit ConnectionPool(const Settings& settings = Settings());
+    ~ConnectionPool();
+
+    /**
+     * @brief Открывает соединение с параметрами settings и выполняет initStatements.
+     * @param database Соединение, созданное QSqlDatabase::addDatabase()
+     * @param settings Параметры подключения
+     * @param errorMessage Причина ошибки
+     * @return true если соединение открыто
+     */
+    static bool openDatabase(QSqlDatabase& database, const Settings& settings, QString* errorMessage);
+
+    /**
+     * @brief Выдает соединение текущему потоку.
+     * Повторная выдача в том же потоке возвращает то же соединение.
+     * @return Соединение; при ошибке isValid() == false и errorString()
+     */
+    Connection acquire();
+
+    /**
+     * @brief Получает соединение, уже выданное текущему потоку.
+     * @return Соединение или невалидный QSqlDatabase, если поток его не получал
+     */
+    QSqlDatabase currentDatabase() const;
+
+    /**
+     * @brief Получает номер подключения соединения текущего потока.
+     * @return Номер подключения, 0 если соединение не открыто
+     */
+    quint64 currentGeneration() const;
+
+    /**
+     * @brief Получает кэш подготовленных запросов соединения текущего потока.
+     * @return Кэш или nullptr, если поток не получал соединение
+     */
+    StatementCache* currentStatements();
+
+    /**
+     * @brief Изменяет максимальное число одновременно открытых соединений.
+     * @param maxSize Новое ограничение (не меньше 1)
+     */
+    void setMaxSize(int maxSize);
+
+    int maxSize() const;
+
+    /**
+     * @brief Получает число открытых соединений.
+     * @return Количество соединений во всех потоках
+     */
+    int openCount() const;
+
+    /**
+     * @brief Получает число потоков, ожидающих свободного места в пуле.
+     * @return Количество потоков
+     */
+    int waitingCount() const;
+
+private:
+    Q_DISABLE_COPY(ConnectionPool)
+
+    /**
+     * @brief Общее состояние пула; переживает пул, пока живы потоки с соединениями.
+     */
+    struct State {
+        QMutex mutex;
+        QWaitCondition connectionClosed;
+        int openCount;
+        int maxSize;
+        int waiting;
+        quint64 nextId;
+
+        State() : openCount(0), maxSize(1), waiting(0), nextId(0) {}
+    };
+
+    /**
+     * @brief Соединение потока; удаляется QThreadStorage при завершении потока.
+     */
+    struct ThreadSlot {
+        std::shared_ptr<State> state;
+        QString connectionName;
+        QElapsedTimer lastUsed;
+        StatementCache statements;
+        quint64 generation;
+        int checkouts;
+
+        ThreadSlot() : generation(0), checkouts(0) {}
+        ~ThreadSlot();
+
+        void close();
+    };
+
+    bool openSlot(ThreadSlot* slot, QString* errorMessage);
+    bool checkSlot(ThreadSlot* slot, QString* errorMessage);
+    void releaseSlot();
+
+    Settings m_settings;
+    std::shared_ptr<State> m_state;
+    QThreadStorage<ThreadSlot*> m_slots;
+};
+
+#endif // CONNECTIONPOOL_H
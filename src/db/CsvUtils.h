@@ -0,0 +1,34 @@
+#ifndef CSVUTILS_H
+#define CSVUTILS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Чтение и запись полей CSV (RFC 4180) для отчетов и импорта.
+ */
+class CsvUtils
+{
+public:
+    /**
+     * @brief Кодирует значение как поле CSV в UTF-8.
+     * Поля с разделителями, кавычками и переводами строк заключаются в кавычки.
+     * @param value Значение поля
+     * @return Поле для записи в файл
+     */
+    static QByteArray field(const QString& value);
+
+    /**
+     * @brief Делит строку CSV на поля.
+     * Поля в кавычках могут содержать запятые, "" внутри кавычек - одна кавычка.
+     * @param line Строка файла без перевода строки
+     * @return Поля строки
+     */
+    static QStringList splitLine(const QString& line);
+
+private:
+    CsvUtils() = delete;
+};
+
+#endif // CSVUTILS_H
@@ -1,159 +1,250 @@
 #include "db/DatabaseManager.h"
+#include "core/CryptoUtils.h"
+#include "core/PasswordHasher.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSqlDriver>
 
-const QString DatabaseManager::DB_HOSTNAME = "localhost";
-const QString DatabaseManager::DB_NAME = "course_db";
-const QString DatabaseManager::DB_USERNAME = "postgres";
-const QString DatabaseManager::DB_PASSWORD = "";
-const int DatabaseManager::DB_PORT = 5432;
+#ifdef HAVE_LIBPQ
+#include <libpq-fe.h>
+#endif
 
 DatabaseManager::DatabaseManager(QObject* parent)
-    : QObject(parent), m_connected(false) {
-    m_database = QSqlDatabase::addDatabase("QPSQL");
+    : QObject(parent), m_storage(Storage::create(Storage::configuredBackend())), m_pool(poolSettings()),
+      m_workerContext(nullptr), m_workerLatencyMs(0), m_runningCancel(nullptr), m_progressWriter(nullptr),
+      m_attemptWriter(nullptr) {
+    m_database = QSqlDatabase::addDatabase(m_storage->connectionSettings().driver);
+
+    // Искусственная задержка запросов рабочего потока для проверки отзывчивости UI
+    m_workerLatencyMs = qEnvironmentVariableIntValue("COURSE_DB_LATENCY_MS");
+
+    m_progressWriter = new ProgressWriter(this);
+    connect(m_progressWriter, &ProgressWriter::flushRequested, this, [this]() {
+        flushProgressAsync();
+    });
+
+    m_attemptWriter = new AttemptWriter(this);
+    connect(m_attemptWriter, &AttemptWriter::flushRequested, this, [this]() {
+        flushAttemptsAsync();
+    });
+
+    // Несохраненный прогресс и ответы записываются до остановки рабочего потока
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            QFuture<DatabaseResult<bool>> attempts;
+            QFuture<DatabaseResult<bool>> progress;
+            if (m_attemptWriter->pendingCount() > 0) {
+                attempts = flushAttemptsAsync();
+            }
+            if (m_progressWriter->pendingCount() > 0) {
+                progress = flushProgressAsync();
+            }
+            attempts.waitForFinished();
+            progress.waitForFinished();
+        });
+    }
 }
 
 DatabaseManager::~DatabaseManager() {
+    stopWorker();
+
+    m_statements.clear();
     if (m_database.isOpen()) {
         m_database.close();
     }
 }
 
-DatabaseManager& DatabaseManager::getInstance() {
-    static DatabaseManager instance;
-    return instance;
+ConnectionPool::Settings DatabaseManager::poolSettings() const {
+    ConnectionPool::Settings settings = m_storage->connectionSettings();
+
+    // Размер пула можно ограничить для сервера с малым max_connections
+    int maxSize = qEnvironmentVariableIntValue("COURSE_DB_POOL_SIZE");
+    if (maxSize > 0) {
+        settings.maxSize = maxSize;
+    }
+    return settings;
 }
 
-bool DatabaseManager::connectToDatabase() {
-    if (m_connected && m_database.isOpen()) {
-        return true;
+ConnectionPool& DatabaseManager::connectionPool() {
+    return m_pool;
+}
+
+Storage& DatabaseManager::storage() {
+    return *m_storage;
+}
+
+void DatabaseManager::startWorker() {
+    if (m_workerThread.isRunning()) {
+        return;
     }
 
-    m_database.setHostName(DB_HOSTNAME);
-    m_database.setPort(DB_PORT);
-    m_database.setDatabaseName(DB_NAME);
-    m_database.setUserName(DB_USERNAME);
-    m_database.setPassword(DB_PASSWORD);
+    m_workerThread.setObjectName("DatabaseWorker");
+    m_workerContext = new QObject();
+    m_workerContext->moveToThread(&m_workerThread);
+    // Соединение рабочего потока из пула закрывается при завершении потока
+    connect(&m_workerThread, &QThread::finished, m_workerContext, &QObject::deleteLater);
 
-    if (!m_database.open()) {
-        m_lastError = QString("Failed to connect to database: %1").arg(m_database.lastError().text());
-        qDebug() << m_lastError;
-        m_connected = false;
-        return false;
+    m_workerThread.start();
+}
+
+void DatabaseManager::stopWorker() {
+    if (!m_workerThread.isRunning()) {
+        return;
     }
 
-    m_connected = true;
-    m_lastError.clear();
-    qDebug() << "Successfully connected to PostgreSQL database:" << DB_NAME;
-    return true;
+    m_workerThread.quit();
+    m_workerThread.wait();
+    m_workerContext = nullptr;
 }
 
-bool DatabaseManager::initDatabase() {
-    if (!isConnected()) {
-        m_lastError = "Database not connected";
-        return false;
+ConnectionPool::Connection DatabaseManager::beginWorkerCall() {
+    if (m_workerLatencyMs > 0) {
+        QThread::msleep(static_cast<unsigned long>(m_workerLatencyMs));
     }
 
-    // Попытка загрузки схемы из файла
-    if (loadSchemaFromFile()) {
-        qDebug() << "Database schema loaded from file successfully";
-        return true;
+    setLastError(QString());
+    return m_pool.acquire();
+}
+
+void DatabaseManager::beginInterruptible(const ConnectionPool::Connection& connection,
+                                         std::function<bool()> isCanceled) {
+    QMutexLocker locker(&m_runningMutex);
+    m_runningIsCanceled = std::move(isCanceled);
+#ifdef HAVE_LIBPQ
+    // PGcancel создается в потоке соединения; PQcancel можно вызывать из любого потока
+    QVariant handle = connection.database().driver()->handle();
+    if (handle.isValid() && qstrcmp(handle.typeName(), "PGconn*") == 0) {
+        PGconn* pgConnection = *static_cast<PGconn* const*>(handle.data());
+        if (pgConnection) {
+            m_runningCancel = PQgetCancel(pgConnection);
+        }
     }
+#else
+    Q_UNUSED(connection);
+#endif
+}
 
-    // Резервный вариант с жестко заданной схемой
-    qDebug() << "Loading schema from file failed, using hardcoded schema";
-    return createTables();
+void DatabaseManager::endInterruptible() {
+    QMutexLocker locker(&m_runningMutex);
+    m_runningIsCanceled = nullptr;
+#ifdef HAVE_LIBPQ
+    if (m_runningCancel) {
+        PQfreeCancel(m_runningCancel);
+        m_runningCancel = nullptr;
+    }
+#endif
 }
 
-bool DatabaseManager::loadSchemaFromFile() {
-    QString schemaPath = QCoreApplication::applicationDirPath() + "/../data/schema.sql";
-    QFile schemaFile(schemaPath);
+void DatabaseManager::interruptCanceledQuery() {
+    QMutexLocker locker(&m_runningMutex);
+    // Прерывается только запрос, future которого отменен
+    if (!m_runningIsCanceled || !m_runningIsCanceled()) {
+        return;
+    }
 
-    if (!schemaFile.exists()) {
-        // Попытка альтернативного пути
-        schemaPath = "data/schema.sql";
-        schemaFile.setFileName(schemaPath);
+#ifdef HAVE_LIBPQ
+    if (m_runningCancel) {
+        char errorBuffer[256];
+        if (!PQcancel(m_runningCancel, errorBuffer, sizeof(errorBuffer))) {
+            qWarning() << "Failed to cancel running query:" << errorBuffer;
+        }
     }
+#endif
+}
 
-    if (!schemaFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        m_lastError = QString("Cannot open schema file: %1").arg(schemaPath);
-        qDebug() << m_lastError;
-        return false;
+QSqlDatabase DatabaseManager::connection() const {
+    // Поток интерфейса использует соединение по умолчанию,
+    // остальные потоки - соединение, выданное им пулом
+    if (QThread::currentThread() == thread()) {
+        return m_database;
     }
+    return m_pool.currentDatabase();
+}
 
-    QTextStream in(&schemaFile);
-    QString schemaContent = in.readAll();
-    schemaFile.close();
+StatementCache* DatabaseManager::statementCache() {
+    // Кэш, как и соединение, свой у каждого потока
+    if (QThread::currentThread() == thread()) {
+        return &m_statements;
+    }
+    return m_pool.currentStatements();
+}
 
-    // Разделение по точке с запятой и выполнение каждого оператора
-    QStringList statements = schemaContent.split(';', Qt::SkipEmptyParts);
+StatementCache* DatabaseManager::beginStorageCall() {
+    if (!isConnected()) {
+        setLastError("Database not connected");
+        qDebug() << getLastError();
+        return nullptr;
+    }
 
-    for (const QString& statement : statements) {
-        QString trimmedStatement = statement.trimmed();
-        if (trimmedStatement.isEmpty() || trimmedStatement.startsWith("--")) {
-            continue;
-        }
+    StatementCache* statements = statementCache();
+    if (!statements) {
+        setLastError("Database connection is not checked out from the pool");
+        qDebug() << getLastError();
+    }
+    return statements;
+}
+
+QList<StatementCache::Statistics> DatabaseManager::statementStatistics() const {
+    return StatementCache::statistics();
+}
+
+void DatabaseManager::setLastError(const QString& error) {
+    m_lastError.setLocalData(error);
+}
+
+DatabaseManager& DatabaseManager::getInstance() {
+    static DatabaseManager instance;
+    return instance;
+}
 
-        QSqlQuery query(m_database);
-        if (!query.exec(trimmedStatement)) {
-            m_lastError = QString("Failed to execute schema statement: %1").arg(query.lastError().text());
-            qDebug() << m_lastError;
-            qDebug() << "Statement:" << trimmedStatement;
+bool DatabaseManager::connectToDatabase() {
+    if (QThread::currentThread() != thread()) {
+        // В остальных потоках соединение открывает ConnectionPool::acquire()
+        if (!isConnected()) {
+            setLastError("Database connection is not checked out from the pool");
             return false;
         }
+        return true;
     }
 
-    return true;
-}
-
-bool DatabaseManager::createTables() {
-    QSqlQuery query(m_database);
+    QSqlDatabase database = connection();
+    if (database.isOpen()) {
+        return true;
+    }
 
-    // Создание таблицы пользователей
-    QString createUsersTable = R"(
-        CREATE TABLE IF NOT EXISTS users (
-            id SERIAL PRIMARY KEY,
-            login TEXT UNIQUE NOT NULL,
-            password_hash TEXT NOT NULL,
-            role TEXT NOT NULL DEFAULT 'student',
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
+    // Запросы, подготовленные в прежней сессии, на сервере уже не существуют
+    m_statements.clear();
 
-    if (!query.exec(createUsersTable)) {
-        m_lastError = QString("Failed to create users table: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
+    QString error;
+    if (!ConnectionPool::openDatabase(database, poolSettings(), &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
         return false;
     }
 
-    // Создание таблицы прогресса обучения
-    QString createProgressTable = R"(
-        CREATE TABLE IF NOT EXISTS study_progress (
-            user_id INTEGER NOT NULL,
-            chapter_id INTEGER NOT NULL,
-            status TEXT NOT NULL DEFAULT 'not_started',
-            last_score INTEGER DEFAULT 0,
-            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-            PRIMARY KEY (user_id, chapter_id),
-            FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE
-        )
-    )";
-
-    if (!query.exec(createProgressTable)) {
-        m_lastError = QString("Failed to create study_progress table: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
+    setLastError(QString());
+    qDebug() << "Successfully connected to" << m_storage->description();
+    return true;
+}
+
+bool DatabaseManager::initDatabase() {
+    if (!isConnected()) {
+        setLastError("Database not connected");
         return false;
     }
 
-    // Создание индексов для оптимизации запросов
-    query.exec("CREATE INDEX IF NOT EXISTS idx_users_login ON users(login)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_study_progress_user_id ON study_progress(user_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_study_progress_chapter_id ON study_progress(chapter_id)");
-
-    qDebug() << "Database tables created successfully";
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->initSchema(database, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return false;
+    }
     return true;
 }
 
 bool DatabaseManager::isConnected() const {
-    return m_connected && m_database.isOpen();
+    return connection().isOpen();
 }
 
 QStringList DatabaseManager::getTableList() const {
@@ -161,22 +252,22 @@ QStringList DatabaseManager::getTableList() const {
         return QStringList();
     }
 
-    return m_database.tables();
+    return connection().tables();
 }
 
 QString DatabaseManager::getLastError() const {
-    return m_lastError;
+    return m_lastError.localData();
 }
 
 bool DatabaseManager::executeQuery(const QString& query) {
     if (!isConnected()) {
-        m_lastError = "Database not connected";
+        setLastError("Database not connected");
         return false;
     }
 
-    QSqlQuery sqlQuery(m_database);
+    QSqlQuery sqlQuery(connection());
     if (!sqlQuery.exec(query)) {
-        m_lastError = QString("Query execution failed: %1").arg(sqlQuery.lastError().text());
+        setLastError(QString("Query execution failed: %1").arg(sqlQuery.lastError().text()));
         return false;
     }
 
@@ -184,7 +275,7 @@ bool DatabaseManager::executeQuery(const QString& query) {
 }
 
 QSqlQuery DatabaseManager::executeSelectQuery(const QString& query) {
-    QSqlQuery sqlQuery(m_database);
+    QSqlQuery sqlQuery(connection());
     if (isConnected()) {
         sqlQuery.exec(query);
     }
@@ -192,20 +283,16 @@ QSqlQuery DatabaseManager::executeSelectQuery(const QString& query) {
 }
 
 bool DatabaseManager::registerUser(const QString& login, const QString& passwordHash, const QString& role) {
-    if (!isConnected()) {
-        m_lastError = "Database not connected";
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
         return false;
     }
 
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO users (login, password_hash, role) VALUES (?, ?, ?)");
-    query.addBindValue(login);
-    query.addBindValue(passwordHash);
-    query.addBindValue(role);
-
-    if (!query.exec()) {
-        m_lastError = QString("Failed to register user: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->registerUser(database, *statements, login, passwordHash, role, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
         return false;
     }
 
@@ -213,160 +300,436 @@ bool DatabaseManager::registerUser(const QString& login, const QString& password
     return true;
 }
 
-QString DatabaseManager::authenticateUser(const QString& login, const QString& passwordHash) {
+QSet<QString> DatabaseManager::findExistingLogins(const QStringList& logins) {
     if (!isConnected()) {
-        m_lastError = "Database not connected";
-        return QString();
+        setLastError("Database not connected");
+        qDebug() << getLastError();
+        return QSet<QString>();
     }
 
-    QSqlQuery query(m_database);
-    query.prepare("SELECT role FROM users WHERE login = ? AND password_hash = ?");
-    query.addBindValue(login);
-    query.addBindValue(passwordHash);
+    QString error;
+    QSqlDatabase database = connection();
+    QSet<QString> existing = m_storage->findExistingLogins(database, logins, &error);
+    // Пустая ошибка тоже сохраняется: вызывающий проверяет getLastError()
+    setLastError(error);
+    if (!error.isEmpty()) {
+        qDebug() << getLastError();
+    }
+    return existing;
+}
 
-    if (!query.exec()) {
-        m_lastError = QString("Authentication query failed: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
-        return QString();
+bool DatabaseManager::importUsers(const QList<NewUser>& users) {
+    if (!isConnected()) {
+        setLastError("Database not connected");
+        qDebug() << getLastError();
+        return false;
     }
 
-    if (query.next()) {
-        QString role = query.value(0).toString();
-        qDebug() << "User authenticated successfully:" << login << "with role:" << role;
-        return role;
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->importUsers(database, users, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return false;
     }
 
-    qDebug() << "Authentication failed for user:" << login;
-    return QString();
+    qDebug() << "Users imported successfully:" << users.size();
+    return true;
+}
+
+QString DatabaseManager::authenticateUser(const QString& login, const QString& password) {
+    return authenticateUserWithId(login, password).first;
 }
 
-QPair<QString, int> DatabaseManager::authenticateUserWithId(const QString& login, const QString& passwordHash) {
-    if (!isConnected()) {
-        m_lastError = "Database not connected";
+QPair<QString, int> DatabaseManager::authenticateUserWithId(const QString& login, const QString& password) {
+    const UserCredentials credentials = getCredentials(login);
+    if (credentials.id < 0 || !CryptoUtils::verifyPassword(password, credentials.passwordHash)) {
+        if (getLastError().isEmpty()) {
+            qDebug() << "Authentication failed for user:" << login;
+        }
         return QPair<QString, int>(QString(), -1);
     }
 
-    QSqlQuery query(m_database);
-    query.prepare("SELECT id, role FROM users WHERE login = ? AND password_hash = ?");
-    query.addBindValue(login);
-    query.addBindValue(passwordHash);
+    if (CryptoUtils::needsRehash(credentials.passwordHash)) {
+        updatePasswordHash(credentials.id, credentials.passwordHash, CryptoUtils::hashPassword(password));
+        // Вход не зависит от результата пересчета хеша
+        setLastError(QString());
+    }
 
-    if (!query.exec()) {
-        m_lastError = QString("Authentication query failed: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
-        return QPair<QString, int>(QString(), -1);
+    qDebug() << "User authenticated successfully:" << login << "with role:" << credentials.role
+             << "and ID:" << credentials.id;
+    return QPair<QString, int>(credentials.role, credentials.id);
+}
+
+UserCredentials DatabaseManager::getCredentials(const QString& login) {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return UserCredentials();
     }
 
-    if (query.next()) {
-        int userId = query.value(0).toInt();
-        QString role = query.value(1).toString();
-        qDebug() << "User authenticated successfully:" << login << "with role:" << role << "and ID:" << userId;
-        return QPair<QString, int>(role, userId);
+    QString error;
+    QSqlDatabase database = connection();
+    UserCredentials credentials = m_storage->getCredentials(database, *statements, login, &error);
+    if (!error.isEmpty()) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return UserCredentials();
     }
+    return credentials;
+}
 
-    qDebug() << "Authentication failed for user:" << login;
-    return QPair<QString, int>(QString(), -1);
+bool DatabaseManager::updatePasswordHash(int userId, const QString& expectedHash, const QString& passwordHash) {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return false;
+    }
+
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->updatePasswordHash(database, *statements, userId, expectedHash, passwordHash, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return false;
+    }
+
+    qDebug() << "Password hash upgraded for user" << userId;
+    return true;
 }
 
-QSqlTableModel* DatabaseManager::getUsersModel() {
+QList<QSqlRecord> DatabaseManager::getUsersPage(const UsersPageQuery& pageQuery) {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return QList<QSqlRecord>();
+    }
+
+    QString error;
+    QSqlDatabase database = connection();
+    QList<QSqlRecord> records = m_storage->getUsersPage(database, *statements, pageQuery, &error);
+    if (!error.isEmpty()) {
+        setLastError(error);
+        qDebug() << getLastError();
+    }
+    return records;
+}
+
+void DatabaseManager::saveProgress(int userId, int chapterId, int score, const QString& status) {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return;
+    }
+
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->saveProgress(database, *statements, ProgressUpdate(userId, chapterId, score, status), &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+    } else {
+        qDebug() << "Progress saved for user" << userId << "chapter" << chapterId << "status:" << status;
+    }
+}
+
+bool DatabaseManager::saveProgressBatch(const QList<ProgressUpdate>& updates) {
+    if (updates.isEmpty()) {
+        return true;
+    }
+
     if (!isConnected()) {
-        m_lastError = "Database not connected";
-        return nullptr;
+        setLastError("Database not connected");
+        qDebug() << getLastError();
+        return false;
     }
 
-    QSqlTableModel* model = new QSqlTableModel(nullptr, m_database);
-    model->setTable("users");
-    model->setEditStrategy(QSqlTableModel::OnManualSubmit);
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->saveProgressBatch(database, updates, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return false;
+    }
+    return true;
+}
 
-    // Установка заголовков столбцов
-    model->setHeaderData(0, Qt::Horizontal, "ID");
-    model->setHeaderData(1, Qt::Horizontal, "Login");
-    model->setHeaderData(2, Qt::Horizontal, "Password Hash");
-    model->setHeaderData(3, Qt::Horizontal, "Role");
-    model->setHeaderData(4, Qt::Horizontal, "Created At");
+void DatabaseManager::queueProgress(int userId, int chapterId, int score, const QString& status) {
+    m_progressWriter->enqueue(ProgressUpdate(userId, chapterId, score, status));
+}
 
-    model->select();
-    return model;
+ProgressWriter& DatabaseManager::progressWriter() {
+    return *m_progressWriter;
 }
 
-void DatabaseManager::saveProgress(int userId, int chapterId, int score, const QString& status) {
+bool DatabaseManager::saveAttempts(const QList<QuestionAttempt>& attempts) {
+    if (attempts.isEmpty()) {
+        return true;
+    }
+
     if (!isConnected()) {
-        m_lastError = "Database not connected";
-        qDebug() << m_lastError;
-        return;
+        setLastError("Database not connected");
+        qDebug() << getLastError();
+        return false;
+    }
+
+    QString error;
+    QSqlDatabase database = connection();
+    if (!m_storage->saveAttempts(database, attempts, &error)) {
+        setLastError(error);
+        qDebug() << getLastError();
+        return false;
     }
+    return true;
+}
 
-    QSqlQuery query(m_database);
+void DatabaseManager::queueAttempt(const QuestionAttempt& attempt) {
+    m_attemptWriter->enqueue(attempt);
+}
 
-    // Проверка существования записи прогресса для данного пользователя и главы
-    query.prepare("SELECT id FROM student_progress WHERE user_id = ? AND chapter_id = ?");
-    query.addBindValue(userId);
-    query.addBindValue(chapterId);
+AttemptWriter& DatabaseManager::attemptWriter() {
+    return *m_attemptWriter;
+}
 
-    if (!query.exec()) {
-        m_lastError = QString("Failed to check existing progress: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
-        return;
+QList<QSqlRecord> DatabaseManager::getQuestionStats(int chapterId) {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return QList<QSqlRecord>();
     }
 
-    if (query.next()) {
-        // Обновление существующей записи
-        QSqlQuery updateQuery(m_database);
-        updateQuery.prepare("UPDATE student_progress SET score = ?, status = ?, updated_at = CURRENT_TIMESTAMP WHERE user_id = ? AND chapter_id = ?");
-        updateQuery.addBindValue(score);
-        updateQuery.addBindValue(status);
-        updateQuery.addBindValue(userId);
-        updateQuery.addBindValue(chapterId);
-
-        if (!updateQuery.exec()) {
-            m_lastError = QString("Failed to update progress: %1").arg(updateQuery.lastError().text());
-            qDebug() << m_lastError;
-        } else {
-            qDebug() << "Progress updated for user" << userId << "chapter" << chapterId << "status:" << status;
-        }
-    } else {
-        // Вставка новой записи
-        QSqlQuery insertQuery(m_database);
-        insertQuery.prepare("INSERT INTO student_progress (user_id, chapter_id, score, status) VALUES (?, ?, ?, ?)");
-        insertQuery.addBindValue(userId);
-        insertQuery.addBindValue(chapterId);
-        insertQuery.addBindValue(score);
-        insertQuery.addBindValue(status);
-
-        if (!insertQuery.exec()) {
-            m_lastError = QString("Failed to insert progress: %1").arg(insertQuery.lastError().text());
-            qDebug() << m_lastError;
-        } else {
-            qDebug() << "Progress saved for user" << userId << "chapter" << chapterId << "status:" << status;
-        }
+    QString error;
+    QSqlDatabase database = connection();
+    QList<QSqlRecord> records = m_storage->getQuestionStats(database, *statements, chapterId, &error);
+    if (!error.isEmpty()) {
+        setLastError(error);
+        qDebug() << getLastError();
     }
+    return records;
+}
+
+QList<QSqlRecord> DatabaseManager::getChapterStats() {
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
+        return QList<QSqlRecord>();
+    }
+
+    QString error;
+    QSqlDatabase database = connection();
+    QList<QSqlRecord> records = m_storage->getChapterStats(database, *statements, &error);
+    if (!error.isEmpty()) {
+        setLastError(error);
+        qDebug() << getLastError();
+    }
+    return records;
 }
 
 QPair<int, QString> DatabaseManager::getLastProgress(int userId) {
-    if (!isConnected()) {
-        m_lastError = "Database not connected";
-        qDebug() << m_lastError;
+    StatementCache* statements = beginStorageCall();
+    if (!statements) {
         return QPair<int, QString>(-1, QString());
     }
 
-    QSqlQuery query(m_database);
-    query.prepare("SELECT chapter_id, status FROM student_progress WHERE user_id = ? ORDER BY chapter_id DESC LIMIT 1");
-    query.addBindValue(userId);
-
-    if (!query.exec()) {
-        m_lastError = QString("Failed to get last progress: %1").arg(query.lastError().text());
-        qDebug() << m_lastError;
+    QString error;
+    QSqlDatabase database = connection();
+    QPair<int, QString> progress = m_storage->getLastProgress(database, *statements, userId, &error);
+    if (!error.isEmpty()) {
+        setLastError(error);
+        qDebug() << getLastError();
         return QPair<int, QString>(-1, QString());
     }
 
-    if (query.next()) {
-        int chapterId = query.value(0).toInt();
-        QString status = query.value(1).toString();
-        qDebug() << "Last progress for user" << userId << ": chapter" << chapterId << "status:" << status;
-        return QPair<int, QString>(chapterId, status);
+    qDebug() << "Last progress for user" << userId << ": chapter" << progress.first << "status:" << progress.second;
+    return progress;
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::connectToDatabaseAsync() {
+    return runAsync([this]() {
+        return isConnected();
+    });
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::initDatabaseAsync() {
+    return runAsync([this]() {
+        return initDatabase();
+    });
+}
+
+QFuture<DatabaseResult<QStringList>> DatabaseManager::getTableListAsync() {
+    return runAsync([this]() {
+        return getTableList();
+    });
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::executeQueryAsync(const QString& query) {
+    return runAsync([this, query]() {
+        return executeQuery(query);
+    });
+}
+
+QFuture<DatabaseResult<QList<QSqlRecord>>> DatabaseManager::executeSelectQueryAsync(const QString& query) {
+    return runAsync([this, query]() {
+        // QSqlQuery привязан к соединению рабочего потока, поэтому
+        // в поток интерфейса передаются только строки результата
+        QList<QSqlRecord> records;
+        QSqlQuery sqlQuery = executeSelectQuery(query);
+        if (!sqlQuery.isActive()) {
+            setLastError(QString("Query execution failed: %1").arg(sqlQuery.lastError().text()));
+            return records;
+        }
+
+        while (sqlQuery.next()) {
+            records.append(sqlQuery.record());
+        }
+        return records;
+    });
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::registerUserAsync(const QString& login, const QString& passwordHash,
+                                                                 const QString& role) {
+    return runAsync([this, login, passwordHash, role]() {
+        return registerUser(login, passwordHash, role);
+    });
+}
+
+QFuture<DatabaseResult<QString>> DatabaseManager::authenticateUserAsync(const QString& login,
+                                                                        const QString& password) {
+    return authenticateUserWithIdAsync(login, password)
+        .then([](const DatabaseResult<QPair<QString, int>>& authResult) {
+            DatabaseResult<QString> result;
+            result.value = authResult.value.first;
+            result.error = authResult.error;
+            return result;
+        });
+}
+
+QFuture<DatabaseResult<QPair<QString, int>>> DatabaseManager::authenticateUserWithIdAsync(const QString& login,
+                                                                                           const QString& password) {
+    using Result = DatabaseResult<QPair<QString, int>>;
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    auto finish = [promise](const QString& role, int userId, const QString& error) {
+        Result result;
+        result.value = QPair<QString, int>(role, userId);
+        result.error = error;
+        promise->addResult(std::move(result));
+        promise->finish();
+    };
+
+    // Рабочий поток только читает хеш; проверка пароля идет в пуле PasswordHasher
+    runAsync([this, login]() {
+        return getCredentials(login);
+    }).then(this, [this, login, password, finish](const DatabaseResult<UserCredentials>& credentials) {
+        if (!credentials.ok() || credentials.value.id < 0) {
+            if (credentials.ok()) {
+                qDebug() << "Authentication failed for user:" << login;
+            }
+            finish(QString(), -1, credentials.error);
+            return;
+        }
+
+        const UserCredentials user = credentials.value;
+        PasswordHasher::getInstance().verify(password, user.passwordHash)
+            .then(this, [this, login, user, finish](const PasswordHasher::Verification& verification) {
+                if (!verification.accepted) {
+                    qWarning() << "Password hashing queue is full, login rejected:" << login;
+                    finish(QString(), -1, "Too many simultaneous logins, try again in a few seconds");
+                    return;
+                }
+                if (!verification.valid) {
+                    qDebug() << "Authentication failed for user:" << login;
+                    finish(QString(), -1, QString());
+                    return;
+                }
+
+                // Новый хеш сохраняется в фоне, вход его не ждет
+                if (!verification.upgradedHash.isEmpty()) {
+                    const QString upgradedHash = verification.upgradedHash;
+                    runAsync([this, user, upgradedHash]() {
+                        return updatePasswordHash(user.id, user.passwordHash, upgradedHash);
+                    });
+                }
+
+                qDebug() << "User authenticated successfully:" << login << "with role:" << user.role
+                         << "and ID:" << user.id;
+                finish(user.role, user.id, QString());
+            });
+    });
+
+    return future;
+}
+
+QFuture<DatabaseResult<QList<QSqlRecord>>> DatabaseManager::getUsersPageAsync(const UsersPageQuery& pageQuery) {
+    return runAsync([this, pageQuery]() {
+        return getUsersPage(pageQuery);
+    });
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::flushProgressAsync() {
+    return runAsync([this]() {
+        // Очередь забирается при выполнении: изменения, поставленные
+        // пока запрос ждал рабочий поток, попадут в тот же пакет
+        const QList<ProgressUpdate> updates = m_progressWriter->takePending();
+        if (updates.isEmpty()) {
+            return true;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (!saveProgressBatch(updates)) {
+            m_progressWriter->requeue(updates);
+            return false;
+        }
+
+        qDebug() << "Progress flushed:" << updates.size() << "rows in" << timer.elapsed() << "ms";
+        return true;
+    });
+}
+
+QFuture<DatabaseResult<QPair<int, QString>>> DatabaseManager::getLastProgressAsync(int userId) {
+    // Запросы выполняются по порядку, поэтому чтение увидит сброшенную очередь
+    if (m_progressWriter->pendingCount() > 0) {
+        flushProgressAsync();
     }
 
-    // Прогресс не найден - возврат к первой главе
-    qDebug() << "No progress found for user" << userId << ", starting from chapter 0";
-    return QPair<int, QString>(0, QString("new"));
-}
\ No newline at end of file
+    return runAsync([this, userId]() {
+        return getLastProgress(userId);
+    });
+}
+
+QFuture<DatabaseResult<bool>> DatabaseManager::flushAttemptsAsync() {
+    return runAsync([this]() {
+        const QList<QuestionAttempt> attempts = m_attemptWriter->takePending();
+        if (attempts.isEmpty()) {
+            return true;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (!saveAttempts(attempts)) {
+            m_attemptWriter->requeue(attempts);
+            return false;
+        }
+
+        qDebug() << "Attempts flushed:" << attempts.size() << "rows in" << timer.elapsed() << "ms";
+        return true;
+    });
+}
+
+QFuture<DatabaseResult<QList<QSqlRecord>>> DatabaseManager::getQuestionStatsAsync(int chapterId) {
+    if (m_attemptWriter->pendingCount() > 0) {
+        flushAttemptsAsync();
+    }
+
+    return runAsync([this, chapterId]() {
+        return getQuestionStats(chapterId);
+    });
+}
+
+QFuture<DatabaseResult<QList<QSqlRecord>>> DatabaseManager::getChapterStatsAsync() {
+    // Сводка читается после сброса буфера, чтобы учесть свои последние ответы
+    if (m_attemptWriter->pendingCount() > 0) {
+        flushAttemptsAsync();
+    }
+
+    return runAsync([this]() {
+        return getChapterStats();
+    });
+}
@@ -5,7 +5,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
-#include <QSqlTableModel>
+#include <QVariant>
 #include <QString>
 #include <QStringList>
 #include <QDebug>
@@ -13,11 +13,57 @@
 #include <QTextStream>
 #include <QCoreApplication>
 #include <QPair>
+#include <QSqlRecord>
+#include <QList>
+#include <QThread>
+#include <QThreadStorage>
+#include <QFuture>
+#include <QPromise>
+#include <QMutex>
+#include <functional>
+#include <memory>
+#include "db/ConnectionPool.h"
+#include "db/ProgressWriter.h"
+#include "db/AttemptWriter.h"
+#include "db/StatementCache.h"
+#include "db/Storage.h"
+
+// PGcancel из libpq
+struct pg_cancel;
+
+/**
+ * @brief Результат асинхронного запроса к базе данных.
+ * error содержит текст ошибки рабочего потока, пустой при успехе.
+ */
+template<typename T>
+struct DatabaseResult {
+    T value;
+    QString error;
+
+    DatabaseResult() : value() {}
+
+    bool ok() const { return error.isEmpty(); }
+};
 
 /**
  * @brief Класс для управления базой данных.
- * Реализует паттерн Singleton для работы с PostgreSQL базой данных.
+ * Реализует паттерн Singleton для работы с базой данных.
  * Обеспечивает аутентификацию пользователей и отслеживание прогресса обучения.
+ * SQL конкретной СУБД (PostgreSQL или SQLite) выполняет Storage, выбранный
+ * переменной окружения COURSE_DB_BACKEND.
+ *
+ * Синхронные методы выполняются в вызывающем потоке и блокируют его на время
+ * запроса. Методы с суффиксом Async выполняются по очереди в отдельном
+ * рабочем потоке со своим соединением и сразу возвращают QFuture;
+ * интерфейс получает результат через QFuture::then(this, ...).
+ * Последняя ошибка (getLastError) хранится отдельно для каждого потока.
+ *
+ * Поток интерфейса работает через соединение по умолчанию. Остальные потоки
+ * (рабочий поток, фоновые задачи) получают соединение из ConnectionPool:
+ * пока поток держит ConnectionPool::Connection, синхронные методы
+ * DatabaseManager используют выданное ему соединение.
+ * Частые запросы (аутентификация, прогресс) готовятся на сервере один раз
+ * и берутся из StatementCache соединения.
  */
 class DatabaseManager : public QObject
 {
@@ -37,7 +83,8 @@ public:
     bool connectToDatabase();
     
     /**
-     * @brief Инициализирует структуру базы данных.
+     * @brief Инициализирует структуру базы данных: применяет миграции
+     * выбранного Storage (SchemaMigrator).
      * @return true если инициализация прошла успешно, false в противном случае
      */
     bool initDatabase();
@@ -83,30 +130,67 @@ public:
      */
     bool registerUser(const QString& login, const QString& passwordHash, const QString& role = "student");
     
+    /**
+     * @brief Ищет уже зарегистрированные логины.
+     * @param logins Проверяемые логины
+     * @return Логины из списка, которые уже есть в базе
+     */
+    QSet<QString> findExistingLogins(const QStringList& logins);
+    
+    /**
+     * @brief Регистрирует пакет пользователей в одной транзакции
+     * (в PostgreSQL - командой COPY).
+     * @param users Пользователи с готовыми хешами паролей
+     * @return true если зарегистрированы все пользователи
+     */
+    bool importUsers(const QList<NewUser>& users);
+    
     /**
      * @brief Аутентифицирует пользователя по логину и паролю.
      * @param login Логин пользователя
-     * @param passwordHash Хешированный пароль
+     * @param password Пароль в открытом виде
      * @return Роль пользователя или пустая строка при неудаче
      */
-    QString authenticateUser(const QString& login, const QString& passwordHash);
+    QString authenticateUser(const QString& login, const QString& password);
     
     /**
      * @brief Аутентифицирует пользователя и возвращает роль с ID.
+     * PBKDF2 проверяется в вызывающем потоке; устаревший хеш
+     * пересчитывается и сохраняется сразу.
      * @param login Логин пользователя
-     * @param passwordHash Хешированный пароль
+     * @param password Пароль в открытом виде
      * @return Пара (роль, ID пользователя)
      */
-    QPair<QString, int> authenticateUserWithId(const QString& login, const QString& passwordHash);
+    QPair<QString, int> authenticateUserWithId(const QString& login, const QString& password);
+
+    /**
+     * @brief Получает ID, роль и хеш пароля пользователя.
+     * @param login Логин пользователя
+     * @return Учетные данные; id == -1, если пользователь не найден
+     */
+    UserCredentials getCredentials(const QString& login);
+
+    /**
+     * @brief Заменяет хеш пароля, если он не изменился с момента чтения.
+     * @param userId ID пользователя
+     * @param expectedHash Прочитанный хеш
+     * @param passwordHash Новый хеш
+     * @return true если запрос выполнен
+     */
+    bool updatePasswordHash(int userId, const QString& expectedHash, const QString& passwordHash);
     
     /**
-     * @brief Получает модель данных пользователей для отображения в таблице.
-     * @return Указатель на QSqlTableModel с данными пользователей
+     * @brief Получает одну страницу таблицы users.
+     * Сортировка и фильтр выполняются на сервере; следующая страница
+     * выбирается по ключу последней строки (WHERE key > ? ORDER BY key LIMIT n).
+     * @param pageQuery Параметры страницы
+     * @return Строки (id, login, password_hash, role, created_at)
      */
-    QSqlTableModel* getUsersModel();
+    QList<QSqlRecord> getUsersPage(const UsersPageQuery& pageQuery);
     
     /**
-     * @brief Сохраняет прогресс студента по главе.
+     * @brief Сохраняет прогресс студента по главе одним запросом
+     * INSERT ... ON CONFLICT DO UPDATE.
      * @param userId ID пользователя
      * @param chapterId ID главы
      * @param score Количество баллов
@@ -120,6 +204,203 @@ public:
      * @return Пара (ID последней главы, статус)
      */
     QPair<int, QString> getLastProgress(int userId);
+
+    /**
+     * @brief Сохраняет пакет изменений прогресса в одной транзакции
+     * многострочным INSERT ... ON CONFLICT DO UPDATE.
+     * Каждая пара (user_id, chapter_id) должна встречаться в пакете один раз.
+     * @param updates Изменения прогресса
+     * @return true если весь пакет сохранен, false если транзакция отменена
+     */
+    bool saveProgressBatch(const QList<ProgressUpdate>& updates);
+
+    /**
+     * @brief Ставит сохранение прогресса в очередь отложенной записи.
+     * Изменение попадет в базу при очередном сбросе ProgressWriter.
+     * @param userId ID пользователя
+     * @param chapterId ID главы
+     * @param score Количество баллов
+     * @param status Статус прохождения
+     */
+    void queueProgress(int userId, int chapterId, int score, const QString& status);
+
+    /**
+     * @brief Получает очередь отложенной записи прогресса.
+     * @return Ссылка на очередь
+     */
+    ProgressWriter& progressWriter();
+
+    /**
+     * @brief Записывает пакет ответов в журнал question_attempts и
+     * обновляет сводные таблицы в одной транзакции.
+     * @param attempts Ответы студентов
+     * @return true если весь пакет сохранен
+     */
+    bool saveAttempts(const QList<QuestionAttempt>& attempts);
+
+    /**
+     * @brief Ставит ответ на вопрос в буфер журнала ответов.
+     * Ответ попадет в базу при очередном сбросе AttemptWriter.
+     * @param attempt Ответ студента
+     */
+    void queueAttempt(const QuestionAttempt& attempt);
+
+    /**
+     * @brief Получает буфер журнала ответов.
+     * @return Ссылка на буфер
+     */
+    AttemptWriter& attemptWriter();
+
+    /**
+     * @brief Получает сводку по вопросам главы (сводная таблица question_stats).
+     * @param chapterId ID главы
+     * @return Строки (question_index, attempts, correct, avg_latency_ms)
+     */
+    QList<QSqlRecord> getQuestionStats(int chapterId);
+
+    /**
+     * @brief Получает сводку прохождения тестов по главам (chapter_stats).
+     * @return Строки (chapter_id, tests_passed, tests_failed)
+     */
+    QList<QSqlRecord> getChapterStats();
+
+    /**
+     * @brief Получает пул соединений для фоновых потоков.
+     * @return Ссылка на пул соединений
+     */
+    ConnectionPool& connectionPool();
+
+    /**
+     * @brief Получает хранилище выбранной СУБД.
+     * @return Ссылка на хранилище
+     */
+    Storage& storage();
+
+    /**
+     * @brief Получает счетчики попаданий и промахов кэша подготовленных запросов.
+     * @return Счетчики для каждого текста SQL по всем соединениям
+     */
+    QList<StatementCache::Statistics> statementStatistics() const;
+
+    // Асинхронные варианты: выполняются в рабочем потоке базы данных,
+    // вызываются из потока интерфейса
+
+    /**
+     * @brief Устанавливает соединение рабочего потока с базой данных.
+     * @return Future с признаком активного соединения
+     */
+    QFuture<DatabaseResult<bool>> connectToDatabaseAsync();
+
+    /**
+     * @brief Асинхронный вариант initDatabase().
+     * @return Future с признаком успешной инициализации
+     */
+    QFuture<DatabaseResult<bool>> initDatabaseAsync();
+
+    /**
+     * @brief Асинхронный вариант getTableList().
+     * @return Future со списком таблиц
+     */
+    QFuture<DatabaseResult<QStringList>> getTableListAsync();
+
+    /**
+     * @brief Асинхронный вариант executeQuery().
+     * @param query SQL запрос для выполнения
+     * @return Future с признаком успешного выполнения
+     */
+    QFuture<DatabaseResult<bool>> executeQueryAsync(const QString& query);
+
+    /**
+     * @brief Асинхронный вариант executeSelectQuery().
+     * @param query SQL SELECT запрос
+     * @return Future со строками результата
+     */
+    QFuture<DatabaseResult<QList<QSqlRecord>>> executeSelectQueryAsync(const QString& query);
+
+    /**
+     * @brief Асинхронный вариант registerUser().
+     * @param login Логин пользователя
+     * @param passwordHash Хешированный пароль
+     * @param role Роль пользователя
+     * @return Future с признаком успешной регистрации
+     */
+    QFuture<DatabaseResult<bool>> registerUserAsync(const QString& login, const QString& passwordHash,
+                                                    const QString& role = "student");
+
+    /**
+     * @brief Асинхронный вариант authenticateUser().
+     * @param login Логин пользователя
+     * @param password Пароль в открытом виде
+     * @return Future с ролью пользователя
+     */
+    QFuture<DatabaseResult<QString>> authenticateUserAsync(const QString& login, const QString& password);
+
+    /**
+     * @brief Асинхронный вариант authenticateUserWithId().
+     * Хеш читается в рабочем потоке, пароль проверяется в PasswordHasher:
+     * медленный PBKDF2 не задерживает очередь запросов к базе. Если очередь
+     * хеширования заполнена, future завершается с ошибкой "повторите позже".
+     * Устаревший хеш пересчитывается и сохраняется после успешного входа.
+     * @param login Логин пользователя
+     * @param password Пароль в открытом виде
+     * @return Future с парой (роль, ID пользователя)
+     */
+    QFuture<DatabaseResult<QPair<QString, int>>> authenticateUserWithIdAsync(const QString& login,
+                                                                              const QString& password);
+
+    /**
+     * @brief Асинхронный вариант getUsersPage().
+     * @param pageQuery Параметры страницы
+     * @return Future со строками (id, login, password_hash, role, created_at)
+     */
+    QFuture<DatabaseResult<QList<QSqlRecord>>> getUsersPageAsync(const UsersPageQuery& pageQuery);
+
+    /**
+     * @brief Сбрасывает очередь отложенной записи прогресса одним пакетом.
+     * При ошибке изменения возвращаются в очередь.
+     * @return Future с признаком успешного сохранения
+     */
+    QFuture<DatabaseResult<bool>> flushProgressAsync();
+
+    /**
+     * @brief Асинхронный вариант getLastProgress().
+     * Перед чтением сбрасывает очередь отложенной записи прогресса.
+     * @param userId ID пользователя
+     * @return Future с парой (ID последней главы, статус)
+     */
+    QFuture<DatabaseResult<QPair<int, QString>>> getLastProgressAsync(int userId);
+
+    /**
+     * @brief Сбрасывает буфер журнала ответов одним пакетом.
+     * При ошибке ответы возвращаются в буфер.
+     * @return Future с признаком успешного сохранения
+     */
+    QFuture<DatabaseResult<bool>> flushAttemptsAsync();
+
+    /**
+     * @brief Асинхронный вариант getQuestionStats().
+     * Перед чтением сбрасывает буфер журнала ответов.
+     * @param chapterId ID главы
+     * @return Future со строками сводки по вопросам
+     */
+    QFuture<DatabaseResult<QList<QSqlRecord>>> getQuestionStatsAsync(int chapterId);
+
+    /**
+     * @brief Асинхронный вариант getChapterStats().
+     * Перед чтением сбрасывает буфер журнала ответов.
+     * @return Future со строками сводки по главам
+     */
+    QFuture<DatabaseResult<QList<QSqlRecord>>> getChapterStatsAsync();
+
+    /**
+     * @brief Отменяет асинхронный запрос.
+     * Запрос, ожидающий в очереди, не выполняется; выполняемый запрос
+     * прерывается на сервере (PQcancel, только PostgreSQL). Future завершается с ошибкой
+     * "Query cancelled", продолжения then() не вызываются.
+     * @param future Future, полученный от метода Async
+     */
+    template<typename T>
+    void cancelAsync(QFuture<T> future);
     
     // Prevent copying
     DatabaseManager(const DatabaseManager&) = delete;
@@ -129,19 +410,92 @@ private:
     explicit DatabaseManager(QObject *parent = nullptr);
     ~DatabaseManager();
     
-    bool createTables();
-    bool loadSchemaFromFile();
-    
-    // Database connection parameters
-    static const QString DB_HOSTNAME;
-    static const QString DB_NAME;
-    static const QString DB_USERNAME;
-    static const QString DB_PASSWORD;
-    static const int DB_PORT;
+    /**
+     * @brief Ставит функцию в очередь рабочего потока базы данных.
+     * На время выполнения рабочий поток получает соединение из пула;
+     * отмененный future не выполняется.
+     */
+    template<typename Function>
+    auto runAsync(Function function) -> QFuture<DatabaseResult<decltype(function())>>;
+
+    ConnectionPool::Settings poolSettings() const;
+    void startWorker();
+    void stopWorker();
+    ConnectionPool::Connection beginWorkerCall();
+    void beginInterruptible(const ConnectionPool::Connection& connection, std::function<bool()> isCanceled);
+    void endInterruptible();
+    void interruptCanceledQuery();
+    QSqlDatabase connection() const;
+    StatementCache* statementCache();
+    StatementCache* beginStorageCall();
+    void setLastError(const QString& error);
     
+    // Хранилище выбранной СУБД; создается до пула, которому нужны его параметры
+    std::unique_ptr<Storage> m_storage;
+    // Соединение потока интерфейса (соединение по умолчанию)
     QSqlDatabase m_database;
-    QString m_lastError;
-    bool m_connected;
+    QThreadStorage<QString> m_lastError;
+    // Подготовленные запросы соединения по умолчанию
+    StatementCache m_statements;
+    // Соединения остальных потоков
+    ConnectionPool m_pool;
+
+    QThread m_workerThread;
+    // Объект в рабочем потоке, в контексте которого выполняются запросы
+    QObject* m_workerContext;
+    int m_workerLatencyMs;
+    // Выполняемый в рабочем потоке запрос, который можно прервать
+    QMutex m_runningMutex;
+    pg_cancel* m_runningCancel;
+    std::function<bool()> m_runningIsCanceled;
+    // Очередь отложенной записи прогресса
+    ProgressWriter* m_progressWriter;
+    // Буфер журнала ответов на вопросы
+    AttemptWriter* m_attemptWriter;
 };
 
+template<typename Function>
+auto DatabaseManager::runAsync(Function function) -> QFuture<DatabaseResult<decltype(function())>> {
+    using Value = decltype(function());
+
+    startWorker();
+
+    auto promise = std::make_shared<QPromise<DatabaseResult<Value>>>();
+    QFuture<DatabaseResult<Value>> future = promise->future();
+    promise->start();
+
+    QMetaObject::invokeMethod(m_workerContext, [this, promise, function]() {
+        DatabaseResult<Value> result;
+        if (promise->isCanceled()) {
+            result.error = "Query cancelled";
+        } else {
+            // Соединение из пула выдано рабочему потоку на время запроса
+            ConnectionPool::Connection connection = beginWorkerCall();
+            if (!connection.isValid()) {
+                result.error = connection.errorString();
+            } else {
+                beginInterruptible(connection, [promise]() { return promise->isCanceled(); });
+                result.value = function();
+                endInterruptible();
+                result.error = promise->isCanceled() ? QString("Query cancelled") : getLastError();
+            }
+        }
+
+        promise->addResult(std::move(result));
+        promise->finish();
+    }, Qt::QueuedConnection);
+
+    return future;
+}
+
+template<typename T>
+void DatabaseManager::cancelAsync(QFuture<T> future) {
+    if (future.isFinished()) {
+        return;
+    }
+
+    future.cancel();
+    interruptCanceledQuery();
+}
+
 #endif // DATABASEMANAGER_H
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "db/DatabaseQuizSink.h"
+#include "db/DatabaseManager.h"
+
+DatabaseQuizSink::DatabaseQuizSink(int userId)
+    : m_userId(userId) {
+}
+
+void DatabaseQuizSink::recordAnswer(const QuizAnswer& answer) {
+    QuestionAttempt attempt;
+    attempt.userId = m_userId;
+    attempt.chapterId = answer.chapterIndex;
+    attempt.questionIndex = answer.questionIndex;
+    attempt.chosenOption = answer.chosenOption;
+    attempt.correct = answer.correct;
+    attempt.latencyMs = answer.latencyMs;
+    attempt.answeredAt = QDateTime::currentDateTime();
+
+    // Ответ, завершающий тест, отмечается итогом для сводки по главам
+    if (answer.outcome == QuizOutcome::Passed) {
+        attempt.outcome = "passed";
+    } else if (answer.outcome == QuizOutcome::Failed) {
+        attempt.outcome = "failed";
+    }
+
+    DatabaseManager::getInstance().queueAttempt(attempt);
+}
+
+void DatabaseQuizSink::recordOutcome(int chapterIndex, QuizOutcome outcome) {
+    if (outcome == QuizOutcome::Passed) {
+        DatabaseManager::getInstance().queueProgress(m_userId, chapterIndex, 100, "completed");
+    } else if (outcome == QuizOutcome::Failed) {
+        DatabaseManager::getInstance().queueProgress(m_userId, chapterIndex, 0, "fail");
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef DATABASEQUIZSINK_H
+#define DATABASEQUIZSINK_H
+
+#include "core/QuizEngine.h"
+
+/**
+ * @brief Сохранение ответов и итогов QuizEngine в базе данных.
+ * Ответы ставятся в буфер журнала (DatabaseManager::queueAttempt),
+ * итоги глав - в очередь прогресса (DatabaseManager::queueProgress);
+ * запись выполняется пакетами в рабочем потоке, окно не ждет базу.
+ */
+class DatabaseQuizSink : public QuizSink
+{
+public:
+    /**
+     * @brief Создает получатель для студента.
+     * @param userId ID студента в базе данных
+     */
+    explicit DatabaseQuizSink(int userId);
+
+    void recordAnswer(const QuizAnswer& answer) override;
+    void recordOutcome(int chapterIndex, QuizOutcome outcome) override;
+
+private:
+    int m_userId;
+};
+
+#endif // DATABASEQUIZSINK_H
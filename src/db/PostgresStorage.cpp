@@ -0,0 +1,310 @@
+#include "db/PostgresStorage.h"
+#include "db/SchemaMigrator.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlDriver>
+#include <QSet>
+#include <QDebug>
+#include <functional>
+
+#ifdef HAVE_LIBPQ
+#include <libpq-fe.h>
+
+namespace {
+
+// Размер порции данных, передаваемой PQputCopyData
+constexpr int COPY_CHUNK_SIZE = 64 * 1024;
+
+PGconn* nativeConnection(const QSqlDatabase& database) {
+    QVariant handle = database.driver()->handle();
+    if (handle.isValid() && qstrcmp(handle.typeName(), "PGconn*") == 0) {
+        return *static_cast<PGconn* const*>(handle.data());
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Экранирует значение для текстового формата COPY.
+ */
+QByteArray copyText(const QString& value) {
+    QByteArray result = value.toUtf8();
+    result.replace("\\", "\\\\").replace("\t", "\\t").replace("\n", "\\n").replace("\r", "\\r");
+    return result;
+}
+
+/**
+ * @brief Передает строки на сервер командой COPY ... FROM STDIN.
+ * Одна команда вместо INSERT на каждую порцию строк: сервер не разбирает
+ * и не планирует запросы, данные идут одним потоком.
+ * @param sql Команда COPY
+ * @param rowCount Число строк
+ * @param appendRow Дописывает строку с указанным номером в текстовом формате COPY
+ */
+bool copyIn(PGconn* connection, const char* sql, int rowCount,
+            const std::function<void(int, QByteArray&)>& appendRow, QString* errorMessage) {
+    PGresult* result = PQexec(connection, sql);
+    if (PQresultStatus(result) != PGRES_COPY_IN) {
+        *errorMessage = QString("Failed to start COPY: %1").arg(QString::fromUtf8(PQerrorMessage(connection)));
+        PQclear(result);
+        return false;
+    }
+    PQclear(result);
+
+    QByteArray buffer;
+    buffer.reserve(COPY_CHUNK_SIZE + 1024);
+    bool sent = true;
+
+    for (int i = 0; i < rowCount && sent; ++i) {
+        appendRow(i, buffer);
+
+        if (buffer.size() >= COPY_CHUNK_SIZE || i == rowCount - 1) {
+            sent = PQputCopyData(connection, buffer.constData(), static_cast<int>(buffer.size())) == 1;
+            buffer.clear();
+        }
+    }
+
+    if (!sent) {
+        *errorMessage = QString("Failed to send COPY data: %1").arg(QString::fromUtf8(PQerrorMessage(connection)));
+    }
+    // При ошибке отправки COPY прерывается, транзакция откатывается вызывающим
+    if (PQputCopyEnd(connection, sent ? nullptr : "client error") != 1 && sent) {
+        *errorMessage = QString("Failed to finish COPY: %1").arg(QString::fromUtf8(PQerrorMessage(connection)));
+        sent = false;
+    }
+
+    bool ok = sent;
+    while ((result = PQgetResult(connection)) != nullptr) {
+        if (ok && PQresultStatus(result) != PGRES_COMMAND_OK) {
+            *errorMessage = QString("COPY failed: %1").arg(QString::fromUtf8(PQresultErrorMessage(result)));
+            ok = false;
+        }
+        PQclear(result);
+    }
+    return ok;
+}
+
+} // namespace
+#endif
+
+const QString PostgresStorage::DB_HOSTNAME = "localhost";
+const QString PostgresStorage::DB_NAME = "course_db";
+const QString PostgresStorage::DB_USERNAME = "postgres";
+const QString PostgresStorage::DB_PASSWORD = "";
+const int PostgresStorage::DB_PORT = 5432;
+
+Storage::Backend PostgresStorage::backend() const {
+    return Backend::PostgreSQL;
+}
+
+QString PostgresStorage::description() const {
+    return QString("PostgreSQL database %1").arg(DB_NAME);
+}
+
+ConnectionPool::Settings PostgresStorage::connectionSettings() const {
+    ConnectionPool::Settings settings;
+    settings.driver = "QPSQL";
+    settings.hostName = DB_HOSTNAME;
+    settings.port = DB_PORT;
+    settings.databaseName = DB_NAME;
+    settings.userName = DB_USERNAME;
+    settings.password = DB_PASSWORD;
+    return settings;
+}
+
+bool PostgresStorage::initSchema(QSqlDatabase& database, QString* errorMessage) {
+    QString error;
+    const QList<SchemaMigrator::Migration> migrations =
+        SchemaMigrator::findMigrations(SchemaMigrator::migrationsDirectory(), &error);
+
+    if (migrations.isEmpty()) {
+        // Резервный вариант с жестко заданной схемой
+        qDebug() << "No schema migrations found, using hardcoded schema:" << error;
+        return createTables(database, errorMessage);
+    }
+
+    return SchemaMigrator::migrate(database, migrations, SchemaMigrator::Dialect::PostgreSQL, errorMessage);
+}
+
+QString PostgresStorage::caseInsensitiveLike() const {
+    // Поиск по подстроке использует триграммный индекс idx_users_login_trgm
+    return "ILIKE";
+}
+
+bool PostgresStorage::insertAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                                     QString* errorMessage) {
+    // Партиции месяцев пакета создаются до записи: строке без партиции
+    // сервер вернул бы ошибку
+    QSet<QDate> months;
+    for (const QuestionAttempt& attempt : attempts) {
+        const QDate day = attempt.answeredAt.date();
+        months.insert(QDate(day.year(), day.month(), 1));
+    }
+
+    QSqlQuery partition(database);
+    partition.prepare("SELECT create_question_attempts_partition(?)");
+    for (const QDate& month : months) {
+        partition.bindValue(0, month);
+        if (!partition.exec()) {
+            *errorMessage = QString("Failed to create attempts partition: %1").arg(partition.lastError().text());
+            return false;
+        }
+    }
+    partition.finish();
+
+#ifdef HAVE_LIBPQ
+    PGconn* connection = nativeConnection(database);
+    if (connection) {
+        return copyIn(connection,
+                      "COPY question_attempts (user_id, chapter_id, question_index, chosen_option, "
+                      "correct, latency_ms, outcome, answered_at) FROM STDIN",
+                      static_cast<int>(attempts.size()),
+                      [&attempts](int row, QByteArray& buffer) {
+                          const QuestionAttempt& attempt = attempts.at(row);
+                          buffer += QByteArray::number(attempt.userId) + '\t'
+                                  + QByteArray::number(attempt.chapterId) + '\t'
+                                  + QByteArray::number(attempt.questionIndex) + '\t'
+                                  + QByteArray::number(attempt.chosenOption) + '\t'
+                                  + (attempt.correct ? "t" : "f") + '\t'
+                                  + QByteArray::number(attempt.latencyMs) + '\t'
+                                  + (attempt.outcome.isEmpty() ? QByteArray("\\N") : copyText(attempt.outcome)) + '\t'
+                                  + attempt.answeredAt.toString("yyyy-MM-dd hh:mm:ss.zzz").toUtf8() + '\n';
+                      },
+                      errorMessage);
+    }
+#endif
+    return SqlStorage::insertAttempts(database, attempts, errorMessage);
+}
+
+bool PostgresStorage::insertUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) {
+#ifdef HAVE_LIBPQ
+    PGconn* connection = nativeConnection(database);
+    if (connection) {
+        return copyIn(connection, "COPY users (login, password_hash, role) FROM STDIN",
+                      static_cast<int>(users.size()),
+                      [&users](int row, QByteArray& buffer) {
+                          const NewUser& user = users.at(row);
+                          buffer += copyText(user.login) + '\t' + copyText(user.passwordHash) + '\t'
+                                  + copyText(user.role) + '\n';
+                      },
+                      errorMessage);
+    }
+#endif
+    return SqlStorage::insertUsers(database, users, errorMessage);
+}
+
+int PostgresStorage::maxQueryParameters() const {
+    // Число параметров в протоколе передается 16-битным числом
+    return 65535;
+}
+
+bool PostgresStorage::createTables(QSqlDatabase& database, QString* errorMessage) {
+    QSqlQuery query(database);
+
+    // Создание таблицы пользователей
+    QString createUsersTable = R"(
+        CREATE TABLE IF NOT EXISTS users (
+            id SERIAL PRIMARY KEY,
+            login TEXT UNIQUE NOT NULL,
+            password_hash TEXT NOT NULL,
+            role TEXT NOT NULL DEFAULT 'student',
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+
+    if (!query.exec(createUsersTable)) {
+        *errorMessage = QString("Failed to create users table: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    // Создание таблицы прогресса обучения
+    QString createProgressTable = R"(
+        CREATE TABLE IF NOT EXISTS study_progress (
+            user_id INTEGER NOT NULL,
+            chapter_id INTEGER NOT NULL,
+            status TEXT NOT NULL DEFAULT 'not_started',
+            last_score INTEGER DEFAULT 0,
+            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (user_id, chapter_id),
+            FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE
+        )
+    )";
+
+    if (!query.exec(createProgressTable)) {
+        *errorMessage = QString("Failed to create study_progress table: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    // Создание индексов для оптимизации запросов
+    query.exec("CREATE INDEX IF NOT EXISTS idx_users_login ON users(login)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_users_role_id ON users(role, id)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_users_created_at_id ON users(created_at, id)");
+    // Расширение может быть недоступно без прав владельца базы; поиск работает и без индекса
+    if (query.exec("CREATE EXTENSION IF NOT EXISTS pg_trgm")) {
+        query.exec("CREATE INDEX IF NOT EXISTS idx_users_login_trgm ON users USING gin (login gin_trgm_ops)");
+    }
+    query.exec("CREATE INDEX IF NOT EXISTS idx_study_progress_user_id ON study_progress(user_id)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_study_progress_chapter_id ON study_progress(chapter_id)");
+
+    // Журнал ответов и сводные таблицы, как в миграции 0004_question_attempts.sql:
+    // без них запись ответов и вкладка статистики завершаются ошибкой
+    const QStringList attemptsSchema = {
+        R"(
+        CREATE TABLE IF NOT EXISTS question_attempts (
+            user_id INTEGER NOT NULL,
+            chapter_id INTEGER NOT NULL,
+            question_index INTEGER NOT NULL,
+            chosen_option INTEGER NOT NULL,
+            correct BOOLEAN NOT NULL,
+            latency_ms INTEGER NOT NULL,
+            outcome TEXT,
+            answered_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+        ) PARTITION BY RANGE (answered_at)
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_question_attempts_answered_at ON question_attempts USING brin (answered_at)",
+        "CREATE INDEX IF NOT EXISTS idx_question_attempts_user_id ON question_attempts(user_id, answered_at)",
+        R"(
+        CREATE OR REPLACE FUNCTION create_question_attempts_partition(month_day DATE) RETURNS VOID AS $$
+        DECLARE
+            month_start DATE := date_trunc('month', month_day)::date;
+            partition_name TEXT := 'question_attempts_' || to_char(month_day, 'YYYY_MM');
+        BEGIN
+            IF to_regclass(partition_name) IS NOT NULL THEN
+                RETURN;
+            END IF;
+            EXECUTE format('CREATE TABLE %I PARTITION OF question_attempts FOR VALUES FROM (%L) TO (%L)',
+                           partition_name, month_start, (month_start + INTERVAL '1 month')::date);
+        EXCEPTION
+            WHEN duplicate_table THEN
+                NULL;
+        END;
+        $$ LANGUAGE plpgsql
+        )",
+        R"(
+        CREATE TABLE IF NOT EXISTS question_stats (
+            chapter_id INTEGER NOT NULL,
+            question_index INTEGER NOT NULL,
+            attempts BIGINT NOT NULL DEFAULT 0,
+            correct BIGINT NOT NULL DEFAULT 0,
+            total_latency_ms BIGINT NOT NULL DEFAULT 0,
+            PRIMARY KEY (chapter_id, question_index)
+        )
+        )",
+        R"(
+        CREATE TABLE IF NOT EXISTS chapter_stats (
+            chapter_id INTEGER PRIMARY KEY,
+            tests_passed BIGINT NOT NULL DEFAULT 0,
+            tests_failed BIGINT NOT NULL DEFAULT 0
+        )
+        )"
+    };
+
+    for (const QString& statement : attemptsSchema) {
+        if (!query.exec(statement)) {
+            *errorMessage = QString("Failed to create question attempts schema: %1").arg(query.lastError().text());
+            return false;
+        }
+    }
+
+    qDebug() << "Database tables created successfully";
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef POSTGRESSTORAGE_H
+#define POSTGRESSTORAGE_H
+
+#include "db/SqlStorage.h"
+
+/**
+ * @brief Хранилище на сервере PostgreSQL (драйвер QPSQL).
+ * Схема создается миграциями data/migrations; если файлов миграций нет,
+ * используется жестко заданная схема.
+ */
+class PostgresStorage : public SqlStorage
+{
+public:
+    Backend backend() const override;
+    QString description() const override;
+    ConnectionPool::Settings connectionSettings() const override;
+    bool initSchema(QSqlDatabase& database, QString* errorMessage) override;
+
+protected:
+    QString caseInsensitiveLike() const override;
+    int maxQueryParameters() const override;
+    bool insertAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                        QString* errorMessage) override;
+    bool insertUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) override;
+
+private:
+    bool createTables(QSqlDatabase& database, QString* errorMessage);
+
+    // Database connection parameters
+    static const QString DB_HOSTNAME;
+    static const QString DB_NAME;
+    static const QString DB_USERNAME;
+    static const QString DB_PASSWORD;
+    static const int DB_PORT;
+};
+
+#endif // POSTGRESSTORAGE_H
@@ -0,0 +1,43 @@
+#include "db/ProgressWriter.h"
+#include <QMutexLocker>
+
+ProgressWriter::ProgressWriter(QObject* parent)
+    : WriteBehindQueue(DEFAULT_FLUSH_INTERVAL_MS, MAX_BATCH_SIZE, parent) {
+}
+
+void ProgressWriter::enqueue(const ProgressUpdate& update) {
+    int pending = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        // Последнее изменение главы заменяет предыдущее
+        m_pending.insert(qMakePair(update.userId, update.chapterId), update);
+        pending = m_pending.size();
+    }
+
+    pendingAdded(pending);
+}
+
+QList<ProgressUpdate> ProgressWriter::takePending() {
+    QMutexLocker locker(&m_mutex);
+    QList<ProgressUpdate> updates = m_pending.values();
+    m_pending.clear();
+    return updates;
+}
+
+void ProgressWriter::requeue(const QList<ProgressUpdate>& updates) {
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const ProgressUpdate& update : updates) {
+            QPair<int, int> key = qMakePair(update.userId, update.chapterId);
+            if (!m_pending.contains(key)) {
+                m_pending.insert(key, update);
+            }
+        }
+    }
+
+    pendingRequeued();
+}
+
+int ProgressWriter::pendingSize() const {
+    return m_pending.size();
+}
@@ -0,0 +1,70 @@
+#ifndef PROGRESSWRITER_H
+#define PROGRESSWRITER_H
+
+#include "db/WriteBehindQueue.h"
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QPair>
+
+/**
+ * @brief Изменение прогресса студента по одной главе.
+ */
+struct ProgressUpdate {
+    int userId;
+    int chapterId;
+    int score;
+    QString status;
+
+    ProgressUpdate() : userId(0), chapterId(0), score(0) {}
+    ProgressUpdate(int user, int chapter, int chapterScore, const QString& chapterStatus)
+        : userId(user), chapterId(chapter), score(chapterScore), status(chapterStatus) {}
+};
+
+/**
+ * @brief Очередь отложенной записи прогресса (write-behind).
+ * Изменения накапливаются в памяти и объединяются по (user_id, chapter_id):
+ * в базу попадает только последнее. Очередь сбрасывается одним пакетным
+ * INSERT ... ON CONFLICT DO UPDATE в одной транзакции - по таймеру,
+ * при накоплении MAX_BATCH_SIZE изменений и при завершении приложения.
+ * Пакет выполняется в рабочем потоке DatabaseManager.
+ */
+class ProgressWriter : public WriteBehindQueue
+{
+    Q_OBJECT
+
+public:
+    // Интервал сброса очереди по умолчанию
+    static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 2000;
+    // Число изменений, после которого очередь сбрасывается сразу
+    static constexpr int MAX_BATCH_SIZE = 500;
+
+    explicit ProgressWriter(QObject* parent = nullptr);
+
+    /**
+     * @brief Ставит изменение прогресса в очередь. Потокобезопасен.
+     * @param update Изменение прогресса
+     */
+    void enqueue(const ProgressUpdate& update);
+
+    /**
+     * @brief Забирает все накопленные изменения из очереди.
+     * @return Список изменений, по одному на (user_id, chapter_id)
+     */
+    QList<ProgressUpdate> takePending();
+
+    /**
+     * @brief Возвращает в очередь изменения, которые не удалось записать.
+     * Более новые изменения тех же глав, поставленные за это время, сохраняются.
+     * @param updates Изменения из неудачного пакета
+     */
+    void requeue(const QList<ProgressUpdate>& updates);
+
+protected:
+    int pendingSize() const override;
+
+private:
+    QHash<QPair<int, int>, ProgressUpdate> m_pending;
+};
+
+#endif // PROGRESSWRITER_H
@@ -0,0 +1,354 @@
+#include "db/ReportGenerator.h"
+#include "db/DatabaseManager.h"
+#include "db/CsvUtils.h"
+#include <QSaveFile>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+// Строки отчета: новые пользователи первыми
+const char* const ROWS_SQL = "SELECT login, role, created_at FROM users ORDER BY created_at DESC, id DESC";
+
+/**
+ * @brief Кодирует строку как строковый литерал JSON.
+ */
+QByteArray jsonString(const QString& value) {
+    // Массив из одного элемента: [\"...\"] -> \"...\"
+    QByteArray array = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return array.mid(1, array.size() - 2);
+}
+
+QString formatDateTime(const QDateTime& dateTime) {
+    return dateTime.isValid() ? dateTime.toString(Qt::ISODateWithMs) : QString();
+}
+
+} // namespace
+
+ReportGenerator::ReportGenerator(QObject* parent)
+    : QObject(parent), m_thread(nullptr), m_cancelRequested(false) {
+}
+
+ReportGenerator::~ReportGenerator() {
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool ReportGenerator::start(const QString& filePath, Format format) {
+    if (isRunning()) {
+        return false;
+    }
+
+    delete m_thread;
+    m_cancelRequested = false;
+
+    m_thread = QThread::create([this, filePath, format]() {
+        run(filePath, format);
+    });
+    m_thread->setObjectName("ReportGenerator");
+    m_thread->start();
+    return true;
+}
+
+void ReportGenerator::cancel() {
+    m_cancelRequested = true;
+}
+
+bool ReportGenerator::isRunning() const {
+    return m_thread && m_thread->isRunning();
+}
+
+QString ReportGenerator::fileExtension(Format format) {
+    switch (format) {
+    case Format::Csv: return "csv";
+    case Format::Json: return "json";
+    default: return "txt";
+    }
+}
+
+qint64 ReportGenerator::Totals::countOf(const QString& role) const {
+    for (const auto& roleCount : roleCounts) {
+        if (roleCount.first == role) {
+            return roleCount.second;
+        }
+    }
+    return 0;
+}
+
+void ReportGenerator::run(const QString& filePath, Format format) {
+    // Отчет не занимает рабочий поток DatabaseManager: у потока отчета свое соединение
+    ConnectionPool::Connection connection = DatabaseManager::getInstance().connectionPool().acquire();
+    if (!connection.isValid()) {
+        emit failed(connection.errorString());
+        return;
+    }
+
+    QSqlDatabase database = connection.database();
+    QString error;
+
+    if (!database.transaction()) {
+        emit failed(QString("Failed to start report transaction: %1").arg(database.lastError().text()));
+        return;
+    }
+
+    // Итоги и строки должны описывать один и тот же снимок таблицы.
+    // В SQLite (WAL) снимок дает сама читающая транзакция
+    QSqlQuery isolation(database);
+    if (!isSqlite(database) && !isolation.exec("SET TRANSACTION ISOLATION LEVEL REPEATABLE READ READ ONLY")) {
+        database.rollback();
+        emit failed(QString("Failed to set report isolation level: %1").arg(isolation.lastError().text()));
+        return;
+    }
+
+    Totals totals;
+    if (!loadTotals(database, totals, &error)) {
+        database.rollback();
+        emit failed(error);
+        return;
+    }
+
+    QSaveFile file(filePath);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly;
+    if (format == Format::Text) {
+        mode |= QIODevice::Text;
+    }
+    if (!file.open(mode)) {
+        database.rollback();
+        emit failed(QString("Cannot open report file: %1").arg(file.errorString()));
+        return;
+    }
+
+    file.write(header(format, totals, QDateTime::currentDateTime()));
+
+    const bool written = writeRows(database, file, format, totals.totalUsers, &error);
+    database.rollback();
+
+    if (m_cancelRequested) {
+        file.cancelWriting();
+        emit canceled();
+        return;
+    }
+
+    if (!written) {
+        file.cancelWriting();
+        emit failed(error);
+        return;
+    }
+
+    file.write(footer(format, totals));
+    if (!file.commit()) {
+        emit failed(QString("Failed to write report file: %1").arg(file.errorString()));
+        return;
+    }
+
+    emit finished(filePath, totals.totalUsers);
+}
+
+bool ReportGenerator::loadTotals(QSqlDatabase& database, Totals& totals, QString* errorMessage) {
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT role, COUNT(*) FROM users GROUP BY role ORDER BY role")) {
+        *errorMessage = QString("Failed to count users: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    while (query.next()) {
+        const qint64 count = query.value(1).toLongLong();
+        totals.roleCounts.append(qMakePair(query.value(0).toString(), count));
+        totals.totalUsers += count;
+    }
+    return true;
+}
+
+bool ReportGenerator::writeRows(QSqlDatabase& database, QIODevice& output, Format format,
+                                qint64 totalRows, QString* errorMessage) {
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    if (isSqlite(database)) {
+        return writeRowsSequential(query, output, format, totalRows, errorMessage);
+    }
+
+    // Курсор на сервере: клиент держит в памяти только одну порцию строк
+    if (!query.exec("DECLARE report_cursor NO SCROLL CURSOR FOR " + QString(ROWS_SQL))) {
+        *errorMessage = QString("Failed to open report cursor: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    const QString fetchSql = QString("FETCH FORWARD %1 FROM report_cursor").arg(FETCH_SIZE);
+    qint64 rowsWritten = 0;
+    QByteArray chunk;
+
+    while (!m_cancelRequested) {
+        if (!query.exec(fetchSql)) {
+            *errorMessage = QString("Failed to read report rows: %1").arg(query.lastError().text());
+            return false;
+        }
+
+        int fetched = 0;
+        chunk.clear();
+        while (query.next()) {
+            chunk += formatRow(format, query.value(0).toString(), query.value(1).toString(),
+                               query.value(2).toDateTime(), rowsWritten + fetched == 0);
+            fetched++;
+        }
+
+        if (fetched == 0) {
+            break;
+        }
+
+        if (output.write(chunk) != chunk.size()) {
+            *errorMessage = QString("Failed to write report file: %1").arg(output.errorString());
+            return false;
+        }
+
+        rowsWritten += fetched;
+        emit progress(rowsWritten, totalRows);
+
+        if (fetched < FETCH_SIZE) {
+            break;
+        }
+    }
+
+    query.exec("CLOSE report_cursor");
+    return true;
+}
+
+bool ReportGenerator::writeRowsSequential(QSqlQuery& query, QIODevice& output, Format format,
+                                          qint64 totalRows, QString* errorMessage) {
+    // Драйвер SQLite читает forward-only запрос построчно, курсор не нужен
+    if (!query.exec(ROWS_SQL)) {
+        *errorMessage = QString("Failed to read report rows: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    qint64 rowsWritten = 0;
+    int buffered = 0;
+    QByteArray chunk;
+
+    while (!m_cancelRequested && query.next()) {
+        chunk += formatRow(format, query.value(0).toString(), query.value(1).toString(),
+                           query.value(2).toDateTime(), rowsWritten + buffered == 0);
+        buffered++;
+
+        if (buffered == FETCH_SIZE) {
+            if (output.write(chunk) != chunk.size()) {
+                *errorMessage = QString("Failed to write report file: %1").arg(output.errorString());
+                return false;
+            }
+            rowsWritten += buffered;
+            buffered = 0;
+            chunk.clear();
+            emit progress(rowsWritten, totalRows);
+        }
+    }
+
+    if (query.lastError().isValid()) {
+        *errorMessage = QString("Failed to read report rows: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    if (buffered > 0 && !m_cancelRequested) {
+        if (output.write(chunk) != chunk.size()) {
+            *errorMessage = QString("Failed to write report file: %1").arg(output.errorString());
+            return false;
+        }
+        rowsWritten += buffered;
+        emit progress(rowsWritten, totalRows);
+    }
+
+    query.finish();
+    return true;
+}
+
+bool ReportGenerator::isSqlite(const QSqlDatabase& database) {
+    return database.driverName() == "QSQLITE";
+}
+
+QByteArray ReportGenerator::header(Format format, const Totals& totals, const QDateTime& generatedAt) {
+    QByteArray result;
+
+    switch (format) {
+    case Format::Text:
+        result += "=== ОТЧЕТ ПО ПОЛЬЗОВАТЕЛЯМ СИСТЕМЫ ===\n";
+        result += "Дата создания: " + generatedAt.toString("dd.MM.yyyy hh:mm:ss").toUtf8() + "\n\n";
+        break;
+
+    case Format::Csv:
+        result += "login,role,created_at\n";
+        break;
+
+    case Format::Json: {
+        // Итоги известны заранее, поэтому пишутся перед массивом строк
+        result += "{\"generated_at\":" + jsonString(generatedAt.toString(Qt::ISODate));
+        result += ",\"total_users\":" + QByteArray::number(totals.totalUsers);
+        result += ",\"roles\":{";
+        for (int i = 0; i < totals.roleCounts.size(); ++i) {
+            if (i > 0) {
+                result += ',';
+            }
+            result += jsonString(totals.roleCounts.at(i).first) + ':'
+                      + QByteArray::number(totals.roleCounts.at(i).second);
+        }
+        result += "},\"users\":[";
+        break;
+    }
+    }
+
+    return result;
+}
+
+QByteArray ReportGenerator::footer(Format format, const Totals& totals) {
+    QByteArray result;
+
+    switch (format) {
+    case Format::Text:
+        result += "\n=== СТАТИСТИКА ===\n";
+        result += "Всего пользователей: " + QByteArray::number(totals.totalUsers) + "\n";
+        result += "Администраторов: " + QByteArray::number(totals.countOf("admin")) + "\n";
+        result += "Студентов: " + QByteArray::number(totals.countOf("student")) + "\n";
+        for (const auto& roleCount : totals.roleCounts) {
+            if (roleCount.first != "admin" && roleCount.first != "student") {
+                result += "Роль " + roleCount.first.toUtf8() + ": " + QByteArray::number(roleCount.second) + "\n";
+            }
+        }
+        result += "\n=== КОНЕЦ ОТЧЕТА ===\n";
+        break;
+
+    case Format::Csv:
+        break;
+
+    case Format::Json:
+        result += "\n]}\n";
+        break;
+    }
+
+    return result;
+}
+
+QByteArray ReportGenerator::formatRow(Format format, const QString& login, const QString& role,
+                                      const QDateTime& createdAt, bool first) {
+    switch (format) {
+    case Format::Csv:
+        return CsvUtils::field(login) + ',' + CsvUtils::field(role) + ','
+               + CsvUtils::field(formatDateTime(createdAt)) + '\n';
+
+    case Format::Json: {
+        QJsonObject user;
+        user.insert("login", login);
+        user.insert("role", role);
+        user.insert("created_at", formatDateTime(createdAt));
+        return (first ? "\n" : ",\n") + QJsonDocument(user).toJson(QJsonDocument::Compact);
+    }
+
+    default:
+        return "Логин: " + login.toUtf8() + " | Роль: " + role.toUtf8()
+               + " | Дата регистрации: " + formatDateTime(createdAt).toUtf8() + "\n";
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef REPORTGENERATOR_H
+#define REPORTGENERATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QThread>
+#include <QDateTime>
+#include <atomic>
+
+class QIODevice;
+class QSqlDatabase;
+class QSqlQuery;
+
+/**
+ * @brief Фоновое формирование отчета по пользователям.
+ * Отчет строится в отдельном потоке с собственным соединением из
+ * ConnectionPool. Итоги по ролям считаются на сервере (GROUP BY role),
+ * строки читаются курсором порциями по FETCH_SIZE и сразу записываются
+ * в буферизованный файл, поэтому расход памяти не зависит от числа
+ * пользователей. Итоги и строки читаются в одной транзакции
+ * REPEATABLE READ и согласованы между собой. В SQLite строки читаются
+ * forward-only запросом без курсора, снимок дает читающая транзакция.
+ *
+ * Файл записывается через QSaveFile: при ошибке или отмене
+ * частично записанный отчет не остается на диске.
+ */
+class ReportGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Формат файла отчета.
+     */
+    enum class Format {
+        Text,
+        Csv,
+        Json
+    };
+
+    // Строк, читаемых из курсора за один FETCH
+    static constexpr int FETCH_SIZE = 1000;
+
+    explicit ReportGenerator(QObject* parent = nullptr);
+
+    /**
+     * @brief Отменяет формирование отчета и дожидается завершения потока.
+     */
+    ~ReportGenerator() override;
+
+    /**
+     * @brief Запускает формирование отчета в фоновом потоке.
+     * @param filePath Путь к файлу отчета
+     * @param format Формат отчета
+     * @return false если отчет уже формируется
+     */
+    bool start(const QString& filePath, Format format);
+
+    /**
+     * @brief Запрашивает отмену; поток завершится после текущей порции строк.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Получает расширение файла для формата.
+     * @param format Формат отчета
+     * @return Расширение без точки
+     */
+    static QString fileExtension(Format format);
+
+signals:
+    /**
+     * @brief Сигнал о ходе формирования отчета.
+     * @param rowsWritten Записано строк
+     * @param totalRows Всего строк в отчете
+     */
+    void progress(qint64 rowsWritten, qint64 totalRows);
+
+    /**
+     * @brief Сигнал об успешном сохранении отчета.
+     * @param filePath Путь к файлу отчета
+     * @param totalRows Число пользователей в отчете
+     */
+    void finished(const QString& filePath, qint64 totalRows);
+
+    /**
+     * @brief Сигнал об ошибке формирования отчета.
+     * @param error Текст ошибки
+     */
+    void failed(const QString& error);
+
+    /**
+     * @brief Сигнал об отмене формирования отчета.
+     */
+    void canceled();
+
+private:
+    /**
+     * @brief Итоги по ролям, посчитанные на сервере.
+     */
+    struct Totals {
+        qint64 totalUsers;
+        QList<QPair<QString, qint64>> roleCounts;
+
+        Totals() : totalUsers(0) {}
+
+        qint64 countOf(const QString& role) const;
+    };
+
+    void run(const QString& filePath, Format format);
+    bool loadTotals(QSqlDatabase& database, Totals& totals, QString* errorMessage);
+    bool writeRows(QSqlDatabase& database, QIODevice& output, Format format,
+                   qint64 totalRows, QString* errorMessage);
+    bool writeRowsSequential(QSqlQuery& query, QIODevice& output, Format format,
+                             qint64 totalRows, QString* errorMessage);
+    static bool isSqlite(const QSqlDatabase& database);
+
+    static QByteArray header(Format format, const Totals& totals, const QDateTime& generatedAt);
+    static QByteArray footer(Format format, const Totals& totals);
+    static QByteArray formatRow(Format format, const QString& login, const QString& role,
+                                const QDateTime& createdAt, bool first);
+
+    QThread* m_thread;
+    std::atomic<bool> m_cancelRequested;
+};
+
+#endif // REPORTGENERATOR_H
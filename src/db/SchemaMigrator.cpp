@@ -0,0 +1,260 @@
+#include "db/SchemaMigrator.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+#include <algorithm>
+
+QString SchemaMigrator::migrationsDirectory() {
+    QString directory = QCoreApplication::applicationDirPath() + "/../data/migrations";
+    if (!QDir(directory).exists()) {
+        // Попытка альтернативного пути
+        directory = "data/migrations";
+    }
+    return directory;
+}
+
+QList<SchemaMigrator::Migration> SchemaMigrator::findMigrations(const QString& directory, QString* errorMessage) {
+    QList<Migration> migrations;
+
+    QDir dir(directory);
+    if (!dir.exists()) {
+        fail(errorMessage, QString("Migrations directory not found: %1").arg(directory));
+        return migrations;
+    }
+
+    static const QRegularExpression namePattern("^(\\d+)_(\\w+)\\.sql$");
+    const QStringList files = dir.entryList(QStringList() << "*.sql", QDir::Files, QDir::Name);
+
+    for (const QString& fileName : files) {
+        QRegularExpressionMatch match = namePattern.match(fileName);
+        if (!match.hasMatch()) {
+            qWarning() << "Skipping migration with unexpected file name:" << fileName;
+            continue;
+        }
+
+        Migration migration;
+        migration.version = match.captured(1).toInt();
+        migration.name = match.captured(2);
+        migration.filePath = dir.filePath(fileName);
+        migrations.append(migration);
+    }
+
+    std::sort(migrations.begin(), migrations.end(), [](const Migration& left, const Migration& right) {
+        return left.version < right.version;
+    });
+
+    for (int i = 1; i < migrations.size(); ++i) {
+        if (migrations.at(i).version == migrations.at(i - 1).version) {
+            fail(errorMessage, QString("Duplicate migration version %1").arg(migrations.at(i).version));
+            return QList<Migration>();
+        }
+    }
+
+    return migrations;
+}
+
+bool SchemaMigrator::migrate(QSqlDatabase& database, const QList<Migration>& migrations,
+                             Dialect dialect, QString* errorMessage) {
+    const int latestVersion = migrations.isEmpty() ? 0 : migrations.last().version;
+
+    // Быстрый путь: схема актуальна, достаточно одного запроса
+    int version = currentVersion(database, dialect, errorMessage);
+    if (version < 0) {
+        return false;
+    }
+    if (version >= latestVersion) {
+        if (version > latestVersion) {
+            qWarning() << "Database schema version" << version << "is newer than the application migrations" << latestVersion;
+        }
+        qDebug() << "Database schema is up to date, version" << version;
+        return true;
+    }
+
+    const bool useLock = (dialect == Dialect::PostgreSQL);
+    QSqlQuery query(database);
+    if (useLock && !query.exec(QString("SELECT pg_advisory_lock(%1)").arg(ADVISORY_LOCK_KEY))) {
+        fail(errorMessage, QString("Failed to lock schema migrations: %1").arg(query.lastError().text()));
+        return false;
+    }
+
+    bool ok = query.exec("CREATE TABLE IF NOT EXISTS schema_version ("
+                         "version INTEGER PRIMARY KEY, "
+                         "name TEXT NOT NULL, "
+                         "applied_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP)");
+    if (!ok) {
+        fail(errorMessage, QString("Failed to create schema_version table: %1").arg(query.lastError().text()));
+    }
+
+    // Пока ожидалась блокировка, миграции мог применить другой экземпляр
+    if (ok) {
+        version = currentVersion(database, dialect, errorMessage);
+        ok = version >= 0;
+    }
+
+    for (const Migration& migration : migrations) {
+        if (!ok) {
+            break;
+        }
+        if (migration.version > version) {
+            ok = applyMigration(database, migration, errorMessage);
+        }
+    }
+
+    if (useLock && !query.exec(QString("SELECT pg_advisory_unlock(%1)").arg(ADVISORY_LOCK_KEY))) {
+        qWarning() << "Failed to unlock schema migrations:" << query.lastError().text();
+    }
+
+    return ok;
+}
+
+int SchemaMigrator::currentVersion(QSqlDatabase& database, Dialect dialect, QString* errorMessage) {
+    // В SQLite список таблиц читается из локального файла без обращения к серверу
+    if (dialect == Dialect::SQLite && !database.tables().contains("schema_version")) {
+        return 0;
+    }
+
+    QSqlQuery query(database);
+    if (!query.exec("SELECT COALESCE(MAX(version), 0) FROM schema_version")) {
+        // undefined_table: база создана до появления миграций или пуста
+        if (query.lastError().nativeErrorCode() == "42P01") {
+            return 0;
+        }
+        fail(errorMessage, QString("Failed to read schema version: %1").arg(query.lastError().text()));
+        return -1;
+    }
+
+    return query.next() ? query.value(0).toInt() : 0;
+}
+
+bool SchemaMigrator::applyMigration(QSqlDatabase& database, const Migration& migration, QString* errorMessage) {
+    QFile file(migration.filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        fail(errorMessage, QString("Cannot open migration file: %1").arg(migration.filePath));
+        return false;
+    }
+    const QStringList statements = splitStatements(QString::fromUtf8(file.readAll()));
+    file.close();
+
+    if (!database.transaction()) {
+        fail(errorMessage, QString("Failed to start migration transaction: %1").arg(database.lastError().text()));
+        return false;
+    }
+
+    QSqlQuery query(database);
+    for (const QString& statement : statements) {
+        if (!query.exec(statement)) {
+            fail(errorMessage, QString("Migration %1 (%2) failed: %3")
+                                   .arg(migration.version).arg(migration.name, query.lastError().text()));
+            qDebug() << "Statement:" << statement;
+            database.rollback();
+            return false;
+        }
+    }
+
+    query.prepare("INSERT INTO schema_version (version, name) VALUES (?, ?)");
+    query.addBindValue(migration.version);
+    query.addBindValue(migration.name);
+    if (!query.exec()) {
+        fail(errorMessage, QString("Failed to record migration %1: %2").arg(migration.version).arg(query.lastError().text()));
+        database.rollback();
+        return false;
+    }
+
+    if (!database.commit()) {
+        fail(errorMessage, QString("Failed to commit migration %1: %2").arg(migration.version).arg(database.lastError().text()));
+        database.rollback();
+        return false;
+    }
+
+    qDebug() << "Applied database migration" << migration.version << migration.name;
+    return true;
+}
+
+QStringList SchemaMigrator::splitStatements(const QString& sql) {
+    static const QRegularExpression dollarTag("\\$([A-Za-z_][A-Za-z_0-9]*)?\\$");
+
+    QStringList statements;
+    QString current;
+    const qsizetype length = sql.size();
+    qsizetype i = 0;
+
+    auto flush = [&statements, &current]() {
+        const QString statement = current.trimmed();
+        if (!statement.isEmpty()) {
+            statements.append(statement);
+        }
+        current.clear();
+    };
+
+    while (i < length) {
+        const QChar c = sql.at(i);
+        const QChar next = (i + 1 < length) ? sql.at(i + 1) : QChar();
+
+        if (c == '-' && next == '-') {
+            // Строчный комментарий, перевод строки сохраняется
+            while (i < length && sql.at(i) != '\n') {
+                ++i;
+            }
+            continue;
+        }
+
+        if (c == '/' && next == '*') {
+            const qsizetype end = sql.indexOf("*/", i + 2);
+            i = (end < 0) ? length : end + 2;
+            current += ' ';
+            continue;
+        }
+
+        if (c == '\'' || c == '"') {
+            // Строка или идентификатор; удвоенная кавычка экранирует саму себя
+            qsizetype end = i + 1;
+            while (end < length) {
+                if (sql.at(end) == c) {
+                    if (end + 1 < length && sql.at(end + 1) == c) {
+                        end += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++end;
+            }
+            current += sql.mid(i, end - i + 1);
+            i = end + 1;
+            continue;
+        }
+
+        if (c == '$') {
+            QRegularExpressionMatch match = dollarTag.match(sql, i, QRegularExpression::NormalMatch,
+                                                            QRegularExpression::AnchorAtOffsetMatchOption);
+            if (match.hasMatch()) {
+                // $tag$ ... $tag$ (тела функций)
+                const QString tag = match.captured();
+                qsizetype end = sql.indexOf(tag, i + tag.size());
+                end = (end < 0) ? length : end + tag.size();
+                current += sql.mid(i, end - i);
+                i = end;
+                continue;
+            }
+        }
+
+        if (c == ';') {
+            flush();
+        } else {
+            current += c;
+        }
+        ++i;
+    }
+
+    flush();
+    return statements;
+}
+
+void SchemaMigrator::fail(QString* errorMessage, const QString& message) {
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+/**
+ * @brief Применение версионированных миграций схемы базы данных.
+ * Миграции - файлы data/migrations/NNNN_description.sql, применяются
+ * по возрастанию номера. Примененные версии записываются в таблицу
+ * schema_version. Каждая миграция выполняется в своей транзакции
+ * под advisory lock, поэтому несколько одновременно запущенных
+ * экземпляров приложения не применят миграцию дважды.
+ *
+ * Если схема актуальна, проверка выполняет один запрос
+ * SELECT MAX(version) FROM schema_version.
+ *
+ * Для SQLite advisory lock не используется: файл базы принадлежит
+ * одному экземпляру приложения, запись в нем и так выполняется по очереди.
+ */
+class SchemaMigrator
+{
+public:
+    /**
+     * @brief Диалект SQL базы данных.
+     */
+    enum class Dialect {
+        PostgreSQL,
+        SQLite
+    };
+
+    /**
+     * @brief Файл миграции.
+     */
+    struct Migration {
+        int version;
+        QString name;
+        QString filePath;
+
+        Migration() : version(0) {}
+    };
+
+    // Ключ pg_advisory_lock, общий для всех экземпляров приложения
+    static constexpr qint64 ADVISORY_LOCK_KEY = 0x436F7572736544;
+
+    /**
+     * @brief Находит каталог миграций рядом с приложением или в текущем каталоге.
+     * @return Путь к каталогу data/migrations
+     */
+    static QString migrationsDirectory();
+
+    /**
+     * @brief Находит файлы миграций в каталоге.
+     * @param directory Каталог миграций
+     * @param errorMessage Причина ошибки (может быть nullptr)
+     * @return Миграции по возрастанию версии; пустой список, если миграций нет
+     *         или номера версий повторяются
+     */
+    static QList<Migration> findMigrations(const QString& directory, QString* errorMessage = nullptr);
+
+    /**
+     * @brief Применяет миграции, версия которых больше текущей версии схемы.
+     * @param database Открытое соединение
+     * @param migrations Миграции по возрастанию версии
+     * @param dialect Диалект базы данных
+     * @param errorMessage Причина ошибки (может быть nullptr)
+     * @return true если схема актуальна
+     */
+    static bool migrate(QSqlDatabase& database, const QList<Migration>& migrations,
+                        Dialect dialect = Dialect::PostgreSQL, QString* errorMessage = nullptr);
+
+    /**
+     * @brief Получает текущую версию схемы.
+     * @param database Открытое соединение
+     * @param dialect Диалект базы данных
+     * @param errorMessage Причина ошибки (может быть nullptr)
+     * @return Версия схемы, 0 если миграции не применялись, -1 при ошибке
+     */
+    static int currentVersion(QSqlDatabase& database, Dialect dialect = Dialect::PostgreSQL,
+                              QString* errorMessage = nullptr);
+
+    /**
+     * @brief Делит SQL скрипт на отдельные операторы.
+     * Точки с запятой внутри строк, идентификаторов в кавычках,
+     * $$-строк и комментариев не считаются разделителями.
+     * @param sql Текст скрипта
+     * @return Операторы без завершающей точки с запятой
+     */
+    static QStringList splitStatements(const QString& sql);
+
+private:
+    static bool applyMigration(QSqlDatabase& database, const Migration& migration, QString* errorMessage);
+    static void fail(QString* errorMessage, const QString& message);
+};
+
+#endif // SCHEMAMIGRATOR_H
@@ -0,0 +1,492 @@
+#include "db/SqlStorage.h"
+#include <QSqlError>
+#include <QStringList>
+#include <QMap>
+#include <QDebug>
+
+QSqlQuery* SqlStorage::prepare(QSqlDatabase& database, StatementCache& statements,
+                               const QString& sql, QString* errorMessage) {
+    QString error;
+    QSqlQuery* query = statements.prepare(database, sql, &error);
+    if (!query) {
+        *errorMessage = QString("Failed to prepare query: %1").arg(error);
+    }
+    return query;
+}
+
+bool SqlStorage::registerUser(QSqlDatabase& database, StatementCache& statements, const QString& login,
+                              const QString& passwordHash, const QString& role, QString* errorMessage) {
+    const QString sql = "INSERT INTO users (login, password_hash, role) VALUES (?, ?, ?)";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return false;
+    }
+    query->bindValue(0, login);
+    query->bindValue(1, passwordHash);
+    query->bindValue(2, role);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to register user: %1").arg(query->lastError().text());
+        // После ошибки запрос готовится заново: сервер мог сбросить его план
+        statements.evict(sql);
+        return false;
+    }
+    return true;
+}
+
+UserCredentials SqlStorage::getCredentials(QSqlDatabase& database, StatementCache& statements,
+                                           const QString& login, QString* errorMessage) {
+    const QString sql = "SELECT id, role, password_hash FROM users WHERE login = ?";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return UserCredentials();
+    }
+    query->bindValue(0, login);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Authentication query failed: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return UserCredentials();
+    }
+
+    UserCredentials credentials;
+    if (query->next()) {
+        credentials.id = query->value(0).toInt();
+        credentials.role = query->value(1).toString();
+        credentials.passwordHash = query->value(2).toString();
+    }
+    query->finish();
+    return credentials;
+}
+
+bool SqlStorage::updatePasswordHash(QSqlDatabase& database, StatementCache& statements, int userId,
+                                    const QString& expectedHash, const QString& passwordHash,
+                                    QString* errorMessage) {
+    const QString sql = "UPDATE users SET password_hash = ? WHERE id = ? AND password_hash = ?";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return false;
+    }
+    query->bindValue(0, passwordHash);
+    query->bindValue(1, userId);
+    query->bindValue(2, expectedHash);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to update password hash: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return false;
+    }
+    return true;
+}
+
+bool SqlStorage::saveProgress(QSqlDatabase& database, StatementCache& statements,
+                              const ProgressUpdate& update, QString* errorMessage) {
+    // Одна вставка с обновлением при конфликте вместо SELECT + UPDATE/INSERT
+    const QString sql = "INSERT INTO study_progress (user_id, chapter_id, last_score, status) VALUES (?, ?, ?, ?) "
+                        "ON CONFLICT (user_id, chapter_id) DO UPDATE SET last_score = EXCLUDED.last_score, "
+                        "status = EXCLUDED.status, updated_at = CURRENT_TIMESTAMP";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return false;
+    }
+    query->bindValue(0, update.userId);
+    query->bindValue(1, update.chapterId);
+    query->bindValue(2, update.score);
+    query->bindValue(3, update.status);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to save progress: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return false;
+    }
+    return true;
+}
+
+bool SqlStorage::saveProgressBatch(QSqlDatabase& database, const QList<ProgressUpdate>& updates,
+                                   QString* errorMessage) {
+    if (updates.isEmpty()) {
+        return true;
+    }
+
+    if (!database.transaction()) {
+        *errorMessage = QString("Failed to start progress transaction: %1").arg(database.lastError().text());
+        return false;
+    }
+
+    // Пакет делится на части, чтобы не превысить лимит параметров запроса
+    const int batchSize = qMin(static_cast<int>(ProgressWriter::MAX_BATCH_SIZE), maxQueryParameters() / 4);
+    for (int first = 0; first < updates.size(); first += batchSize) {
+        const int count = qMin(batchSize, static_cast<int>(updates.size()) - first);
+
+        QString sql = "INSERT INTO study_progress (user_id, chapter_id, last_score, status) VALUES ";
+        for (int i = 0; i < count; ++i) {
+            sql += (i == 0) ? "(?, ?, ?, ?)" : ", (?, ?, ?, ?)";
+        }
+        sql += " ON CONFLICT (user_id, chapter_id) DO UPDATE SET last_score = EXCLUDED.last_score, "
+               "status = EXCLUDED.status, updated_at = CURRENT_TIMESTAMP";
+
+        QSqlQuery query(database);
+        query.prepare(sql);
+        for (int i = first; i < first + count; ++i) {
+            const ProgressUpdate& update = updates.at(i);
+            query.addBindValue(update.userId);
+            query.addBindValue(update.chapterId);
+            query.addBindValue(update.score);
+            query.addBindValue(update.status);
+        }
+
+        if (!query.exec()) {
+            *errorMessage = QString("Failed to save progress batch: %1").arg(query.lastError().text());
+            database.rollback();
+            return false;
+        }
+    }
+
+    if (!database.commit()) {
+        *errorMessage = QString("Failed to commit progress batch: %1").arg(database.lastError().text());
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+QPair<int, QString> SqlStorage::getLastProgress(QSqlDatabase& database, StatementCache& statements,
+                                                int userId, QString* errorMessage) {
+    const QString sql = "SELECT chapter_id, status FROM study_progress WHERE user_id = ? ORDER BY chapter_id DESC LIMIT 1";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return QPair<int, QString>(-1, QString());
+    }
+    query->bindValue(0, userId);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to get last progress: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return QPair<int, QString>(-1, QString());
+    }
+
+    // Прогресс не найден - возврат к первой главе
+    QPair<int, QString> result(0, QString("new"));
+    if (query->next()) {
+        result = QPair<int, QString>(query->value(0).toInt(), query->value(1).toString());
+    }
+    query->finish();
+    return result;
+}
+
+QList<QSqlRecord> SqlStorage::getUsersPage(QSqlDatabase& database, StatementCache& statements,
+                                           const UsersPageQuery& pageQuery, QString* errorMessage) {
+    QList<QSqlRecord> records;
+
+    // Имя столбца подставляется в текст запроса, поэтому допускаются только известные
+    static const QStringList sortColumns = {"id", "login", "role", "created_at"};
+    if (!sortColumns.contains(pageQuery.sortColumn)) {
+        *errorMessage = QString("Unsupported sort column: %1").arg(pageQuery.sortColumn);
+        return records;
+    }
+
+    const QString& column = pageQuery.sortColumn;
+    const QString direction = pageQuery.descending ? "DESC" : "ASC";
+    const QString comparison = pageQuery.descending ? "<" : ">";
+    // id и login уникальны; для остальных столбцов ключ дополняется id
+    const bool uniqueKey = (column == "id" || column == "login");
+
+    QStringList conditions;
+    if (!pageQuery.loginFilter.isEmpty()) {
+        // Обратная косая черта экранирует % и _ (в SQLite без ESCAPE экранирования нет)
+        conditions << QString("login %1 '%' || ? || '%' ESCAPE '\\'").arg(caseInsensitiveLike());
+    }
+    if (pageQuery.hasAfter) {
+        conditions << (uniqueKey ? QString("%1 %2 ?").arg(column, comparison)
+                                 : QString("(%1, id) %2 (?, ?)").arg(column, comparison));
+    }
+
+    // Ключ страницы для created_at выбирается текстом: PostgreSQL хранит
+    // микросекунды, а QDateTime - только миллисекунды, и округленная граница
+    // повторяла или пропускала строки (у пользователей одного импорта время
+    // создания совпадает, и следующая страница не сдвигалась вовсе)
+    const QString pageKey = (column == "created_at") ? QString("CAST(created_at AS TEXT)") : column;
+
+    QString sql = QString("SELECT id, login, password_hash, role, created_at, %1 AS page_key FROM users").arg(pageKey);
+    if (!conditions.isEmpty()) {
+        sql += " WHERE " + conditions.join(" AND ");
+    }
+    sql += uniqueKey ? QString(" ORDER BY %1 %2").arg(column, direction)
+                     : QString(" ORDER BY %1 %2, id %2").arg(column, direction);
+    sql += " LIMIT ?";
+
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return records;
+    }
+
+    int index = 0;
+    if (!pageQuery.loginFilter.isEmpty()) {
+        // Символы шаблона LIKE в тексте поиска ищутся буквально
+        QString pattern = pageQuery.loginFilter;
+        pattern.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+        query->bindValue(index++, pattern);
+    }
+    if (pageQuery.hasAfter) {
+        query->bindValue(index++, pageQuery.afterValue);
+        if (!uniqueKey) {
+            query->bindValue(index++, pageQuery.afterId);
+        }
+    }
+    query->bindValue(index, pageQuery.limit);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to load users page: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return records;
+    }
+
+    records.reserve(pageQuery.limit);
+    while (query->next()) {
+        records.append(query->record());
+    }
+    query->finish();
+    return records;
+}
+
+QSet<QString> SqlStorage::findExistingLogins(QSqlDatabase& database, const QStringList& logins,
+                                             QString* errorMessage) {
+    QSet<QString> existing;
+
+    // Список делится на запросы WHERE login IN (...) по лимиту параметров
+    const int batchSize = maxQueryParameters();
+    for (int first = 0; first < logins.size(); first += batchSize) {
+        const int count = qMin(batchSize, static_cast<int>(logins.size()) - first);
+
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        query.prepare("SELECT login FROM users WHERE login IN (" + QStringList(count, QStringLiteral("?")).join(", ") + ")");
+        for (int i = first; i < first + count; ++i) {
+            query.addBindValue(logins.at(i));
+        }
+
+        if (!query.exec()) {
+            *errorMessage = QString("Failed to check existing logins: %1").arg(query.lastError().text());
+            return QSet<QString>();
+        }
+        while (query.next()) {
+            existing.insert(query.value(0).toString());
+        }
+    }
+    return existing;
+}
+
+bool SqlStorage::importUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) {
+    if (users.isEmpty()) {
+        return true;
+    }
+
+    if (!database.transaction()) {
+        *errorMessage = QString("Failed to start import transaction: %1").arg(database.lastError().text());
+        return false;
+    }
+
+    if (!insertUsers(database, users, errorMessage)) {
+        database.rollback();
+        return false;
+    }
+
+    if (!database.commit()) {
+        *errorMessage = QString("Failed to commit imported users: %1").arg(database.lastError().text());
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool SqlStorage::insertUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) {
+    QList<QVariantList> rows;
+    rows.reserve(users.size());
+    for (const NewUser& user : users) {
+        rows.append(QVariantList{user.login, user.passwordHash, user.role});
+    }
+
+    return insertRows(database, "INSERT INTO users (login, password_hash, role) VALUES ", rows, QString(), errorMessage);
+}
+
+bool SqlStorage::saveAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                              QString* errorMessage) {
+    if (attempts.isEmpty()) {
+        return true;
+    }
+
+    if (!database.transaction()) {
+        *errorMessage = QString("Failed to start attempts transaction: %1").arg(database.lastError().text());
+        return false;
+    }
+
+    // Журнал и сводные таблицы меняются вместе: сводка не расходится с журналом
+    if (!insertAttempts(database, attempts, errorMessage) || !updateAttemptRollups(database, attempts, errorMessage)) {
+        database.rollback();
+        return false;
+    }
+
+    if (!database.commit()) {
+        *errorMessage = QString("Failed to commit attempts: %1").arg(database.lastError().text());
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool SqlStorage::insertAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                                QString* errorMessage) {
+    QList<QVariantList> rows;
+    rows.reserve(attempts.size());
+    for (const QuestionAttempt& attempt : attempts) {
+        const QVariant outcome = attempt.outcome.isEmpty() ? QVariant(QMetaType::fromType<QString>())
+                                                           : QVariant(attempt.outcome);
+        rows.append(QVariantList{attempt.userId, attempt.chapterId, attempt.questionIndex, attempt.chosenOption,
+                                 attempt.correct, attempt.latencyMs, outcome, attempt.answeredAt});
+    }
+
+    return insertRows(database,
+                      "INSERT INTO question_attempts (user_id, chapter_id, question_index, chosen_option, "
+                      "correct, latency_ms, outcome, answered_at) VALUES ",
+                      rows, QString(), errorMessage);
+}
+
+bool SqlStorage::updateAttemptRollups(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                                      QString* errorMessage) {
+    struct QuestionTotals {
+        qint64 attempts = 0;
+        qint64 correct = 0;
+        qint64 latencyMs = 0;
+    };
+
+    // Пакет сводится на клиенте: одна строка на вопрос и на главу.
+    // QMap упорядочивает ключи, поэтому параллельные сбросы блокируют
+    // строки сводки в одном порядке и не взаимоблокируются
+    QMap<QPair<int, int>, QuestionTotals> questions;
+    QMap<int, QPair<qint64, qint64>> chapters;
+    for (const QuestionAttempt& attempt : attempts) {
+        QuestionTotals& totals = questions[qMakePair(attempt.chapterId, attempt.questionIndex)];
+        totals.attempts++;
+        totals.correct += attempt.correct ? 1 : 0;
+        totals.latencyMs += attempt.latencyMs;
+
+        if (attempt.outcome == "passed") {
+            chapters[attempt.chapterId].first++;
+        } else if (attempt.outcome == "failed") {
+            chapters[attempt.chapterId].second++;
+        }
+    }
+
+    QList<QVariantList> questionRows;
+    for (auto it = questions.constBegin(); it != questions.constEnd(); ++it) {
+        questionRows.append(QVariantList{it.key().first, it.key().second, it.value().attempts,
+                                         it.value().correct, it.value().latencyMs});
+    }
+    if (!insertRows(database,
+                    "INSERT INTO question_stats (chapter_id, question_index, attempts, correct, total_latency_ms) VALUES ",
+                    questionRows,
+                    " ON CONFLICT (chapter_id, question_index) DO UPDATE SET "
+                    "attempts = question_stats.attempts + EXCLUDED.attempts, "
+                    "correct = question_stats.correct + EXCLUDED.correct, "
+                    "total_latency_ms = question_stats.total_latency_ms + EXCLUDED.total_latency_ms",
+                    errorMessage)) {
+        return false;
+    }
+
+    QList<QVariantList> chapterRows;
+    for (auto it = chapters.constBegin(); it != chapters.constEnd(); ++it) {
+        chapterRows.append(QVariantList{it.key(), it.value().first, it.value().second});
+    }
+    return insertRows(database, "INSERT INTO chapter_stats (chapter_id, tests_passed, tests_failed) VALUES ",
+                      chapterRows,
+                      " ON CONFLICT (chapter_id) DO UPDATE SET "
+                      "tests_passed = chapter_stats.tests_passed + EXCLUDED.tests_passed, "
+                      "tests_failed = chapter_stats.tests_failed + EXCLUDED.tests_failed",
+                      errorMessage);
+}
+
+bool SqlStorage::insertRows(QSqlDatabase& database, const QString& head, const QList<QVariantList>& rows,
+                            const QString& tail, QString* errorMessage) {
+    if (rows.isEmpty()) {
+        return true;
+    }
+
+    const int columns = static_cast<int>(rows.first().size());
+    const QString placeholders = "(" + QStringList(columns, QStringLiteral("?")).join(", ") + ")";
+    const int batchSize = qMax(1, maxQueryParameters() / columns);
+
+    for (int first = 0; first < rows.size(); first += batchSize) {
+        const int count = qMin(batchSize, static_cast<int>(rows.size()) - first);
+
+        QString sql = head;
+        for (int i = 0; i < count; ++i) {
+            if (i > 0) {
+                sql += ", ";
+            }
+            sql += placeholders;
+        }
+        sql += tail;
+
+        QSqlQuery query(database);
+        query.prepare(sql);
+        for (int i = first; i < first + count; ++i) {
+            for (const QVariant& value : rows.at(i)) {
+                query.addBindValue(value);
+            }
+        }
+
+        if (!query.exec()) {
+            *errorMessage = QString("Failed to insert rows: %1").arg(query.lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+QList<QSqlRecord> SqlStorage::getQuestionStats(QSqlDatabase& database, StatementCache& statements,
+                                               int chapterId, QString* errorMessage) {
+    QList<QSqlRecord> records;
+
+    const QString sql = "SELECT question_index, attempts, correct, total_latency_ms / attempts AS avg_latency_ms "
+                        "FROM question_stats WHERE chapter_id = ? ORDER BY question_index";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return records;
+    }
+    query->bindValue(0, chapterId);
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to load question statistics: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return records;
+    }
+
+    while (query->next()) {
+        records.append(query->record());
+    }
+    query->finish();
+    return records;
+}
+
+QList<QSqlRecord> SqlStorage::getChapterStats(QSqlDatabase& database, StatementCache& statements,
+                                              QString* errorMessage) {
+    QList<QSqlRecord> records;
+
+    const QString sql = "SELECT chapter_id, tests_passed, tests_failed FROM chapter_stats ORDER BY chapter_id";
+    QSqlQuery* query = prepare(database, statements, sql, errorMessage);
+    if (!query) {
+        return records;
+    }
+
+    if (!query->exec()) {
+        *errorMessage = QString("Failed to load chapter statistics: %1").arg(query->lastError().text());
+        statements.evict(sql);
+        return records;
+    }
+
+    while (query->next()) {
+        records.append(query->record());
+    }
+    query->finish();
+    return records;
+}
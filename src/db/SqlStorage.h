@@ -0,0 +1,98 @@
+#ifndef SQLSTORAGE_H
+#define SQLSTORAGE_H
+
+#include "db/Storage.h"
+#include <QSqlQuery>
+
+/**
+ * @brief Общая реализация Storage на SQL, понятном PostgreSQL и SQLite
+ * (INSERT ... ON CONFLICT DO UPDATE, сравнение кортежей, LIMIT).
+ * Наследники задают параметры подключения, схему и различия диалектов.
+ */
+class SqlStorage : public Storage
+{
+public:
+    bool registerUser(QSqlDatabase& database, StatementCache& statements, const QString& login,
+                      const QString& passwordHash, const QString& role, QString* errorMessage) override;
+
+    UserCredentials getCredentials(QSqlDatabase& database, StatementCache& statements,
+                                   const QString& login, QString* errorMessage) override;
+
+    bool updatePasswordHash(QSqlDatabase& database, StatementCache& statements, int userId,
+                            const QString& expectedHash, const QString& passwordHash,
+                            QString* errorMessage) override;
+
+    bool saveProgress(QSqlDatabase& database, StatementCache& statements,
+                      const ProgressUpdate& update, QString* errorMessage) override;
+
+    bool saveProgressBatch(QSqlDatabase& database, const QList<ProgressUpdate>& updates,
+                           QString* errorMessage) override;
+
+    QPair<int, QString> getLastProgress(QSqlDatabase& database, StatementCache& statements,
+                                        int userId, QString* errorMessage) override;
+
+    QList<QSqlRecord> getUsersPage(QSqlDatabase& database, StatementCache& statements,
+                                   const UsersPageQuery& pageQuery, QString* errorMessage) override;
+
+    QSet<QString> findExistingLogins(QSqlDatabase& database, const QStringList& logins,
+                                     QString* errorMessage) override;
+
+    bool importUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) override;
+
+    bool saveAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                      QString* errorMessage) override;
+
+    QList<QSqlRecord> getQuestionStats(QSqlDatabase& database, StatementCache& statements,
+                                       int chapterId, QString* errorMessage) override;
+
+    QList<QSqlRecord> getChapterStats(QSqlDatabase& database, StatementCache& statements,
+                                      QString* errorMessage) override;
+
+protected:
+    /**
+     * @brief Оператор поиска подстроки без учета регистра.
+     * @return LIKE или ILIKE
+     */
+    virtual QString caseInsensitiveLike() const = 0;
+
+    /**
+     * @brief Максимальное число параметров одного запроса в СУБД.
+     * Ограничивает число строк в многострочном INSERT.
+     * @return Число параметров
+     */
+    virtual int maxQueryParameters() const = 0;
+
+    /**
+     * @brief Добавляет пользователей в таблицу users в открытой транзакции.
+     * По умолчанию - многострочными INSERT.
+     * @return true если все пользователи добавлены
+     */
+    virtual bool insertUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage);
+
+    /**
+     * @brief Записывает ответы в журнал question_attempts в открытой транзакции.
+     * По умолчанию - многострочными INSERT.
+     * @return true если все ответы записаны
+     */
+    virtual bool insertAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                                QString* errorMessage);
+
+    /**
+     * @brief Выполняет многострочный INSERT, разбивая строки на запросы
+     * по лимиту параметров СУБД.
+     * @param head Начало запроса до VALUES включительно
+     * @param rows Значения строк, у всех строк одинаковое число столбцов
+     * @param tail Окончание запроса после списка строк (ON CONFLICT ...)
+     * @return true если все строки записаны
+     */
+    bool insertRows(QSqlDatabase& database, const QString& head, const QList<QVariantList>& rows,
+                    const QString& tail, QString* errorMessage);
+
+private:
+    static QSqlQuery* prepare(QSqlDatabase& database, StatementCache& statements,
+                              const QString& sql, QString* errorMessage);
+    bool updateAttemptRollups(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                              QString* errorMessage);
+};
+
+#endif // SQLSTORAGE_H
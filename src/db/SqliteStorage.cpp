@@ -0,0 +1,68 @@
+#include "db/SqliteStorage.h"
+#include "db/SchemaMigrator.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+Storage::Backend SqliteStorage::backend() const {
+    return Backend::SQLite;
+}
+
+QString SqliteStorage::description() const {
+    return QString("SQLite database %1").arg(databasePath());
+}
+
+QString SqliteStorage::databasePath() {
+    QString path = qEnvironmentVariable("COURSE_DB_PATH");
+    if (path.isEmpty()) {
+        path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/course.sqlite";
+    }
+    return path;
+}
+
+ConnectionPool::Settings SqliteStorage::connectionSettings() const {
+    const QString path = databasePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    ConnectionPool::Settings settings;
+    settings.driver = "QSQLITE";
+    settings.databaseName = path;
+    // Соединения локальные: проверять их перед выдачей не нужно
+    settings.healthCheckIntervalMs = settings.idleTimeoutMs;
+    settings.initStatements = QStringList{
+        // Журнал WAL: запись не блокирует чтение, fsync только при checkpoint
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA foreign_keys = ON",
+        // Ожидание блокировки записи другим соединением вместо ошибки SQLITE_BUSY
+        "PRAGMA busy_timeout = 5000",
+        "PRAGMA temp_store = MEMORY",
+        "PRAGMA cache_size = -16000",
+        "PRAGMA mmap_size = 268435456"
+    };
+    return settings;
+}
+
+bool SqliteStorage::initSchema(QSqlDatabase& database, QString* errorMessage) {
+    const QList<SchemaMigrator::Migration> migrations =
+        SchemaMigrator::findMigrations(SchemaMigrator::migrationsDirectory() + "/sqlite", errorMessage);
+
+    if (migrations.isEmpty()) {
+        if (errorMessage->isEmpty()) {
+            *errorMessage = "No SQLite schema migrations found";
+        }
+        return false;
+    }
+
+    return SchemaMigrator::migrate(database, migrations, SchemaMigrator::Dialect::SQLite, errorMessage);
+}
+
+QString SqliteStorage::caseInsensitiveLike() const {
+    // LIKE в SQLite не учитывает регистр латинских букв
+    return "LIKE";
+}
+
+int SqliteStorage::maxQueryParameters() const {
+    // Старые сборки SQLite ограничивают запрос 999 параметрами
+    return 999;
+}
@@ -0,0 +1,34 @@
+#ifndef SQLITESTORAGE_H
+#define SQLITESTORAGE_H
+
+#include "db/SqlStorage.h"
+
+/**
+ * @brief Хранилище в локальном файле SQLite (драйвер QSQLITE) для
+ * установок без сервера PostgreSQL.
+ * Файл задается переменной окружения COURSE_DB_PATH, по умолчанию
+ * course.sqlite в каталоге данных приложения. Соединения открываются
+ * в режиме WAL: читатели не блокируют запись прогресса.
+ * Схема создается миграциями data/migrations/sqlite с теми же номерами
+ * версий, что и для PostgreSQL.
+ */
+class SqliteStorage : public SqlStorage
+{
+public:
+    Backend backend() const override;
+    QString description() const override;
+    ConnectionPool::Settings connectionSettings() const override;
+    bool initSchema(QSqlDatabase& database, QString* errorMessage) override;
+
+    /**
+     * @brief Получает путь к файлу базы данных.
+     * @return Путь из COURSE_DB_PATH или путь по умолчанию
+     */
+    static QString databasePath();
+
+protected:
+    QString caseInsensitiveLike() const override;
+    int maxQueryParameters() const override;
+};
+
+#endif // SQLITESTORAGE_H
@@ -0,0 +1,74 @@
+#include "db/StatementCache.h"
+#include <QSqlError>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+// Счетчики общие для всех потоков и соединений
+QMutex statisticsMutex;
+QHash<QString, StatementCache::Statistics> statisticsBySql;
+
+} // namespace
+
+StatementCache::~StatementCache() {
+    clear();
+}
+
+QSqlQuery* StatementCache::prepare(const QSqlDatabase& database, const QString& sql, QString* errorMessage) {
+    // Подготовленные запросы другого соединения здесь недействительны
+    if (database.connectionName() != m_connectionName) {
+        clear();
+        m_connectionName = database.connectionName();
+    }
+
+    auto it = m_queries.find(sql);
+    if (it != m_queries.end()) {
+        // Результат предыдущего выполнения освобождается, подготовленный запрос остается
+        it->finish();
+        record(sql, true);
+        return &it.value();
+    }
+
+    QSqlQuery query(database);
+    if (!query.prepare(sql)) {
+        if (errorMessage) {
+            *errorMessage = query.lastError().text();
+        }
+        return nullptr;
+    }
+
+    record(sql, false);
+    return &m_queries.insert(sql, query).value();
+}
+
+void StatementCache::evict(const QString& sql) {
+    m_queries.remove(sql);
+}
+
+void StatementCache::clear() {
+    m_queries.clear();
+    m_connectionName.clear();
+}
+
+int StatementCache::size() const {
+    return static_cast<int>(m_queries.size());
+}
+
+QList<StatementCache::Statistics> StatementCache::statistics() {
+    QMutexLocker locker(&statisticsMutex);
+    return statisticsBySql.values();
+}
+
+void StatementCache::record(const QString& sql, bool hit) {
+    QMutexLocker locker(&statisticsMutex);
+    Statistics& statistics = statisticsBySql[sql];
+    if (statistics.sql.isEmpty()) {
+        statistics.sql = sql;
+    }
+    if (hit) {
+        statistics.hits++;
+    } else {
+        statistics.misses++;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef STATEMENTCACHE_H
+#define STATEMENTCACHE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QHash>
+#include <QList>
+
+/**
+ * @brief Кэш подготовленных запросов одного соединения.
+ * Запрос готовится (prepare) на сервере один раз и повторно используется
+ * при следующих вызовах с тем же текстом SQL. Кэш привязан к имени
+ * соединения: при смене соединения и при переподключении он очищается,
+ * поскольку подготовленные на сервере запросы живут только в своей сессии.
+ *
+ * Экземпляр используется только в потоке своего соединения.
+ * Счетчики попаданий и промахов общие для всех соединений процесса.
+ */
+class StatementCache
+{
+public:
+    /**
+     * @brief Счетчики обращений к кэшу для одного текста SQL.
+     */
+    struct Statistics {
+        QString sql;
+        quint64 hits;
+        quint64 misses;
+
+        Statistics() : hits(0), misses(0) {}
+    };
+
+    StatementCache() = default;
+    ~StatementCache();
+
+    /**
+     * @brief Получает подготовленный запрос для соединения.
+     * При попадании возвращает ранее подготовленный запрос без обращения
+     * к серверу; значения параметров задаются через bindValue(index, value).
+     * @param database Соединение, в котором выполняется запрос
+     * @param sql Текст запроса с параметрами ?
+     * @param errorMessage Причина ошибки подготовки (может быть nullptr)
+     * @return Запрос, принадлежащий кэшу (действителен до следующего вызова),
+     *         или nullptr при ошибке подготовки
+     */
+    QSqlQuery* prepare(const QSqlDatabase& database, const QString& sql, QString* errorMessage = nullptr);
+
+    /**
+     * @brief Удаляет подготовленный запрос, например после ошибки выполнения.
+     * @param sql Текст запроса
+     */
+    void evict(const QString& sql);
+
+    /**
+     * @brief Удаляет все подготовленные запросы.
+     * Вызывается до закрытия соединения.
+     */
+    void clear();
+
+    int size() const;
+
+    /**
+     * @brief Получает счетчики попаданий и промахов по всем соединениям.
+     * @return Счетчики для каждого текста SQL
+     */
+    static QList<Statistics> statistics();
+
+private:
+    Q_DISABLE_COPY(StatementCache)
+
+    static void record(const QString& sql, bool hit);
+
+    QString m_connectionName;
+    QHash<QString, QSqlQuery> m_queries;
+};
+
+#endif // STATEMENTCACHE_H
@@ -0,0 +1,22 @@
+#include "db/Storage.h"
+#include "db/PostgresStorage.h"
+#include "db/SqliteStorage.h"
+#include <QDebug>
+
+std::unique_ptr<Storage> Storage::create(Backend backend) {
+    if (backend == Backend::SQLite) {
+        return std::make_unique<SqliteStorage>();
+    }
+    return std::make_unique<PostgresStorage>();
+}
+
+Storage::Backend Storage::configuredBackend() {
+    const QString backend = qEnvironmentVariable("COURSE_DB_BACKEND").trimmed().toLower();
+    if (backend == "sqlite") {
+        return Backend::SQLite;
+    }
+    if (!backend.isEmpty() && backend != "postgres" && backend != "postgresql") {
+        qWarning() << "Unknown COURSE_DB_BACKEND" << backend << "- using PostgreSQL";
+    }
+    return Backend::PostgreSQL;
+}
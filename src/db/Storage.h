@@ -0,0 +1,209 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <QSqlDatabase>
+#include <QSqlRecord>
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QVariant>
+#include <QSet>
+#include <QStringList>
+#include <memory>
+#include "db/ConnectionPool.h"
+#include "db/StatementCache.h"
+#include "db/ProgressWriter.h"
+#include "db/AttemptWriter.h"
+
+/**
+ * @brief Параметры выборки одной страницы таблицы users (keyset-пагинация).
+ * Страница начинается после строки с ключом (afterValue, afterId) в порядке
+ * сортировки sortColumn; для первой страницы hasAfter == false.
+ * afterValue - значение page_key последней строки предыдущей страницы.
+ */
+struct UsersPageQuery {
+    QString sortColumn;
+    bool descending;
+    bool hasAfter;
+    QVariant afterValue;
+    int afterId;
+    int limit;
+    QString loginFilter;
+
+    UsersPageQuery() : sortColumn("id"), descending(false), hasAfter(false), afterId(0), limit(100) {}
+};
+
+/**
+ * @brief Учетные данные пользователя для проверки пароля.
+ * id == -1, если пользователь не найден.
+ */
+struct UserCredentials {
+    int id;
+    QString role;
+    QString passwordHash;
+
+    UserCredentials() : id(-1) {}
+};
+
+/**
+ * @brief Пользователь для пакетного добавления (импорт из CSV).
+ */
+struct NewUser {
+    QString login;
+    QString passwordHash;
+    QString role;
+};
+
+/**
+ * @brief Хранилище пользователей и прогресса обучения.
+ * Скрывает от DatabaseManager SQL диалект и параметры подключения
+ * конкретной СУБД. Реализации: PostgresStorage (сервер PostgreSQL)
+ * и SqliteStorage (локальный файл для установок без сервера).
+ *
+ * Методы не хранят состояние между вызовами: соединение и кэш
+ * подготовленных запросов вызывающего потока передаются параметрами.
+ * Ошибка сообщается через errorMessage; пустая строка - успех.
+ */
+class Storage
+{
+public:
+    /**
+     * @brief Тип хранилища.
+     */
+    enum class Backend {
+        PostgreSQL,
+        SQLite
+    };
+
+    virtual ~Storage() = default;
+
+    /**
+     * @brief Создает хранилище указанного типа.
+     * @param backend Тип хранилища
+     * @return Хранилище
+     */
+    static std::unique_ptr<Storage> create(Backend backend);
+
+    /**
+     * @brief Определяет тип хранилища из переменной окружения
+     * COURSE_DB_BACKEND (postgres или sqlite, по умолчанию postgres).
+     * @return Тип хранилища
+     */
+    static Backend configuredBackend();
+
+    virtual Backend backend() const = 0;
+
+    /**
+     * @brief Получает название хранилища для журнала.
+     * @return Название СУБД и база данных
+     */
+    virtual QString description() const = 0;
+
+    /**
+     * @brief Получает параметры подключения для пула и соединения по умолчанию.
+     * @return Параметры подключения
+     */
+    virtual ConnectionPool::Settings connectionSettings() const = 0;
+
+    /**
+     * @brief Создает или обновляет схему базы данных.
+     * @param database Открытое соединение
+     * @param errorMessage Причина ошибки
+     * @return true если схема актуальна
+     */
+    virtual bool initSchema(QSqlDatabase& database, QString* errorMessage) = 0;
+
+    /**
+     * @brief Добавляет пользователя.
+     * @return true если пользователь добавлен
+     */
+    virtual bool registerUser(QSqlDatabase& database, StatementCache& statements, const QString& login,
+                              const QString& passwordHash, const QString& role, QString* errorMessage) = 0;
+
+    /**
+     * @brief Получает ID, роль и хеш пароля по логину.
+     * Пароль проверяется на клиенте: хеш с солью нельзя искать по значению.
+     * @return Учетные данные; id == -1, если пользователь не найден
+     */
+    virtual UserCredentials getCredentials(QSqlDatabase& database, StatementCache& statements,
+                                           const QString& login, QString* errorMessage) = 0;
+
+    /**
+     * @brief Заменяет хеш пароля пользователя (переход на новую стоимость).
+     * @param expectedHash Прежний хеш; замена не выполняется, если пароль
+     * успели сменить
+     * @return true если запрос выполнен
+     */
+    virtual bool updatePasswordHash(QSqlDatabase& database, StatementCache& statements, int userId,
+                                    const QString& expectedHash, const QString& passwordHash,
+                                    QString* errorMessage) = 0;
+
+    /**
+     * @brief Сохраняет прогресс по одной главе (вставка или обновление).
+     * @return true если прогресс сохранен
+     */
+    virtual bool saveProgress(QSqlDatabase& database, StatementCache& statements,
+                              const ProgressUpdate& update, QString* errorMessage) = 0;
+
+    /**
+     * @brief Сохраняет пакет изменений прогресса в одной транзакции.
+     * Каждая пара (user_id, chapter_id) должна встречаться в пакете один раз.
+     * @return true если весь пакет сохранен
+     */
+    virtual bool saveProgressBatch(QSqlDatabase& database, const QList<ProgressUpdate>& updates,
+                                   QString* errorMessage) = 0;
+
+    /**
+     * @brief Получает последнюю главу, по которой есть прогресс.
+     * @return Пара (ID главы, статус); (0, "new") если прогресса нет, -1 при ошибке
+     */
+    virtual QPair<int, QString> getLastProgress(QSqlDatabase& database, StatementCache& statements,
+                                                int userId, QString* errorMessage) = 0;
+
+    /**
+     * @brief Получает одну страницу таблицы users.
+     * @return Строки (id, login, password_hash, role, created_at, page_key);
+     * page_key - точное значение столбца сортировки для начала следующей страницы
+     */
+    virtual QList<QSqlRecord> getUsersPage(QSqlDatabase& database, StatementCache& statements,
+                                           const UsersPageQuery& pageQuery, QString* errorMessage) = 0;
+
+    /**
+     * @brief Ищет уже зарегистрированные логины.
+     * @param logins Проверяемые логины
+     * @return Логины из списка, которые есть в таблице users
+     */
+    virtual QSet<QString> findExistingLogins(QSqlDatabase& database, const QStringList& logins,
+                                             QString* errorMessage) = 0;
+
+    /**
+     * @brief Добавляет пакет пользователей в одной транзакции.
+     * При любой ошибке (например, логин занят) не добавляется ни один.
+     * @return true если добавлены все пользователи
+     */
+    virtual bool importUsers(QSqlDatabase& database, const QList<NewUser>& users, QString* errorMessage) = 0;
+
+    /**
+     * @brief Записывает ответы в журнал и обновляет сводные таблицы
+     * question_stats и chapter_stats в одной транзакции.
+     * @return true если весь пакет сохранен
+     */
+    virtual bool saveAttempts(QSqlDatabase& database, const QList<QuestionAttempt>& attempts,
+                              QString* errorMessage) = 0;
+
+    /**
+     * @brief Получает сводку по вопросам главы из question_stats.
+     * @return Строки (question_index, attempts, correct, avg_latency_ms)
+     */
+    virtual QList<QSqlRecord> getQuestionStats(QSqlDatabase& database, StatementCache& statements,
+                                               int chapterId, QString* errorMessage) = 0;
+
+    /**
+     * @brief Получает сводку по главам из chapter_stats.
+     * @return Строки (chapter_id, tests_passed, tests_failed)
+     */
+    virtual QList<QSqlRecord> getChapterStats(QSqlDatabase& database, StatementCache& statements,
+                                              QString* errorMessage) = 0;
+};
+
+#endif // STORAGE_H
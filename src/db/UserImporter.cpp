@@ -0,0 +1,256 @@
+#include "db/UserImporter.h"
+#include "db/DatabaseManager.h"
+#include "db/CsvUtils.h"
+#include "core/CryptoUtils.h"
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentMap>
+
+UserImporter::UserImporter(QObject* parent)
+    : QObject(parent), m_thread(nullptr), m_cancelRequested(false) {
+}
+
+UserImporter::~UserImporter() {
+    cancel();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool UserImporter::start(const QString& filePath) {
+    if (isRunning()) {
+        return false;
+    }
+
+    delete m_thread;
+    m_cancelRequested = false;
+
+    m_thread = QThread::create([this, filePath]() {
+        run(filePath);
+    });
+    m_thread->setObjectName("UserImporter");
+    m_thread->start();
+    return true;
+}
+
+void UserImporter::cancel() {
+    m_cancelRequested = true;
+}
+
+bool UserImporter::isRunning() const {
+    return m_thread && m_thread->isRunning();
+}
+
+QString UserImporter::errorReportPath(const QString& filePath) {
+    QFileInfo info(filePath);
+    return info.dir().filePath(info.completeBaseName() + ".errors.csv");
+}
+
+void UserImporter::run(const QString& filePath) {
+    // Импорт не занимает рабочий поток DatabaseManager: у потока импорта свое соединение
+    ConnectionPool::Connection connection = DatabaseManager::getInstance().connectionPool().acquire();
+    if (!connection.isValid()) {
+        emit failed(connection.errorString());
+        return;
+    }
+
+    const Result result = importFile(filePath);
+    if (result.canceled) {
+        emit canceled();
+    } else if (!result.error.isEmpty()) {
+        emit failed(result.rejected.isEmpty()
+                        ? result.error
+                        : QString("%1\nRejected rows: %2").arg(result.error, errorReportPath(filePath)));
+    } else {
+        emit finished(result.imported, result.rejected.size(),
+                      result.rejected.isEmpty() ? QString() : errorReportPath(filePath));
+    }
+}
+
+UserImporter::Result UserImporter::importFile(const QString& filePath) {
+    Result result;
+    DatabaseManager& db = DatabaseManager::getInstance();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<Row> rows;
+    if (!readRows(filePath, rows, result)) {
+        return result;
+    }
+
+    // Занятые логины отсеиваются до хеширования: на них не тратится время
+    QStringList logins;
+    logins.reserve(rows.size());
+    for (const Row& row : rows) {
+        logins.append(row.login);
+    }
+
+    const QSet<QString> existing = db.findExistingLogins(logins);
+    if (!db.getLastError().isEmpty()) {
+        result.error = db.getLastError();
+        saveErrorReport(filePath, result);
+        return result;
+    }
+
+    QList<Row> accepted;
+    accepted.reserve(rows.size());
+    for (Row& row : rows) {
+        if (existing.contains(row.login)) {
+            result.rejected.append({row.line, row.login, "Login is already registered"});
+        } else {
+            accepted.append(std::move(row));
+        }
+    }
+    rows.clear();
+
+    // Пароли хешируются параллельно порциями по HASH_CHUNK_SIZE строк;
+    // каждая порция пишет только в свои элементы users
+    const qint64 total = accepted.size();
+    QList<NewUser> users(accepted.size());
+    QList<QPair<int, int>> chunks;
+    for (int first = 0; first < accepted.size(); first += HASH_CHUNK_SIZE) {
+        chunks.append(qMakePair(first, qMin(first + HASH_CHUNK_SIZE, static_cast<int>(accepted.size()))));
+    }
+
+    std::atomic<qint64> hashed(0);
+    QtConcurrent::blockingMap(chunks, [&](const QPair<int, int>& chunk) {
+        if (m_cancelRequested) {
+            return;
+        }
+        for (int i = chunk.first; i < chunk.second; ++i) {
+            NewUser& user = users[i];
+            user.login = accepted.at(i).login;
+            user.passwordHash = CryptoUtils::hashPassword(accepted.at(i).password);
+            user.role = accepted.at(i).role;
+        }
+        emit progress(hashed += chunk.second - chunk.first, total);
+    });
+
+    // Открытые пароли больше не нужны
+    accepted.clear();
+
+    if (m_cancelRequested) {
+        result.canceled = true;
+        return result;
+    }
+
+    // Отчет пишется и при ошибке транзакции (например, логин заняли после
+    // проверки): строки, отклоненные при проверке, не теряются
+    if (!users.isEmpty() && !db.importUsers(users)) {
+        result.error = db.getLastError();
+        saveErrorReport(filePath, result);
+        return result;
+    }
+    result.imported = users.size();
+    saveErrorReport(filePath, result);
+
+    qDebug() << "User import:" << result.imported << "imported," << result.rejected.size() << "rejected of"
+             << result.rowsRead << "rows in" << timer.elapsed() << "ms";
+    return result;
+}
+
+bool UserImporter::readRows(const QString& filePath, QList<Row>& rows, Result& result) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        result.error = QString("Cannot open import file: %1").arg(file.errorString());
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream.setEncoding(QStringConverter::Utf8);
+
+    // Столбцы определяются по заголовку
+    QStringList header = CsvUtils::splitLine(stream.readLine());
+    for (QString& column : header) {
+        column = column.trimmed().toLower();
+    }
+    const int loginColumn = header.indexOf("login");
+    const int passwordColumn = header.indexOf("password");
+    const int roleColumn = header.indexOf("role");
+    if (loginColumn < 0 || passwordColumn < 0) {
+        result.error = "Import file must start with a header containing login and password columns";
+        return false;
+    }
+
+    static const QStringList roles = {"student", "admin"};
+    // Первая строка с каждым логином; повторы отклоняются
+    QHash<QString, int> seenLogins;
+    int lineNumber = 1;
+
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine();
+        lineNumber++;
+        if (line.trimmed().isEmpty()) {
+            continue;
+        }
+        result.rowsRead++;
+
+        const QStringList fields = CsvUtils::splitLine(line);
+        Row row;
+        row.line = lineNumber;
+        row.login = fields.value(loginColumn).trimmed();
+        row.password = fields.value(passwordColumn);
+        row.role = roleColumn >= 0 ? fields.value(roleColumn).trimmed() : QString();
+        if (row.role.isEmpty()) {
+            row.role = "student";
+        }
+
+        QString error;
+        if (row.login.isEmpty()) {
+            error = "Login is empty";
+        } else if (row.password.length() < MIN_PASSWORD_LENGTH) {
+            error = QString("Password is shorter than %1 characters").arg(MIN_PASSWORD_LENGTH);
+        } else if (!roles.contains(row.role)) {
+            error = QString("Unknown role: %1").arg(row.role);
+        } else if (seenLogins.contains(row.login)) {
+            error = QString("Duplicate login, first seen on line %1").arg(seenLogins.value(row.login));
+        }
+
+        if (!error.isEmpty()) {
+            result.rejected.append({row.line, row.login, error});
+            continue;
+        }
+
+        seenLogins.insert(row.login, row.line);
+        rows.append(std::move(row));
+    }
+    return true;
+}
+
+void UserImporter::saveErrorReport(const QString& filePath, const Result& result) {
+    if (result.rejected.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!writeErrorReport(errorReportPath(filePath), result.rejected, &error)) {
+        qWarning() << "User import:" << error;
+    }
+}
+
+bool UserImporter::writeErrorReport(const QString& filePath, const QList<RowError>& rejected,
+                                    QString* errorMessage) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorMessage = QString("Cannot open error report: %1").arg(file.errorString());
+        return false;
+    }
+
+    file.write("line,login,error\n");
+    for (const RowError& error : rejected) {
+        file.write(QByteArray::number(error.line) + ',' + CsvUtils::field(error.login) + ',' + CsvUtils::field(error.message) + '\n');
+    }
+
+    if (!file.commit()) {
+        *errorMessage = QString("Failed to write error report: %1").arg(file.errorString());
+        return false;
+    }
+    return true;
+}
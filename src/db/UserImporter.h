@@ -0,0 +1,149 @@
+#ifndef USERIMPORTER_H
+#define USERIMPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QThread>
+#include <atomic>
+
+/**
+ * @brief Пакетная регистрация студентов из CSV файла.
+ * Файл начинается строкой заголовка со столбцами login и password
+ * (необязательный столбец role, по умолчанию student).
+ *
+ * Строки проверяются до обращения к базе: пустые поля, короткий пароль,
+ * неизвестная роль, повтор логина в файле. Затем одним запросом ищутся
+ * логины, уже занятые в базе. Пароли оставшихся строк хешируются
+ * параллельно в QThreadPool с текущей стоимостью PBKDF2
+ * (CryptoUtils::passwordIterations), пользователи добавляются одной транзакцией
+ * (в PostgreSQL - командой COPY). Отклоненные строки с причинами
+ * записываются в CSV отчет рядом с исходным файлом.
+ *
+ * Импорт выполняется в фоновом потоке (start) или синхронно в текущем
+ * потоке (importFile) - для запуска из командной строки.
+ */
+class UserImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Отклоненная строка файла.
+     */
+    struct RowError {
+        int line;
+        QString login;
+        QString message;
+    };
+
+    /**
+     * @brief Итог импорта.
+     * error заполняется, если импорт прерван целиком (файл не прочитан,
+     * транзакция отменена); ни один пользователь в этом случае не добавлен.
+     */
+    struct Result {
+        qint64 rowsRead;
+        qint64 imported;
+        QList<RowError> rejected;
+        QString error;
+        bool canceled;
+
+        Result() : rowsRead(0), imported(0), canceled(false) {}
+
+        bool ok() const { return error.isEmpty() && !canceled; }
+    };
+
+    // Минимальная длина пароля, как при регистрации в LoginDialog
+    static constexpr int MIN_PASSWORD_LENGTH = 4;
+    // Паролей, хешируемых одной задачей пула потоков
+    static constexpr int HASH_CHUNK_SIZE = 256;
+
+    explicit UserImporter(QObject* parent = nullptr);
+
+    /**
+     * @brief Отменяет импорт и дожидается завершения потока.
+     */
+    ~UserImporter() override;
+
+    /**
+     * @brief Запускает импорт в фоновом потоке с соединением из ConnectionPool.
+     * @param filePath Путь к CSV файлу
+     * @return false если импорт уже выполняется
+     */
+    bool start(const QString& filePath);
+
+    /**
+     * @brief Запрашивает отмену; пользователи не добавляются, если отмена
+     * пришла до записи в базу.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Выполняет импорт в текущем потоке.
+     * Поток должен работать с базой: поток интерфейса или поток,
+     * получивший соединение от ConnectionPool.
+     * @param filePath Путь к CSV файлу
+     * @return Итог импорта; отчет об отклоненных строках уже записан,
+     * в том числе при ошибке записи в базу
+     */
+    Result importFile(const QString& filePath);
+
+    /**
+     * @brief Получает путь к отчету об отклоненных строках.
+     * @param filePath Путь к импортируемому файлу
+     * @return Путь вида file.errors.csv
+     */
+    static QString errorReportPath(const QString& filePath);
+
+signals:
+    /**
+     * @brief Сигнал о ходе хеширования паролей.
+     * @param rowsHashed Обработано строк
+     * @param totalRows Всего строк к добавлению
+     */
+    void progress(qint64 rowsHashed, qint64 totalRows);
+
+    /**
+     * @brief Сигнал о завершении импорта.
+     * @param imported Добавлено пользователей
+     * @param rejected Отклонено строк
+     * @param reportPath Путь к отчету об отклоненных строках, пустой если их нет
+     */
+    void finished(qint64 imported, qint64 rejected, const QString& reportPath);
+
+    /**
+     * @brief Сигнал об ошибке, при которой не добавлен ни один пользователь.
+     * @param error Текст ошибки
+     */
+    void failed(const QString& error);
+
+    /**
+     * @brief Сигнал об отмене импорта.
+     */
+    void canceled();
+
+private:
+    /**
+     * @brief Строка файла, прошедшая проверку.
+     */
+    struct Row {
+        int line;
+        QString login;
+        QString password;
+        QString role;
+    };
+
+    void run(const QString& filePath);
+    bool readRows(const QString& filePath, QList<Row>& rows, Result& result);
+    void saveErrorReport(const QString& filePath, const Result& result);
+    bool writeErrorReport(const QString& filePath, const QList<RowError>& rejected, QString* errorMessage);
+
+    QThread* m_thread;
+    std::atomic<bool> m_cancelRequested;
+};
+
+#endif // USERIMPORTER_H
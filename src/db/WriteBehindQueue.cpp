@@ -0,0 +1,40 @@
+#include "db/WriteBehindQueue.h"
+#include <QMutexLocker>
+
+WriteBehindQueue::WriteBehindQueue(int flushIntervalMs, int maxBatchSize, QObject* parent)
+    : QObject(parent), m_maxBatchSize(maxBatchSize) {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(flushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &WriteBehindQueue::flushRequested);
+}
+
+int WriteBehindQueue::pendingCount() const {
+    QMutexLocker locker(&m_mutex);
+    return pendingSize();
+}
+
+void WriteBehindQueue::setFlushInterval(int intervalMs) {
+    QMetaObject::invokeMethod(this, [this, intervalMs]() {
+        m_flushTimer.setInterval(intervalMs);
+    });
+}
+
+void WriteBehindQueue::pendingAdded(int pending) {
+    scheduleFlush(pending >= m_maxBatchSize);
+}
+
+void WriteBehindQueue::pendingRequeued() {
+    scheduleFlush(false);
+}
+
+void WriteBehindQueue::scheduleFlush(bool immediate) {
+    // Таймер принадлежит потоку объекта, вызов может прийти из любого потока
+    QMetaObject::invokeMethod(this, [this, immediate]() {
+        if (immediate) {
+            m_flushTimer.stop();
+            emit flushRequested();
+        } else if (!m_flushTimer.isActive()) {
+            m_flushTimer.start();
+        }
+    });
+}
@@ -0,0 +1,73 @@
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include <QObject>
+#include <QMutex>
+#include <QTimer>
+
+/**
+ * @brief Общая часть очередей отложенной записи (write-behind).
+ * Хранит мьютекс буфера и таймер сброса и решает, когда просить сброс:
+ * по таймеру, сразу при накоплении maxBatchSize записей и после возврата
+ * неудачного пакета. Сам буфер и правила его пополнения (объединение,
+ * усечение) задает наследник; сброс выполняет получатель flushRequested().
+ */
+class WriteBehindQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Получает число записей в буфере. Потокобезопасен.
+     * @return Количество записей
+     */
+    int pendingCount() const;
+
+    /**
+     * @brief Изменяет интервал сброса буфера.
+     * @param intervalMs Интервал в миллисекундах
+     */
+    void setFlushInterval(int intervalMs);
+
+signals:
+    /**
+     * @brief Сигнал о том, что буфер пора сбросить.
+     */
+    void flushRequested();
+
+protected:
+    /**
+     * @brief Конструктор очереди.
+     * @param flushIntervalMs Интервал сброса по умолчанию
+     * @param maxBatchSize Число записей, после которого буфер сбрасывается сразу
+     * @param parent Родительский объект
+     */
+    WriteBehindQueue(int flushIntervalMs, int maxBatchSize, QObject* parent);
+
+    /**
+     * @brief Получает размер буфера. Вызывается под m_mutex.
+     * @return Количество записей
+     */
+    virtual int pendingSize() const = 0;
+
+    /**
+     * @brief Планирует сброс после пополнения буфера. Вызывается без m_mutex.
+     * @param pending Размер буфера после пополнения
+     */
+    void pendingAdded(int pending);
+
+    /**
+     * @brief Планирует сброс после возврата неудачного пакета.
+     */
+    void pendingRequeued();
+
+    mutable QMutex m_mutex;
+
+private:
+    void scheduleFlush(bool immediate);
+
+    const int m_maxBatchSize;
+    QTimer m_flushTimer;
+};
+
+#endif // WRITEBEHINDQUEUE_H
@@ -0,0 +1,49 @@
+# Слой базы данных: DatabaseManager, пул соединений, хранилища СУБД,
+# фоновые отчеты и импорт. Подключается после core.pri приложением
+# и утилитами из tools/.
+
+QT += sql concurrent
+
+SOURCES += \
+    $$PWD/DatabaseManager.cpp \
+    $$PWD/ConnectionPool.cpp \
+    $$PWD/WriteBehindQueue.cpp \
+    $$PWD/ProgressWriter.cpp \
+    $$PWD/AttemptWriter.cpp \
+    $$PWD/StatementCache.cpp \
+    $$PWD/ReportGenerator.cpp \
+    $$PWD/UserImporter.cpp \
+    $$PWD/CsvUtils.cpp \
+    $$PWD/SchemaMigrator.cpp \
+    $$PWD/Storage.cpp \
+    $$PWD/SqlStorage.cpp \
+    $$PWD/PostgresStorage.cpp \
+    $$PWD/SqliteStorage.cpp \
+    $$PWD/DatabaseQuizSink.cpp \
+    $$PWD/../core/PasswordHasher.cpp
+
+HEADERS += \
+    $$PWD/DatabaseManager.h \
+    $$PWD/ConnectionPool.h \
+    $$PWD/WriteBehindQueue.h \
+    $$PWD/ProgressWriter.h \
+    $$PWD/AttemptWriter.h \
+    $$PWD/StatementCache.h \
+    $$PWD/ReportGenerator.h \
+    $$PWD/UserImporter.h \
+    $$PWD/CsvUtils.h \
+    $$PWD/SchemaMigrator.h \
+    $$PWD/Storage.h \
+    $$PWD/SqlStorage.h \
+    $$PWD/PostgresStorage.h \
+    $$PWD/SqliteStorage.h \
+    $$PWD/DatabaseQuizSink.h \
+    $$PWD/../core/PasswordHasher.h
+
+# PostgreSQL support
+unix {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libpq
+    # Прерывание выполняемых запросов через PQcancel
+    DEFINES += HAVE_LIBPQ
+}
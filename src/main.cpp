@@ -3,14 +3,67 @@
 #include <QFile>
 #include <QDir>
 #include <QMessageBox>
+#include <QElapsedTimer>
 
 #include "core/CourseManager.h"
+#include "core/CourseRepository.h"
+#include "core/StartupOrchestrator.h"
 #include "core/CryptoUtils.h"
+#ifdef EMBEDDED_COURSE
+#include "core/EmbeddedCourse.h"
+#endif
 #include "db/DatabaseManager.h"
+#include "db/UserImporter.h"
 #include "ui/LoginDialog.h"
 #include "ui/AdminWindow.h"
 #include "ui/StudentWindow.h"
 
+/**
+ * @brief Открывает курс в CourseRepository; при необходимости сначала
+ * преобразует JSON в бинарный файл. Выполняется вне потока интерфейса.
+ * @param jsonPath Путь к исходному JSON файлу
+ * @param binaryPath Путь к бинарному файлу курса
+ * @param key Ключ шифрования
+ * @return Текст ошибки для пользователя или пустая строка при успехе
+ */
+static QString prepareCourse(const QString& jsonPath, const QString& binaryPath, const QString& key) {
+#ifdef EMBEDDED_COURSE
+    // Курс встроен в исполняемый файл при сборке: файлы курса не читаются
+    Q_UNUSED(jsonPath);
+    Q_UNUSED(binaryPath);
+    qDebug() << "Opening embedded course...";
+    if (!CourseRepository::getInstance().loadMemory(EmbeddedCourse::data(), EmbeddedCourse::size(), key)) {
+        return "Не удалось открыть встроенные данные курса.";
+    }
+#else
+    // Проверка существования бинарного файла курса
+    qDebug() << "Checking course data...";
+    if (!QFile::exists(binaryPath)) {
+        qDebug() << "❌ Binary file not found:" << binaryPath;
+
+        if (!QFile::exists(jsonPath)) {
+            return QString("Не найден файл данных курса:\n%1\n\nПожалуйста, убедитесь, что файл существует.").arg(jsonPath);
+        }
+
+        // Потоковая конвертация JSON в бинарный формат с шифрованием
+        qDebug() << "✅ JSON source file found, converting to binary...";
+        if (!CourseManager::compileJsonToBinary(jsonPath, binaryPath, key)) {
+            return "Не удалось преобразовать данные курса из JSON файла в бинарный формат.";
+        }
+
+        qDebug() << "✅ Course converted and saved to binary format";
+    } else {
+        qDebug() << "✅ Binary course file exists";
+    }
+
+    // Курс открывается один раз на процесс, окна получают общий снимок
+    if (!CourseRepository::getInstance().load(binaryPath, key)) {
+        return "Не удалось загрузить данные курса из бинарного файла.";
+    }
+#endif
+    return QString();
+}
+
 /**
  * @brief Запускает главное приложение системы обучения HTTP Proxy
  * @param argc количество аргументов командной строки
@@ -18,73 +71,148 @@
  * @return код завершения приложения
  */
 int main(int argc, char* argv[]) {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QApplication app(argc, argv);
 
     qDebug() << "=== HTTP Proxy Learning System - GUI Application ===";
 
-    const QString ENCRYPTION_KEY = "SECRET_KEY_123";
+    const QString ENCRYPTION_KEY = QStringLiteral(COURSE_ENCRYPTION_KEY);
     const QString JSON_PATH = "data/course_source.json";
     const QString BINARY_PATH = "data/course.bin";
 
-    // Инициализация подключения к базе данных
-    qDebug() << "\n1. Initializing database connection...";
-    DatabaseManager& db = DatabaseManager::getInstance();
-
-    if (!db.connectToDatabase()) {
-        QMessageBox::critical(nullptr, "Ошибка базы данных",
-                            QString("Не удалось подключиться к базе данных:\n%1\n\nПроверьте настройки PostgreSQL.").arg(db.getLastError()));
-        return 1;
-    }
-
-    if (!db.initDatabase()) {
-        QMessageBox::critical(nullptr, "Ошибка инициализации",
-                            QString("Не удалось инициализировать базу данных:\n%1").arg(db.getLastError()));
-        return 1;
+    // Режим проверки целостности файла курса, без базы данных и интерфейса
+    if (app.arguments().contains("--verify-course")) {
+        QStringList errors;
+        if (!CourseManager::verifyCourseFile(BINARY_PATH, ENCRYPTION_KEY, &errors)) {
+            for (const QString& error : errors) {
+                qCritical().noquote() << error;
+            }
+            return 1;
+        }
+        qDebug() << "✅ Course file is intact:" << BINARY_PATH;
+        return 0;
     }
 
-    qDebug() << "✅ Database initialized successfully";
-
-    // Проверка существования бинарного файла курса
-    qDebug() << "\n2. Checking course data...";
-    QFile binaryFile(BINARY_PATH);
-
-    if (!binaryFile.exists()) {
-        qDebug() << "❌ Binary file not found:" << BINARY_PATH;
+    DatabaseManager& db = DatabaseManager::getInstance();
 
-        QFile jsonFile(JSON_PATH);
-        if (!jsonFile.exists()) {
-            QMessageBox::critical(nullptr, "Ошибка данных курса",
-                                QString("Не найден файл данных курса:\n%1\n\nПожалуйста, убедитесь, что файл существует.").arg(JSON_PATH));
+    // Пакетная регистрация студентов из CSV, без интерфейса:
+    // --import-users students.csv
+    const int importIndex = app.arguments().indexOf("--import-users");
+    if (importIndex >= 0) {
+        const QString importPath = app.arguments().value(importIndex + 1);
+        if (importPath.isEmpty()) {
+            qCritical() << "Usage: --import-users <file.csv>";
             return 1;
         }
 
-        // Конвертация JSON в бинарный формат с шифрованием
-        qDebug() << "✅ JSON source file found, converting to binary...";
-        Course course = CourseManager::loadCourseFromJSON(JSON_PATH);
-
-        if (course.chapters.isEmpty()) {
-            QMessageBox::critical(nullptr, "Ошибка загрузки курса", "Не удалось загрузить данные курса из JSON файла.");
+        if (!db.connectToDatabase() || !db.initDatabase()) {
+            qCritical().noquote() << "❌ Database initialization failed:" << db.getLastError();
             return 1;
         }
 
-        if (!CourseManager::saveCourseToBinary(course, BINARY_PATH, ENCRYPTION_KEY)) {
-            QMessageBox::critical(nullptr, "Ошибка сохранения", "Не удалось сохранить курс в бинарный формат.");
+        UserImporter importer;
+        const UserImporter::Result result = importer.importFile(importPath);
+        if (!result.ok()) {
+            qCritical().noquote() << "❌ Import failed:" << result.error;
+            if (!result.rejected.isEmpty()) {
+                qWarning().noquote() << result.rejected.size() << "rows rejected, see"
+                                     << UserImporter::errorReportPath(importPath);
+            }
             return 1;
         }
 
-        qDebug() << "✅ Course converted and saved to binary format";
-    } else {
-        qDebug() << "✅ Binary course file exists";
+        qDebug() << "✅ Imported" << result.imported << "of" << result.rowsRead << "users";
+        if (!result.rejected.isEmpty()) {
+            qWarning().noquote() << result.rejected.size() << "rows rejected, see"
+                                 << UserImporter::errorReportPath(importPath);
+            return 2;
+        }
+        return 0;
+    }
+
+    // Этапы запуска выполняются параллельно: соединение и миграции - в рабочем
+    // потоке DatabaseManager, подготовка курса - в пуле потоков запуска
+    const bool startupTrace = app.arguments().contains("--startup-trace");
+    StartupOrchestrator startup(startupTimer);
+
+    qDebug() << "\n1. Starting database connection, schema migration and course loading...";
+    startup.addAsyncPhase("database.connect", {}, [&db]() {
+        return db.connectToDatabaseAsync().then([](const DatabaseResult<bool>& result) {
+            if (result.ok() && result.value) {
+                return QString();
+            }
+            return QString("Не удалось подключиться к базе данных:\n%1\n\nПроверьте настройки PostgreSQL.")
+                .arg(result.ok() ? QString("Database not connected") : result.error);
+        });
+    });
+    startup.addAsyncPhase("database.schema", {"database.connect"}, [&db]() {
+        return db.initDatabaseAsync().then([](const DatabaseResult<bool>& result) {
+            if (result.ok() && result.value) {
+                return QString();
+            }
+            return QString("Не удалось инициализировать базу данных:\n%1").arg(result.error);
+        });
+    });
+    startup.addPhase("course", {}, [ENCRYPTION_KEY, JSON_PATH, BINARY_PATH]() {
+        return prepareCourse(JSON_PATH, BINARY_PATH, ENCRYPTION_KEY);
+    });
+    startup.start();
+
+    auto finishStartup = [&startup, startupTrace](const QString& milestone) {
+        startup.mark(milestone);
+        if (startupTrace) {
+            qDebug().noquote() << startup.report();
+        }
+    };
+
+    // Замер холодного запуска (coursectl bench-startup): все этапы запуска
+    // без диалога входа, затем выход
+    if (app.arguments().contains("--startup-exit")) {
+        const bool ready = startup.waitFor({"database.connect", "database.schema", "course"});
+        finishStartup(ready ? "ready" : "failed");
+        return ready ? 0 : 1;
+    }
+
+    // Диалогу входа нужно только соединение: миграции поставлены в очередь
+    // рабочего потока раньше, поэтому запрос входа выполнится после них
+    if (!startup.waitFor({"database.connect"})) {
+        finishStartup("failed");
+        QMessageBox::critical(nullptr, "Ошибка базы данных", startup.errorString());
+        return 1;
     }
 
     // Отображение диалога аутентификации
-    qDebug() << "\n3. Starting authentication...";
+    qDebug() << "\n2. Starting authentication...";
     LoginDialog loginDialog;
-
-    if (loginDialog.exec() != QDialog::Accepted) {
+    // Ошибка миграций или курса, пока открыт диалог, завершает вход
+    QObject::connect(&startup, &StartupOrchestrator::phaseFailed, &loginDialog, &QDialog::reject);
+    startup.mark("login dialog shown");
+
+    const int loginResult = loginDialog.exec();
+    if (startup.hasFailed()) {
+        finishStartup("failed");
+        QMessageBox::critical(nullptr, "Ошибка запуска", startup.errorString());
+        return 1;
+    }
+    if (loginResult != QDialog::Accepted) {
+        finishStartup("login cancelled");
         qDebug() << "User cancelled login";
         return 0;
     }
+    startup.mark("login accepted");
+
+    // Окна работают с курсом и актуальной схемой
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool ready = startup.waitFor({"database.schema", "course"});
+    QApplication::restoreOverrideCursor();
+    if (!ready) {
+        finishStartup("failed");
+        QMessageBox::critical(nullptr, "Ошибка запуска", startup.errorString());
+        return 1;
+    }
+    finishStartup("ready");
 
     QString userRole = loginDialog.getRole();
     int userId = loginDialog.getUserId();
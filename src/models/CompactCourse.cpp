@@ -0,0 +1,259 @@
+#include "models/CompactCourse.h"
+#include <QStringEncoder>
+#include <QDebug>
+#include <limits>
+
+// ---------------------------------------------------------------------------
+// QuestionView
+
+QString CompactCourse::QuestionView::text() const {
+    return textUtf8().toString();
+}
+
+QUtf8StringView CompactCourse::QuestionView::textUtf8() const {
+    return m_course->stringAt(m_course->m_questionTexts[m_index]);
+}
+
+int CompactCourse::QuestionView::optionCount() const {
+    return static_cast<int>(m_course->m_questionFirstOption[m_index + 1]
+                            - m_course->m_questionFirstOption[m_index]);
+}
+
+QString CompactCourse::QuestionView::option(int optionIndex) const {
+    return optionUtf8(optionIndex).toString();
+}
+
+QUtf8StringView CompactCourse::QuestionView::optionUtf8(int optionIndex) const {
+    Q_ASSERT(optionIndex >= 0 && optionIndex < optionCount());
+    int first = static_cast<int>(m_course->m_questionFirstOption[m_index]);
+    return m_course->stringAt(m_course->m_optionTexts[first + optionIndex]);
+}
+
+QStringList CompactCourse::QuestionView::options() const {
+    QStringList result;
+    int count = optionCount();
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.append(option(i));
+    }
+    return result;
+}
+
+int CompactCourse::QuestionView::correctIndex() const {
+    return m_course->m_questionCorrectIndex[m_index];
+}
+
+Question CompactCourse::QuestionView::toQuestion() const {
+    return Question(text(), options(), correctIndex());
+}
+
+// ---------------------------------------------------------------------------
+// ChapterView
+
+int CompactCourse::ChapterView::id() const {
+    return m_course->m_chapterIds[m_index];
+}
+
+QString CompactCourse::ChapterView::title() const {
+    return titleUtf8().toString();
+}
+
+QUtf8StringView CompactCourse::ChapterView::titleUtf8() const {
+    return m_course->stringAt(m_course->m_chapterTitles[m_index]);
+}
+
+QString CompactCourse::ChapterView::content() const {
+    return contentUtf8().toString();
+}
+
+QUtf8StringView CompactCourse::ChapterView::contentUtf8() const {
+    return m_course->stringAt(m_course->m_chapterContents[m_index]);
+}
+
+int CompactCourse::ChapterView::questionCount() const {
+    return static_cast<int>(m_course->m_chapterFirstQuestion[m_index + 1]
+                            - m_course->m_chapterFirstQuestion[m_index]);
+}
+
+CompactCourse::QuestionView CompactCourse::ChapterView::question(int questionIndex) const {
+    Q_ASSERT(questionIndex >= 0 && questionIndex < questionCount());
+    int first = static_cast<int>(m_course->m_chapterFirstQuestion[m_index]);
+    return QuestionView(m_course, first + questionIndex);
+}
+
+Chapter CompactCourse::ChapterView::toChapter() const {
+    Chapter chapter(id(), title(), content());
+    int count = questionCount();
+    chapter.questions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        chapter.questions.append(question(i).toQuestion());
+    }
+    return chapter;
+}
+
+// ---------------------------------------------------------------------------
+// CompactCourse
+
+CompactCourse::CompactCourse() {
+    // Таблицы смещений всегда содержат завершающий элемент
+    m_chapterFirstQuestion.append(0);
+    m_questionFirstOption.append(0);
+}
+
+CompactCourse CompactCourse::fromCourse(const Course& course) {
+    CompactCourse compact;
+
+    // Точные размеры таблиц известны заранее - одно выделение на таблицу
+    int questions = 0;
+    int options = 0;
+    qsizetype arenaBytes = 0;
+    for (const Chapter& chapter : course.chapters) {
+        questions += chapter.questions.size();
+        arenaBytes += chapter.title.size() + chapter.content.size();
+        for (const Question& question : chapter.questions) {
+            options += question.options.size();
+            arenaBytes += question.q_text.size();
+            for (const QString& option : question.options) {
+                arenaBytes += option.size();
+            }
+        }
+    }
+    // Оценка по числу символов UTF-16: для кириллицы арена вырастет примерно вдвое
+    compact.reserve(course.chapters.size(), questions, options, arenaBytes);
+
+    for (const Chapter& chapter : course.chapters) {
+        if (!compact.appendChapter(chapter)) {
+            break;
+        }
+    }
+
+    compact.squeeze();
+    return compact;
+}
+
+bool CompactCourse::appendChapter(const Chapter& chapter) {
+    const qsizetype arenaSize = m_arena.size();
+    const int questionCount = m_questionTexts.size();
+    const int optionCount = m_optionTexts.size();
+
+    StringRef title;
+    StringRef content;
+    bool ok = appendString(chapter.title, title) && appendString(chapter.content, content);
+
+    for (const Question& question : chapter.questions) {
+        if (!ok) {
+            break;
+        }
+
+        StringRef text;
+        ok = appendString(question.q_text, text);
+        for (const QString& option : question.options) {
+            StringRef optionRef;
+            ok = ok && appendString(option, optionRef);
+            m_optionTexts.append(optionRef);
+        }
+
+        m_questionTexts.append(text);
+        m_questionCorrectIndex.append(question.correct_index);
+        m_questionFirstOption.append(static_cast<quint32>(m_optionTexts.size()));
+    }
+
+    if (!ok) {
+        // Откат частично добавленной главы
+        qWarning() << "Compact course string arena overflow at chapter" << chapter.id;
+        m_arena.truncate(arenaSize);
+        m_questionTexts.resize(questionCount);
+        m_questionCorrectIndex.resize(questionCount);
+        m_questionFirstOption.resize(questionCount + 1);
+        m_optionTexts.resize(optionCount);
+        return false;
+    }
+
+    m_chapterIds.append(chapter.id);
+    m_chapterTitles.append(title);
+    m_chapterContents.append(content);
+    m_chapterFirstQuestion.append(static_cast<quint32>(m_questionTexts.size()));
+    return true;
+}
+
+void CompactCourse::reserve(int chapters, int questions, int options, qsizetype arenaBytes) {
+    m_chapterIds.reserve(chapters);
+    m_chapterTitles.reserve(chapters);
+    m_chapterContents.reserve(chapters);
+    m_chapterFirstQuestion.reserve(chapters + 1);
+    m_questionTexts.reserve(questions);
+    m_questionCorrectIndex.reserve(questions);
+    m_questionFirstOption.reserve(questions + 1);
+    m_optionTexts.reserve(options);
+    m_arena.reserve(arenaBytes);
+}
+
+void CompactCourse::squeeze() {
+    m_chapterIds.squeeze();
+    m_chapterTitles.squeeze();
+    m_chapterContents.squeeze();
+    m_chapterFirstQuestion.squeeze();
+    m_questionTexts.squeeze();
+    m_questionCorrectIndex.squeeze();
+    m_questionFirstOption.squeeze();
+    m_optionTexts.squeeze();
+    m_arena.squeeze();
+}
+
+Course CompactCourse::toCourse() const {
+    Course course;
+    course.chapters.reserve(chapterCount());
+    for (int i = 0; i < chapterCount(); ++i) {
+        course.chapters.append(chapter(i).toChapter());
+    }
+    return course;
+}
+
+int CompactCourse::chapterCount() const {
+    return m_chapterIds.size();
+}
+
+int CompactCourse::questionCount() const {
+    return m_questionTexts.size();
+}
+
+CompactCourse::ChapterView CompactCourse::chapter(int index) const {
+    Q_ASSERT(index >= 0 && index < chapterCount());
+    return ChapterView(this, index);
+}
+
+qsizetype CompactCourse::memoryUsage() const {
+    return m_chapterIds.capacity() * qsizetype(sizeof(qint32))
+        + m_chapterTitles.capacity() * qsizetype(sizeof(StringRef))
+        + m_chapterContents.capacity() * qsizetype(sizeof(StringRef))
+        + m_chapterFirstQuestion.capacity() * qsizetype(sizeof(quint32))
+        + m_questionTexts.capacity() * qsizetype(sizeof(StringRef))
+        + m_questionCorrectIndex.capacity() * qsizetype(sizeof(qint32))
+        + m_questionFirstOption.capacity() * qsizetype(sizeof(quint32))
+        + m_optionTexts.capacity() * qsizetype(sizeof(StringRef))
+        + m_arena.capacity();
+}
+
+bool CompactCourse::appendString(const QString& text, StringRef& ref) {
+    const qsizetype offset = m_arena.size();
+    ref = StringRef{0, 0};
+
+    // Текст кодируется прямо в арену, без временного QByteArray
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    const qsizetype maxLength = encoder.requiredSpace(text.size());
+    if (offset + maxLength > qsizetype(std::numeric_limits<quint32>::max())) {
+        return false;
+    }
+
+    m_arena.resize(offset + maxLength);
+    char* end = encoder.appendToBuffer(m_arena.data() + offset, text);
+    const qsizetype length = end - (m_arena.data() + offset);
+    m_arena.resize(offset + length);
+
+    ref = StringRef{static_cast<quint32>(offset), static_cast<quint32>(length)};
+    return true;
+}
+
+QUtf8StringView CompactCourse::stringAt(const StringRef& ref) const {
+    return QUtf8StringView(m_arena.constData() + ref.offset, static_cast<qsizetype>(ref.length));
+}
@@ -0,0 +1,155 @@
+#ifndef COMPACTCOURSE_H
+#define COMPACTCOURSE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QUtf8StringView>
+#include "models/Structures.h"
+
+/**
+ * @brief Компактное представление курса в памяти.
+ * Главы, вопросы и варианты ответов хранятся в непрерывных таблицах
+ * (struct-of-arrays), весь текст - в одной UTF-8 арене строк, на которую
+ * ссылаются 32-битные смещения. Курс из N вопросов занимает несколько
+ * выделений памяти вместо десятков тысяч.
+ * Для интерфейса доступны легкие представления ChapterView и QuestionView,
+ * а также преобразование в структуры Course/Chapter/Question и обратно.
+ */
+class CompactCourse
+{
+public:
+    /**
+     * @brief Ссылка на строку в арене: смещение и длина в байтах UTF-8.
+     */
+    struct StringRef {
+        quint32 offset;
+        quint32 length;
+    };
+
+    /**
+     * @brief Представление вопроса без копирования данных.
+     * Действительно, пока существует исходный CompactCourse.
+     */
+    class QuestionView
+    {
+    public:
+        QuestionView(const CompactCourse* course, int index) : m_course(course), m_index(index) {}
+
+        QString text() const;
+        QUtf8StringView textUtf8() const;
+        int optionCount() const;
+        QString option(int optionIndex) const;
+        QUtf8StringView optionUtf8(int optionIndex) const;
+        QStringList options() const;
+        int correctIndex() const;
+
+        /**
+         * @brief Преобразует представление в структуру Question.
+         * @return Объект Question
+         */
+        Question toQuestion() const;
+
+    private:
+        const CompactCourse* m_course;
+        int m_index;
+    };
+
+    /**
+     * @brief Представление главы без копирования данных.
+     * Действительно, пока существует исходный CompactCourse.
+     */
+    class ChapterView
+    {
+    public:
+        ChapterView(const CompactCourse* course, int index) : m_course(course), m_index(index) {}
+
+        int id() const;
+        QString title() const;
+        QUtf8StringView titleUtf8() const;
+        QString content() const;
+        QUtf8StringView contentUtf8() const;
+        int questionCount() const;
+        QuestionView question(int questionIndex) const;
+
+        /**
+         * @brief Преобразует представление в структуру Chapter.
+         * @return Объект Chapter
+         */
+        Chapter toChapter() const;
+
+    private:
+        const CompactCourse* m_course;
+        int m_index;
+    };
+
+    CompactCourse();
+
+    /**
+     * @brief Строит компактное представление из структуры Course.
+     * @param course Исходный курс
+     * @return Компактный курс
+     */
+    static CompactCourse fromCourse(const Course& course);
+
+    /**
+     * @brief Добавляет главу в конец курса.
+     * @param chapter Глава для добавления
+     * @return true если глава добавлена, false если арена строк переполнена
+     */
+    bool appendChapter(const Chapter& chapter);
+
+    /**
+     * @brief Резервирует место в таблицах и арене.
+     * @param chapters Ожидаемое количество глав
+     * @param questions Ожидаемое количество вопросов
+     * @param options Ожидаемое количество вариантов ответов
+     * @param arenaBytes Ожидаемый размер текста в байтах UTF-8
+     */
+    void reserve(int chapters, int questions, int options, qsizetype arenaBytes);
+
+    /**
+     * @brief Освобождает неиспользуемый резерв таблиц и арены.
+     */
+    void squeeze();
+
+    /**
+     * @brief Преобразует компактный курс в структуру Course.
+     * @return Объект Course
+     */
+    Course toCourse() const;
+
+    int chapterCount() const;
+    int questionCount() const;
+    ChapterView chapter(int index) const;
+
+    /**
+     * @brief Получает объем памяти, занятый таблицами и ареной строк.
+     * @return Размер в байтах
+     */
+    qsizetype memoryUsage() const;
+
+private:
+    bool appendString(const QString& text, StringRef& ref);
+    QUtf8StringView stringAt(const StringRef& ref) const;
+
+    // Таблица глав; m_chapterFirstQuestion содержит chapterCount() + 1 элемент
+    QVector<qint32> m_chapterIds;
+    QVector<StringRef> m_chapterTitles;
+    QVector<StringRef> m_chapterContents;
+    QVector<quint32> m_chapterFirstQuestion;
+
+    // Таблица вопросов; m_questionFirstOption содержит questionCount() + 1 элемент
+    QVector<StringRef> m_questionTexts;
+    QVector<qint32> m_questionCorrectIndex;
+    QVector<quint32> m_questionFirstOption;
+
+    // Таблица вариантов ответов
+    QVector<StringRef> m_optionTexts;
+
+    // Весь текст курса в UTF-8
+    QByteArray m_arena;
+};
+
+#endif // COMPACTCOURSE_H
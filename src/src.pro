@@ -0,0 +1,57 @@
+QT += core gui widgets sql concurrent
+
+CONFIG += c++17
+
+TARGET = CourseProject
+TEMPLATE = app
+
+DESTDIR = ../bin
+
+include(core/core.pri)
+include(db/db.pri)
+
+SOURCES += \
+    main.cpp \
+    core/CourseRepository.cpp \
+    core/StartupOrchestrator.cpp \
+    ui/LoginDialog.cpp \
+    ui/AdminWindow.cpp \
+    ui/StudentWindow.cpp \
+    ui/UsersTableModel.cpp
+
+HEADERS += \
+    core/CourseRepository.h \
+    core/StartupOrchestrator.h \
+    core/EmbeddedCourse.h \
+    ui/LoginDialog.h \
+    ui/AdminWindow.h \
+    ui/StudentWindow.h \
+    ui/UsersTableModel.h
+
+# Include paths
+INCLUDEPATH += $$PWD
+
+# Встроенный курс (киоск-сборки): qmake CONFIG+=embed_course
+# data/course_source.json преобразуется при сборке в массив байт,
+# приложение открывает его из памяти без обращения к файлам курса
+embed_course {
+    COURSEGEN = $$OUT_PWD/../tools/coursegen/coursegen
+    win32: COURSEGEN = $${COURSEGEN}.exe
+
+    COURSE_SOURCE = $$PWD/../data/course_source.json
+
+    coursegen.name = coursegen ${QMAKE_FILE_IN}
+    coursegen.input = COURSE_SOURCE
+    coursegen.output = $$OUT_PWD/embedded_${QMAKE_FILE_BASE}.cpp
+    coursegen.commands = $$shell_path($$COURSEGEN) --key $$shell_quote($$COURSE_ENCRYPTION_KEY) ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+    coursegen.depends = $$COURSEGEN
+    coursegen.variable_out = SOURCES
+    QMAKE_EXTRA_COMPILERS += coursegen
+
+    DEFINES += EMBEDDED_COURSE
+}
+
+# Debug configuration
+CONFIG(debug, debug|release) {
+    DEFINES += DEBUG
+}
@@ -1,10 +1,14 @@
 #include "ui/AdminWindow.h"
 #include "db/DatabaseManager.h"
 #include "core/CourseManager.h"
+#include "core/CourseRepository.h"
 #include <QDateTime>
+#include <QFileInfo>
+#include <QStatusBar>
 
 AdminWindow::AdminWindow(QWidget* parent)
-    : QMainWindow(parent), m_currentChapterIndex(-1) {
+    : QMainWindow(parent), m_usersModel(nullptr), m_searchTimer(nullptr), m_reportGenerator(nullptr),
+      m_importButton(nullptr), m_userImporter(nullptr), m_currentChapterIndex(-1) {
     setWindowTitle("Панель администратора - HTTP Proxy Course");
     setMinimumSize(900, 600);
     resize(1200, 800);
@@ -19,6 +23,7 @@ void AdminWindow::setupUI() {
     setCentralWidget(m_tabWidget);
 
     setupStudentsTab();
+    setupStatisticsTab();
     setupCourseEditorTab();
 }
 
@@ -46,6 +51,10 @@ void AdminWindow::setupStudentsTab()
     
     controlsLayout->addStretch();
     
+    m_importButton = new QPushButton("Импорт студентов", m_studentsTab);
+    m_importButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; padding: 8px 16px; border: none; border-radius: 4px; } QPushButton:hover { background-color: #388E3C; }");
+    controlsLayout->addWidget(m_importButton);
+    
     m_reportButton = new QPushButton("Создать отчет", m_studentsTab);
     m_reportButton->setStyleSheet("QPushButton { background-color: #FF9800; color: white; padding: 8px 16px; border: none; border-radius: 4px; } QPushButton:hover { background-color: #F57C00; }");
     controlsLayout->addWidget(m_reportButton);
@@ -56,33 +65,94 @@ void AdminWindow::setupStudentsTab()
     m_studentsTableView = new QTableView(m_studentsTab);
     m_studentsTableView->setAlternatingRowColors(true);
     m_studentsTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_studentsTableView->setSortingEnabled(true);
     
-    // Setup model and proxy for filtering
-    DatabaseManager& db = DatabaseManager::getInstance();
-    m_usersModel = db.getUsersModel();
+    // Модель загружает страницы пользователей по мере прокрутки,
+    // сортировка и поиск выполняются на сервере
+    m_usersModel = new UsersTableModel(this);
+    m_studentsTableView->setModel(m_usersModel);
     
-    if (m_usersModel) {
-        m_proxyModel = new QSortFilterProxyModel(this);
-        m_proxyModel->setSourceModel(m_usersModel);
-        m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-        m_proxyModel->setFilterKeyColumn(1); // Filter by login column
-        
-        m_studentsTableView->setModel(m_proxyModel);
-        
-        // Hide password hash column for security
-        m_studentsTableView->hideColumn(2);
-        
-        // Adjust column widths
-        m_studentsTableView->horizontalHeader()->setStretchLastSection(true);
-        m_studentsTableView->resizeColumnsToContents();
-    }
+    // Hide password hash column for security
+    m_studentsTableView->hideColumn(UsersTableModel::PasswordHashColumn);
+    
+    // Ширина столбцов задается заранее: подбор по содержимому потребовал бы всех строк
+    m_studentsTableView->horizontalHeader()->setDefaultSectionSize(200);
+    m_studentsTableView->horizontalHeader()->setStretchLastSection(true);
+    
+    // Включение сортировки запрашивает первую страницу
+    m_studentsTableView->horizontalHeader()->setSortIndicator(UsersTableModel::IdColumn, Qt::AscendingOrder);
+    m_studentsTableView->setSortingEnabled(true);
     
     mainLayout->addWidget(m_studentsTableView);
     
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(SEARCH_DEBOUNCE_MS);
+    
     // Connect signals
     connect(m_searchLineEdit, &QLineEdit::textChanged, this, &AdminWindow::onSearchTextChanged);
+    connect(m_searchTimer, &QTimer::timeout, this, &AdminWindow::applySearch);
     connect(m_reportButton, &QPushButton::clicked, this, &AdminWindow::onGenerateReportClicked);
+    
+    m_reportGenerator = new ReportGenerator(this);
+    connect(m_reportGenerator, &ReportGenerator::progress, this, &AdminWindow::onReportProgress);
+    connect(m_reportGenerator, &ReportGenerator::finished, this, &AdminWindow::onReportFinished);
+    connect(m_reportGenerator, &ReportGenerator::failed, this, &AdminWindow::onReportFailed);
+    connect(m_reportGenerator, &ReportGenerator::canceled, this, &AdminWindow::onReportCanceled);
+    
+    connect(m_importButton, &QPushButton::clicked, this, &AdminWindow::onImportUsersClicked);
+    m_userImporter = new UserImporter(this);
+    connect(m_userImporter, &UserImporter::progress, this, &AdminWindow::onImportProgress);
+    connect(m_userImporter, &UserImporter::finished, this, &AdminWindow::onImportFinished);
+    connect(m_userImporter, &UserImporter::failed, this, &AdminWindow::onImportFailed);
+    connect(m_userImporter, &UserImporter::canceled, this, &AdminWindow::onImportCanceled);
+}
+
+void AdminWindow::setupStatisticsTab()
+{
+    m_statisticsTab = new QWidget();
+    m_tabWidget->addTab(m_statisticsTab, "Статистика");
+    
+    QVBoxLayout* mainLayout = new QVBoxLayout(m_statisticsTab);
+    
+    QHBoxLayout* titleLayout = new QHBoxLayout();
+    QLabel* titleLabel = new QLabel("Статистика тестов", m_statisticsTab);
+    titleLabel->setStyleSheet("font-size: 16px; font-weight: bold; margin-bottom: 10px;");
+    titleLayout->addWidget(titleLabel);
+    titleLayout->addStretch();
+    
+    m_refreshStatsButton = new QPushButton("Обновить", m_statisticsTab);
+    titleLayout->addWidget(m_refreshStatsButton);
+    mainLayout->addLayout(titleLayout);
+    
+    // Главы: сколько тестов сдано и не сдано
+    m_chapterStatsTable = new QTableWidget(0, 4, m_statisticsTab);
+    m_chapterStatsTable->setHorizontalHeaderLabels({"Глава", "Сдано", "Не сдано", "Доля сдавших"});
+    m_chapterStatsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_chapterStatsTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_chapterStatsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_chapterStatsTable->horizontalHeader()->setStretchLastSection(true);
+    m_chapterStatsTable->verticalHeader()->hide();
+    
+    // Вопросы выбранной главы: сложность и среднее время ответа
+    m_questionStatsTable = new QTableWidget(0, 4, m_statisticsTab);
+    m_questionStatsTable->setHorizontalHeaderLabels({"Вопрос", "Ответов", "Ошибок, %", "Среднее время, с"});
+    m_questionStatsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_questionStatsTable->horizontalHeader()->setStretchLastSection(true);
+    m_questionStatsTable->verticalHeader()->hide();
+    
+    QSplitter* splitter = new QSplitter(Qt::Vertical, m_statisticsTab);
+    splitter->addWidget(m_chapterStatsTable);
+    splitter->addWidget(m_questionStatsTable);
+    mainLayout->addWidget(splitter);
+    
+    connect(m_refreshStatsButton, &QPushButton::clicked, this, &AdminWindow::onRefreshStatisticsClicked);
+    connect(m_chapterStatsTable, &QTableWidget::itemSelectionChanged, this, &AdminWindow::onStatisticsChapterSelected);
+    // Сводка загружается при первом открытии вкладки
+    connect(m_tabWidget, &QTabWidget::currentChanged, this, [this](int index) {
+        if (m_tabWidget->widget(index) == m_statisticsTab && m_chapterStatsTable->rowCount() == 0) {
+            onRefreshStatisticsClicked();
+        }
+    });
 }
 
 void AdminWindow::setupCourseEditorTab()
@@ -155,10 +225,13 @@ void AdminWindow::setupCourseEditorTab()
 
 void AdminWindow::loadCourseData()
 {
-    const QString BINARY_PATH = "data/course.bin";
-    const QString ENCRYPTION_KEY = "SECRET_KEY_123";
-    
-    m_course = CourseManager::loadCourseFromBinary(BINARY_PATH, ENCRYPTION_KEY);
+    CourseRepository::Snapshot snapshot = CourseRepository::getInstance().snapshot();
+    QString errorMessage;
+    if (snapshot && !snapshot->toCourse(m_course, &errorMessage)) {
+        QMessageBox::warning(this, "Ошибка",
+                           "Не удалось прочитать курс:\n" + errorMessage);
+        return;
+    }
     
     if (m_course.chapters.isEmpty()) {
         QMessageBox::warning(this, "Ошибка", 
@@ -182,68 +255,241 @@ void AdminWindow::loadCourseData()
 
 void AdminWindow::onSearchTextChanged(const QString& text)
 {
-    if (m_proxyModel) {
-        m_proxyModel->setFilterFixedString(text);
+    Q_UNUSED(text);
+    // Каждое нажатие откладывает запрос; выполняется только последний
+    m_searchTimer->start();
+}
+
+void AdminWindow::applySearch()
+{
+    // Модель отменяет запросы по прежнему тексту поиска
+    if (m_usersModel) {
+        m_usersModel->setLoginFilter(m_searchLineEdit->text().trimmed());
     }
 }
 
 void AdminWindow::onGenerateReportClicked()
 {
-    DatabaseManager& db = DatabaseManager::getInstance();
-    QSqlQuery query = db.executeSelectQuery("SELECT login, role, created_at FROM users ORDER BY created_at DESC");
+    // Повторное нажатие во время формирования отменяет отчет
+    if (m_reportGenerator->isRunning()) {
+        m_reportGenerator->cancel();
+        m_reportButton->setEnabled(false);
+        return;
+    }
+    
+    const QString textFilter = "Текстовый отчет (*.txt)";
+    const QString csvFilter = "CSV (*.csv)";
+    const QString jsonFilter = "JSON (*.json)";
     
-    if (!query.isActive()) {
-        QMessageBox::critical(this, "Ошибка", "Не удалось выполнить запрос к базе данных.");
+    QString selectedFilter = textFilter;
+    QString defaultName = QString("Report_%1.txt").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    QString fileName = QFileDialog::getSaveFileName(this, "Сохранить отчет", defaultName,
+                                                    QStringList({textFilter, csvFilter, jsonFilter}).join(";;"),
+                                                    &selectedFilter);
+    if (fileName.isEmpty()) {
         return;
     }
     
-    QString reportContent;
-    reportContent += "=== ОТЧЕТ ПО ПОЛЬЗОВАТЕЛЯМ СИСТЕМЫ ===\n";
-    reportContent += QString("Дата создания: %1\n\n").arg(QDateTime::currentDateTime().toString("dd.MM.yyyy hh:mm:ss"));
-    
-    int totalUsers = 0;
-    int adminCount = 0;
-    int studentCount = 0;
-    
-    while (query.next()) {
-        QString login = query.value(0).toString();
-        QString role = query.value(1).toString();
-        QString createdAt = query.value(2).toString();
-        
-        reportContent += QString("Логин: %1 | Роль: %2 | Дата регистрации: %3\n")
-                        .arg(login).arg(role).arg(createdAt);
-        
-        totalUsers++;
-        if (role == "admin") {
-            adminCount++;
-        } else if (role == "student") {
-            studentCount++;
-        }
+    ReportGenerator::Format format = ReportGenerator::Format::Text;
+    if (selectedFilter == csvFilter) {
+        format = ReportGenerator::Format::Csv;
+    } else if (selectedFilter == jsonFilter) {
+        format = ReportGenerator::Format::Json;
     }
     
-    reportContent += "\n=== СТАТИСТИКА ===\n";
-    reportContent += QString("Всего пользователей: %1\n").arg(totalUsers);
-    reportContent += QString("Администраторов: %1\n").arg(adminCount);
-    reportContent += QString("Студентов: %1\n").arg(studentCount);
-    reportContent += "\n=== КОНЕЦ ОТЧЕТА ===\n";
-    
-    // Save to file
-    QString fileName = QString("Report_%1.txt").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
-    QFile reportFile(fileName);
-    
-    if (reportFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&reportFile);
-        out << reportContent;
-        reportFile.close();
-        
-        QMessageBox::information(this, "Отчет создан", 
-                               QString("Отчет успешно сохранен в файл:\n%1\n\nВсего пользователей: %2")
-                               .arg(fileName).arg(totalUsers));
-    } else {
-        QMessageBox::critical(this, "Ошибка", "Не удалось сохранить отчет в файл.");
+    if (QFileInfo(fileName).suffix().isEmpty()) {
+        fileName += "." + ReportGenerator::fileExtension(format);
+    }
+    
+    // Отчет формируется в фоновом потоке, окно остается доступным
+    if (m_reportGenerator->start(fileName, format)) {
+        m_reportButton->setText("Отменить отчет");
+        statusBar()->showMessage("Формирование отчета...");
     }
 }
 
+void AdminWindow::onReportProgress(qint64 rowsWritten, qint64 totalRows)
+{
+    statusBar()->showMessage(QString("Формирование отчета: %1 из %2 строк").arg(rowsWritten).arg(totalRows));
+}
+
+void AdminWindow::onReportFinished(const QString& filePath, qint64 totalRows)
+{
+    resetReportButton();
+    statusBar()->showMessage("Отчет создан", 5000);
+    QMessageBox::information(this, "Отчет создан", 
+                           QString("Отчет успешно сохранен в файл:\n%1\n\nВсего пользователей: %2")
+                           .arg(filePath).arg(totalRows));
+}
+
+void AdminWindow::onReportFailed(const QString& error)
+{
+    resetReportButton();
+    statusBar()->clearMessage();
+    qWarning() << "Report generation failed:" << error;
+    QMessageBox::critical(this, "Ошибка", "Не удалось создать отчет.");
+}
+
+void AdminWindow::onReportCanceled()
+{
+    resetReportButton();
+    statusBar()->showMessage("Формирование отчета отменено", 5000);
+}
+
+void AdminWindow::resetReportButton()
+{
+    m_reportButton->setText("Создать отчет");
+    m_reportButton->setEnabled(true);
+}
+
+void AdminWindow::onImportUsersClicked()
+{
+    // Повторное нажатие во время импорта отменяет его
+    if (m_userImporter->isRunning()) {
+        m_userImporter->cancel();
+        m_importButton->setEnabled(false);
+        return;
+    }
+    
+    QString fileName = QFileDialog::getOpenFileName(this, "Импорт студентов", QString(),
+                                                    "CSV файлы (*.csv);;Все файлы (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    // Хеширование паролей и запись выполняются в фоновом потоке
+    if (m_userImporter->start(fileName)) {
+        m_importButton->setText("Отменить импорт");
+        statusBar()->showMessage("Импорт студентов...");
+    }
+}
+
+void AdminWindow::onImportProgress(qint64 rowsHashed, qint64 totalRows)
+{
+    statusBar()->showMessage(QString("Импорт студентов: %1 из %2").arg(rowsHashed).arg(totalRows));
+}
+
+void AdminWindow::onImportFinished(qint64 imported, qint64 rejected, const QString& reportPath)
+{
+    resetImportButton();
+    statusBar()->showMessage("Импорт завершен", 5000);
+    
+    // Новые пользователи появляются в таблице
+    m_usersModel->refresh();
+    
+    QString message = QString("Добавлено студентов: %1").arg(imported);
+    if (rejected > 0) {
+        message += QString("\nОтклонено строк: %1\n\nПричины записаны в файл:\n%2").arg(rejected).arg(reportPath);
+    }
+    QMessageBox::information(this, "Импорт завершен", message);
+}
+
+void AdminWindow::onImportFailed(const QString& error)
+{
+    resetImportButton();
+    statusBar()->clearMessage();
+    qWarning() << "User import failed:" << error;
+    QMessageBox::critical(this, "Ошибка",
+                        QString("Не удалось импортировать студентов, ни один не добавлен.\n\nОшибка: %1").arg(error));
+}
+
+void AdminWindow::onImportCanceled()
+{
+    resetImportButton();
+    statusBar()->showMessage("Импорт отменен", 5000);
+}
+
+void AdminWindow::resetImportButton()
+{
+    m_importButton->setText("Импорт студентов");
+    m_importButton->setEnabled(true);
+}
+
+void AdminWindow::onRefreshStatisticsClicked()
+{
+    m_refreshStatsButton->setEnabled(false);
+    
+    DatabaseManager::getInstance().getChapterStatsAsync()
+        .then(this, [this](const DatabaseResult<QList<QSqlRecord>>& result) {
+            m_refreshStatsButton->setEnabled(true);
+            
+            if (!result.ok()) {
+                QMessageBox::warning(this, "Ошибка",
+                                   QString("Не удалось загрузить статистику.\n\nОшибка: %1").arg(result.error));
+                return;
+            }
+            
+            m_chapterStatsTable->clearContents();
+            m_chapterStatsTable->setRowCount(result.value.size());
+            m_questionStatsTable->setRowCount(0);
+            
+            for (int row = 0; row < result.value.size(); ++row) {
+                const QSqlRecord& record = result.value.at(row);
+                const int chapterId = record.value("chapter_id").toInt();
+                const qint64 passed = record.value("tests_passed").toLongLong();
+                const qint64 failed = record.value("tests_failed").toLongLong();
+                const qint64 total = passed + failed;
+                
+                QString title = QString("Глава %1").arg(chapterId + 1);
+                if (chapterId >= 0 && chapterId < m_course.chapters.size()) {
+                    title += ": " + m_course.chapters[chapterId].title;
+                }
+                
+                QTableWidgetItem* titleItem = new QTableWidgetItem(title);
+                titleItem->setData(Qt::UserRole, chapterId);
+                m_chapterStatsTable->setItem(row, 0, titleItem);
+                m_chapterStatsTable->setItem(row, 1, new QTableWidgetItem(QString::number(passed)));
+                m_chapterStatsTable->setItem(row, 2, new QTableWidgetItem(QString::number(failed)));
+                m_chapterStatsTable->setItem(row, 3, new QTableWidgetItem(
+                    total > 0 ? QString("%1%").arg(100.0 * passed / total, 0, 'f', 1) : QString("-")));
+            }
+            m_chapterStatsTable->resizeColumnsToContents();
+        });
+}
+
+void AdminWindow::onStatisticsChapterSelected()
+{
+    const int row = m_chapterStatsTable->currentRow();
+    QTableWidgetItem* titleItem = row >= 0 ? m_chapterStatsTable->item(row, 0) : nullptr;
+    if (!titleItem) {
+        return;
+    }
+    
+    const int chapterId = titleItem->data(Qt::UserRole).toInt();
+    DatabaseManager::getInstance().getQuestionStatsAsync(chapterId)
+        .then(this, [this, chapterId](const DatabaseResult<QList<QSqlRecord>>& result) {
+            // Пока запрос выполнялся, могла быть выбрана другая глава
+            const int currentRow = m_chapterStatsTable->currentRow();
+            QTableWidgetItem* currentItem = currentRow >= 0 ? m_chapterStatsTable->item(currentRow, 0) : nullptr;
+            if (!currentItem || currentItem->data(Qt::UserRole).toInt() != chapterId) {
+                return;
+            }
+            
+            if (!result.ok()) {
+                qWarning() << "Failed to load question statistics:" << result.error;
+                return;
+            }
+            
+            m_questionStatsTable->clearContents();
+            m_questionStatsTable->setRowCount(result.value.size());
+            
+            for (int i = 0; i < result.value.size(); ++i) {
+                const QSqlRecord& record = result.value.at(i);
+                const qint64 attempts = record.value("attempts").toLongLong();
+                const qint64 correct = record.value("correct").toLongLong();
+                const double errorRate = attempts > 0 ? 100.0 * (attempts - correct) / attempts : 0.0;
+                const double averageSeconds = record.value("avg_latency_ms").toDouble() / 1000.0;
+                
+                m_questionStatsTable->setItem(i, 0, new QTableWidgetItem(
+                    QString::number(record.value("question_index").toInt() + 1)));
+                m_questionStatsTable->setItem(i, 1, new QTableWidgetItem(QString::number(attempts)));
+                m_questionStatsTable->setItem(i, 2, new QTableWidgetItem(QString::number(errorRate, 'f', 1)));
+                m_questionStatsTable->setItem(i, 3, new QTableWidgetItem(QString::number(averageSeconds, 'f', 1)));
+            }
+            m_questionStatsTable->resizeColumnsToContents();
+        });
+}
+
 void AdminWindow::onChapterSelectionChanged()
 {
     int currentRow = m_chaptersListWidget->currentRow();
@@ -292,11 +538,8 @@ void AdminWindow::onSaveChangesClicked()
     QString itemText = QString("Глава %1: %2").arg(m_currentChapterIndex + 1).arg(newTitle);
     m_chaptersListWidget->item(m_currentChapterIndex)->setText(itemText);
     
-    // Save to binary file
-    const QString BINARY_PATH = "data/course.bin";
-    const QString ENCRYPTION_KEY = "SECRET_KEY_123";
-    
-    if (CourseManager::saveCourseToBinary(m_course, BINARY_PATH, ENCRYPTION_KEY)) {
+    // Save only the changed chapter to the course journal and publish a new snapshot
+    if (CourseRepository::getInstance().saveChapter(m_currentChapterIndex, chapter)) {
         QMessageBox::information(this, "Успех", 
                                QString("Изменения в главе \"%1\" успешно сохранены!").arg(newTitle));
     } else {
@@ -6,6 +6,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTableView>
+#include <QTableWidget>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QListWidget>
@@ -14,19 +15,22 @@
 #include <QSplitter>
 #include <QMessageBox>
 #include <QFileDialog>
-#include <QSqlTableModel>
-#include <QSortFilterProxyModel>
+#include <QSqlRecord>
 #include <QHeaderView>
 #include <QFile>
 #include <QTextStream>
 #include <QSqlQuery>
+#include <QTimer>
 
 #include "models/Structures.h"
+#include "ui/UsersTableModel.h"
+#include "db/ReportGenerator.h"
+#include "db/UserImporter.h"
 
 /**
  * @brief Главное окно администратора.
  * Предоставляет интерфейс для управления студентами и редактирования курса.
- * Содержит две вкладки: просмотр студентов и редактор курса.
+ * Содержит три вкладки: просмотр студентов, статистику тестов и редактор курса.
  */
 class AdminWindow : public QMainWindow
 {
@@ -42,15 +46,90 @@ public:
 private slots:
     /**
      * @brief Обработчик изменения текста поиска студентов.
+     * Запускает поиск после паузы в наборе SEARCH_DEBOUNCE_MS.
      * @param text Новый текст для поиска
      */
     void onSearchTextChanged(const QString& text);
     
+    /**
+     * @brief Передает текст поиска модели пользователей.
+     */
+    void applySearch();
+    
     /**
      * @brief Обработчик нажатия кнопки генерации отчета.
+     * Запускает формирование отчета или отменяет уже запущенное.
      */
     void onGenerateReportClicked();
     
+    /**
+     * @brief Показывает ход формирования отчета.
+     * @param rowsWritten Записано строк
+     * @param totalRows Всего строк
+     */
+    void onReportProgress(qint64 rowsWritten, qint64 totalRows);
+    
+    /**
+     * @brief Обработчик успешного сохранения отчета.
+     * @param filePath Путь к файлу отчета
+     * @param totalRows Число пользователей в отчете
+     */
+    void onReportFinished(const QString& filePath, qint64 totalRows);
+    
+    /**
+     * @brief Обработчик ошибки формирования отчета.
+     * @param error Текст ошибки
+     */
+    void onReportFailed(const QString& error);
+    
+    /**
+     * @brief Обработчик отмены формирования отчета.
+     */
+    void onReportCanceled();
+    
+    /**
+     * @brief Обработчик нажатия кнопки импорта студентов из CSV.
+     * Запускает импорт или отменяет уже запущенный.
+     */
+    void onImportUsersClicked();
+    
+    /**
+     * @brief Показывает ход импорта.
+     * @param rowsHashed Обработано строк
+     * @param totalRows Всего строк
+     */
+    void onImportProgress(qint64 rowsHashed, qint64 totalRows);
+    
+    /**
+     * @brief Обработчик завершения импорта.
+     * @param imported Добавлено пользователей
+     * @param rejected Отклонено строк
+     * @param reportPath Путь к отчету об отклоненных строках
+     */
+    void onImportFinished(qint64 imported, qint64 rejected, const QString& reportPath);
+    
+    /**
+     * @brief Обработчик ошибки импорта.
+     * @param error Текст ошибки
+     */
+    void onImportFailed(const QString& error);
+    
+    /**
+     * @brief Обработчик отмены импорта.
+     */
+    void onImportCanceled();
+    
+    /**
+     * @brief Загружает сводку прохождения тестов по главам.
+     * Данные читаются из сводных таблиц, а не из журнала ответов.
+     */
+    void onRefreshStatisticsClicked();
+    
+    /**
+     * @brief Загружает сводку по вопросам выбранной главы.
+     */
+    void onStatisticsChapterSelected();
+    
     /**
      * @brief Обработчик изменения выбранной главы в редакторе.
      */
@@ -62,6 +141,9 @@ private slots:
     void onSaveChangesClicked();
 
 private:
+    // Пауза в наборе, после которой выполняется поиск
+    static constexpr int SEARCH_DEBOUNCE_MS = 250;
+    
     /**
      * @brief Настраивает пользовательский интерфейс.
      */
@@ -72,11 +154,26 @@ private:
      */
     void setupStudentsTab();
     
+    /**
+     * @brief Настраивает вкладку статистики тестов.
+     */
+    void setupStatisticsTab();
+    
     /**
      * @brief Настраивает вкладку редактора курса.
      */
     void setupCourseEditorTab();
     
+    /**
+     * @brief Возвращает кнопку отчета в исходное состояние.
+     */
+    void resetReportButton();
+    
+    /**
+     * @brief Возвращает кнопку импорта в исходное состояние.
+     */
+    void resetImportButton();
+    
     /**
      * @brief Загружает данные курса из файла.
      */
@@ -95,8 +192,18 @@ private:
     QTableView* m_studentsTableView;
     QLineEdit* m_searchLineEdit;
     QPushButton* m_reportButton;
-    QSqlTableModel* m_usersModel;
-    QSortFilterProxyModel* m_proxyModel;
+    ReportGenerator* m_reportGenerator;
+    QPushButton* m_importButton;
+    UserImporter* m_userImporter;
+    UsersTableModel* m_usersModel;
+    // Задержка поиска до окончания набора
+    QTimer* m_searchTimer;
+    
+    // Виджеты вкладки статистики
+    QWidget* m_statisticsTab;
+    QTableWidget* m_chapterStatsTable;
+    QTableWidget* m_questionStatsTable;
+    QPushButton* m_refreshStatsButton;
     
     // Виджеты вкладки редактора курса
     QWidget* m_courseEditorTab;
@@ -1,6 +1,6 @@
 #include "ui/LoginDialog.h"
 #include "db/DatabaseManager.h"
-#include "core/CryptoUtils.h"
+#include "core/PasswordHasher.h"
 
 LoginDialog::LoginDialog(QWidget* parent)
     : QDialog(parent), m_userId(-1) {
@@ -75,24 +75,32 @@ void LoginDialog::onLoginClicked() {
         return;
     }
 
-    // Хеширование пароля для безопасности
-    QString passwordHash = CryptoUtils::hashPassword(password);
-
-    // Аутентификация пользователя в базе данных
-    DatabaseManager& db = DatabaseManager::getInstance();
-    QPair<QString, int> authResult = db.authenticateUserWithId(login, passwordHash);
-
-    if (authResult.first.isEmpty() || authResult.second == -1) {
-        QMessageBox::warning(this, "Ошибка авторизации",
-                           "Неверный логин или пароль.\nПроверьте введенные данные и попробуйте снова.");
-        m_passwordEdit->clear();
-        m_passwordEdit->setFocus();
-        return;
-    }
-
-    m_userRole = authResult.first;
-    m_userId = authResult.second;
-    accept();
+    // Хеш читается в рабочем потоке базы данных, пароль проверяется
+    // в пуле PasswordHasher: диалог не блокируется
+    setBusy(true);
+    DatabaseManager::getInstance().authenticateUserWithIdAsync(login, password)
+        .then(this, [this](const DatabaseResult<QPair<QString, int>>& result) {
+            setBusy(false);
+
+            if (!result.ok()) {
+                QMessageBox::critical(this, "Ошибка базы данных",
+                                    QString("Не удалось выполнить авторизацию.\n\nОшибка: %1").arg(result.error));
+                return;
+            }
+
+            const QPair<QString, int>& authResult = result.value;
+            if (authResult.first.isEmpty() || authResult.second == -1) {
+                QMessageBox::warning(this, "Ошибка авторизации",
+                                   "Неверный логин или пароль.\nПроверьте введенные данные и попробуйте снова.");
+                m_passwordEdit->clear();
+                m_passwordEdit->setFocus();
+                return;
+            }
+
+            m_userRole = authResult.first;
+            m_userId = authResult.second;
+            accept();
+        });
 }
 
 void LoginDialog::onRegisterClicked() {
@@ -115,17 +123,38 @@ void LoginDialog::onRegisterClicked() {
         return;
     }
 
-    // Хеширование пароля перед сохранением
-    QString passwordHash = CryptoUtils::hashPassword(password);
-
-    // Регистрация пользователя с ролью "student" по умолчанию
-    DatabaseManager& db = DatabaseManager::getInstance();
-    if (db.registerUser(login, passwordHash, "student")) {
-        QMessageBox::information(this, "Успех",
-                               QString("Пользователь '%1' успешно зарегистрирован!\nТеперь вы можете войти в систему.").arg(login));
-        m_passwordEdit->clear();
-    } else {
-        QMessageBox::critical(this, "Ошибка регистрации",
-                            QString("Не удалось зарегистрировать пользователя.\nВозможно, такой логин уже существует.\n\nОшибка: %1").arg(db.getLastError()));
-    }
+    // Хеширование пароля перед сохранением (PBKDF2 в пуле PasswordHasher)
+    setBusy(true);
+    PasswordHasher::getInstance().hash(password)
+        .then(this, [this, login](const QString& passwordHash) {
+            if (passwordHash.isEmpty()) {
+                setBusy(false);
+                QMessageBox::warning(this, "Ошибка регистрации",
+                                   "Сервер перегружен, повторите попытку через несколько секунд.");
+                return;
+            }
+
+            // Регистрация пользователя с ролью "student" по умолчанию
+            DatabaseManager::getInstance().registerUserAsync(login, passwordHash, "student")
+                .then(this, [this, login](const DatabaseResult<bool>& result) {
+                    setBusy(false);
+
+                    if (result.value) {
+                        QMessageBox::information(this, "Успех",
+                                               QString("Пользователь '%1' успешно зарегистрирован!\nТеперь вы можете войти в систему.").arg(login));
+                        m_passwordEdit->clear();
+                    } else {
+                        QMessageBox::critical(this, "Ошибка регистрации",
+                                            QString("Не удалось зарегистрировать пользователя.\nВозможно, такой логин уже существует.\n\nОшибка: %1").arg(result.error));
+                    }
+                });
+        });
+}
+
+void LoginDialog::setBusy(bool busy) {
+    // Повторные нажатия во время запроса игнорируются
+    m_loginButton->setEnabled(!busy);
+    m_registerButton->setEnabled(!busy);
+    m_loginEdit->setEnabled(!busy);
+    m_passwordEdit->setEnabled(!busy);
 }
\ No newline at end of file
@@ -54,6 +54,12 @@ private:
      * @brief Настраивает пользовательский интерфейс диалога.
      */
     void setupUI();
+
+    /**
+     * @brief Блокирует элементы ввода на время запроса к базе данных.
+     * @param busy true пока запрос выполняется
+     */
+    void setBusy(bool busy);
     
     QLineEdit* m_loginEdit;
     QLineEdit* m_passwordEdit;
@@ -11,15 +11,31 @@ StudentWindow::StudentWindow(int userId, QWidget* parent)
     , m_answerGroup(nullptr)
     , m_answerButton(nullptr)
     , m_userId(userId)
-    , m_currentChapterIndex(0)
-    , m_currentQuestionIndex(0)
-    , m_errorsCount(0)
+    , m_sink(userId)
+    , m_engine(nullptr)
 {
     setWindowTitle("Система обучения HTTP Proxy - Студент");
     setMinimumSize(800, 600);
     
     setupUI();
-    loadCourse();
+    
+    // Между главами движок берет последний опубликованный снимок курса
+    m_engine = new QuizEngine([]() { return CourseRepository::getInstance().snapshot(); }, &m_sink, this);
+    connect(m_engine, &QuizEngine::chapterOpened, this, &StudentWindow::showTheoryPage);
+    connect(m_engine, &QuizEngine::questionShown, this, &StudentWindow::showQuestion);
+    connect(m_engine, &QuizEngine::answerWrong, this, &StudentWindow::onAnswerWrong);
+    connect(m_engine, &QuizEngine::testPassed, this, &StudentWindow::onTestPassed);
+    connect(m_engine, &QuizEngine::testFailed, this, &StudentWindow::onTestFailed);
+    connect(m_engine, &QuizEngine::courseCompleted, this, &StudentWindow::onCourseCompleted);
+    connect(m_engine, &QuizEngine::chapterUnreadable, this, &StudentWindow::onChapterUnreadable);
+    
+    if (!m_engine->hasCourse()) {
+        QMessageBox::critical(this, "Ошибка", "Не удалось загрузить данные курса!");
+        close();
+        return;
+    }
+    
+    qDebug() << "Course opened successfully with" << m_engine->chapterCount() << "chapters";
     initializeProgress();
 }
 
@@ -92,81 +108,41 @@ void StudentWindow::setupUI()
     m_stackedWidget->addWidget(m_testPage); // Индекс 1
 }
 
-void StudentWindow::loadCourse()
-{
-    const QString BINARY_PATH = "data/course.bin";
-    const QString ENCRYPTION_KEY = "SECRET_KEY_123";
-    
-    m_course = CourseManager::loadCourseFromBinary(BINARY_PATH, ENCRYPTION_KEY);
-    
-    if (m_course.chapters.isEmpty()) {
-        QMessageBox::critical(this, "Ошибка", "Не удалось загрузить данные курса!");
-        close();
-        return;
-    }
-    
-    qDebug() << "Course loaded successfully with" << m_course.chapters.size() << "chapters";
-}
-
 void StudentWindow::initializeProgress()
 {
-    DatabaseManager& db = DatabaseManager::getInstance();
-    QPair<int, QString> lastProgress = db.getLastProgress(m_userId);
-    
-    int lastChapterId = lastProgress.first;
-    QString lastStatus = lastProgress.second;
-    
-    if (lastChapterId == -1) {
-        // No progress found, start from beginning
-        m_currentChapterIndex = 0;
-    } else {
-        if (lastStatus == "completed") {
-            // Move to next chapter
-            m_currentChapterIndex = lastChapterId + 1;
-            if (m_currentChapterIndex >= m_course.chapters.size()) {
-                // Course completed
-                QMessageBox::information(this, "Поздравляем!", "Вы успешно завершили весь курс!");
-                m_currentChapterIndex = m_course.chapters.size() - 1; // Stay on last chapter
+    // Прогресс запрашивается в рабочем потоке базы данных, окно не блокируется
+    m_theoryBrowser->setHtml("<p>Загрузка прогресса...</p>");
+    m_takeTestButton->setEnabled(false);
+    
+    DatabaseManager::getInstance().getLastProgressAsync(m_userId)
+        .then(this, [this](const DatabaseResult<QPair<int, QString>>& result) {
+            if (!result.ok()) {
+                qWarning() << "Failed to load progress:" << result.error;
             }
-        } else {
-            // Continue from the same chapter (failed or new)
-            m_currentChapterIndex = lastChapterId;
-        }
-    }
-    
-    // Ensure chapter index is valid
-    if (m_currentChapterIndex < 0 || m_currentChapterIndex >= m_course.chapters.size()) {
-        m_currentChapterIndex = 0;
-    }
-    
-    showTheoryPage();
+            m_engine->start(result.value.first, result.value.second);
+        });
 }
 
-void StudentWindow::showTheoryPage()
+void StudentWindow::showTheoryPage(int chapterIndex)
 {
-    if (m_currentChapterIndex >= m_course.chapters.size()) {
-        QMessageBox::information(this, "Курс завершен", "Вы прошли все главы курса!");
-        return;
-    }
-    
-    const Chapter& currentChapter = m_course.chapters[m_currentChapterIndex];
+    const Chapter& chapter = m_engine->currentChapter();
     
     // Set window title with current chapter
     setWindowTitle(QString("Система обучения HTTP Proxy - Глава %1: %2")
-                   .arg(m_currentChapterIndex + 1)
-                   .arg(currentChapter.title));
+                   .arg(chapterIndex + 1)
+                   .arg(chapter.title));
     
     // Display theory content
     QString theoryContent = QString("<h2>Глава %1: %2</h2><br>%3")
-                           .arg(m_currentChapterIndex + 1)
-                           .arg(currentChapter.title)
-                           .arg(currentChapter.content);
+                           .arg(chapterIndex + 1)
+                           .arg(chapter.title)
+                           .arg(chapter.content);
     
     m_theoryBrowser->setHtml(theoryContent);
     
     // Enable test button only if there are questions
-    m_takeTestButton->setEnabled(!currentChapter.questions.isEmpty());
-    if (currentChapter.questions.isEmpty()) {
+    m_takeTestButton->setEnabled(!chapter.questions.isEmpty());
+    if (chapter.questions.isEmpty()) {
         m_takeTestButton->setText("Нет тестов для этой главы");
     } else {
         m_takeTestButton->setText("Пройти тест");
@@ -176,36 +152,10 @@ void StudentWindow::showTheoryPage()
     m_stackedWidget->setCurrentIndex(0);
 }
 
-void StudentWindow::showTestPage()
-{
-    m_currentQuestionIndex = 0;
-    m_errorsCount = 0;
-    loadCurrentQuestion();
-    m_stackedWidget->setCurrentIndex(1);
-}
-
-void StudentWindow::loadCurrentQuestion()
+void StudentWindow::showQuestion(int questionIndex)
 {
-    if (m_currentChapterIndex >= m_course.chapters.size()) {
-        return;
-    }
-    
-    const Chapter& currentChapter = m_course.chapters[m_currentChapterIndex];
-    
-    if (m_currentQuestionIndex >= currentChapter.questions.size()) {
-        // All questions answered correctly - test passed
-        DatabaseManager& db = DatabaseManager::getInstance();
-        db.saveProgress(m_userId, m_currentChapterIndex, 100, "completed");
-        
-        QMessageBox::information(this, "Тест пройден!", 
-                                QString("Поздравляем! Вы успешно прошли тест по главе %1.")
-                                .arg(m_currentChapterIndex + 1));
-        
-        moveToNextChapter();
-        return;
-    }
-    
-    const Question& currentQuestion = currentChapter.questions[m_currentQuestionIndex];
+    const Chapter& chapter = m_engine->currentChapter();
+    const Question& currentQuestion = chapter.questions[questionIndex];
     
     // Clear previous radio buttons
     for (QRadioButton* button : m_answerButtons) {
@@ -216,8 +166,8 @@ void StudentWindow::loadCurrentQuestion()
     
     // Set question text
     m_questionLabel->setText(QString("Вопрос %1 из %2:\n\n%3")
-                            .arg(m_currentQuestionIndex + 1)
-                            .arg(currentChapter.questions.size())
+                            .arg(questionIndex + 1)
+                            .arg(chapter.questions.size())
                             .arg(currentQuestion.q_text));
     
     // Create radio buttons for answers
@@ -235,36 +185,19 @@ void StudentWindow::loadCurrentQuestion()
             answersLayout->addWidget(radioButton);
         }
     }
+    
+    m_stackedWidget->setCurrentIndex(1);
 }
 
 void StudentWindow::onTakeTestClicked()
 {
-    if (m_currentChapterIndex >= m_course.chapters.size()) {
-        return;
-    }
-    
-    const Chapter& currentChapter = m_course.chapters[m_currentChapterIndex];
-    
-    if (currentChapter.questions.isEmpty()) {
+    if (!m_engine->startTest()) {
         QMessageBox::information(this, "Нет тестов", "Для этой главы нет тестовых вопросов.");
-        return;
     }
-    
-    showTestPage();
 }
 
 void StudentWindow::onAnswerClicked()
 {
-    if (m_currentChapterIndex >= m_course.chapters.size()) {
-        return;
-    }
-    
-    const Chapter& currentChapter = m_course.chapters[m_currentChapterIndex];
-    
-    if (m_currentQuestionIndex >= currentChapter.questions.size()) {
-        return;
-    }
-    
     // Check if an answer is selected
     int selectedAnswer = m_answerGroup->checkedId();
     if (selectedAnswer == -1) {
@@ -272,64 +205,46 @@ void StudentWindow::onAnswerClicked()
         return;
     }
     
-    const Question& currentQuestion = currentChapter.questions[m_currentQuestionIndex];
-    bool isCorrect = (selectedAnswer == currentQuestion.correct_index);
-    
-    processAnswer(isCorrect);
+    m_engine->answer(selectedAnswer);
 }
 
-void StudentWindow::processAnswer(bool isCorrect)
+void StudentWindow::onAnswerWrong(int errors, int maxErrors)
 {
-    if (isCorrect) {
-        // Correct answer - move to next question
-        m_currentQuestionIndex++;
-        loadCurrentQuestion();
-    } else {
-        // Wrong answer
-        m_errorsCount++;
-        
-        QMessageBox::warning(this, "Неверный ответ", 
-                           QString("Ответ неверный. Ошибок: %1 из 3 допустимых.")
-                           .arg(m_errorsCount));
-        
-        if (m_errorsCount >= 3) {
-            // Too many errors - reset to theory
-            DatabaseManager& db = DatabaseManager::getInstance();
-            db.saveProgress(m_userId, m_currentChapterIndex, 0, "fail");
-            
-            QMessageBox::critical(this, "Тест не пройден", 
-                                "Вы допустили 3 ошибки. Изучите теорию заново.");
-            
-            resetToTheory();
-        } else {
-            // Continue with same question
-            // Clear selection
-            m_answerGroup->setExclusive(false);
-            for (QRadioButton* button : m_answerButtons) {
-                button->setChecked(false);
-            }
-            m_answerGroup->setExclusive(true);
-        }
+    QMessageBox::warning(this, "Неверный ответ", 
+                       QString("Ответ неверный. Ошибок: %1 из %2 допустимых.")
+                       .arg(errors).arg(maxErrors));
+    
+    // Continue with same question: clear selection
+    m_answerGroup->setExclusive(false);
+    for (QRadioButton* button : m_answerButtons) {
+        button->setChecked(false);
     }
+    m_answerGroup->setExclusive(true);
 }
 
-void StudentWindow::resetToTheory()
+void StudentWindow::onTestPassed(int chapterIndex)
 {
-    m_errorsCount = 0;
-    m_currentQuestionIndex = 0;
-    showTheoryPage();
+    QMessageBox::information(this, "Тест пройден!", 
+                            QString("Поздравляем! Вы успешно прошли тест по главе %1.")
+                            .arg(chapterIndex + 1));
 }
 
-void StudentWindow::moveToNextChapter()
+void StudentWindow::onTestFailed(int chapterIndex, int errors)
 {
-    m_currentChapterIndex++;
-    
-    if (m_currentChapterIndex >= m_course.chapters.size()) {
-        // Course completed
-        QMessageBox::information(this, "Курс завершен!", 
-                               "Поздравляем! Вы успешно завершили весь курс обучения HTTP Proxy!");
-        m_currentChapterIndex = m_course.chapters.size() - 1; // Stay on last chapter
-    }
-    
-    showTheoryPage();
-}
\ No newline at end of file
+    Q_UNUSED(chapterIndex);
+    QMessageBox::critical(this, "Тест не пройден", 
+                        QString("Вы допустили %1 ошибки. Изучите теорию заново.").arg(errors));
+}
+
+void StudentWindow::onCourseCompleted()
+{
+    QMessageBox::information(this, "Курс завершен!", 
+                           "Поздравляем! Вы успешно завершили весь курс обучения HTTP Proxy!");
+}
+
+void StudentWindow::onChapterUnreadable(int chapterIndex, const QString& error)
+{
+    QMessageBox::warning(this, "Ошибка данных курса",
+                       QString("Глава %1 повреждена и не может быть показана:\n%2")
+                       .arg(chapterIndex + 1).arg(error));
+}
@@ -14,13 +14,16 @@
 #include <QDebug>
 
 #include "../models/Structures.h"
-#include "../core/CourseManager.h"
+#include "../core/CourseRepository.h"
+#include "../core/QuizEngine.h"
 #include "../db/DatabaseManager.h"
+#include "../db/DatabaseQuizSink.h"
 
 /**
  * @brief Главное окно студента.
  * Предоставляет интерфейс для изучения теоретического материала
- * и прохождения тестов по главам курса.
+ * и прохождения тестов по главам курса. Правила тестов и переходы между
+ * главами реализует QuizEngine, окно показывает его события.
  */
 class StudentWindow : public QMainWindow
 {
@@ -49,53 +52,41 @@ private slots:
      * @brief Обработчик выбора ответа на вопрос.
      */
     void onAnswerClicked();
-
-private:
-    /**
-     * @brief Настраивает пользовательский интерфейс.
-     */
-    void setupUI();
     
     /**
-     * @brief Загружает данные курса из файла.
+     * @brief Показывает страницу с теоретическим материалом главы.
+     * @param chapterIndex Индекс главы
      */
-    void loadCourse();
+    void showTheoryPage(int chapterIndex);
     
     /**
-     * @brief Инициализирует прогресс студента.
+     * @brief Показывает вопрос теста с вариантами ответов.
+     * @param questionIndex Индекс вопроса в главе
      */
-    void initializeProgress();
+    void showQuestion(int questionIndex);
     
     /**
-     * @brief Показывает страницу с теоретическим материалом.
+     * @brief Сообщает о неверном ответе и сбрасывает выбор.
+     * @param errors Ошибок в текущем тесте
+     * @param maxErrors Допустимое число ошибок
      */
-    void showTheoryPage();
-    
-    /**
-     * @brief Показывает страницу с тестом.
-     */
-    void showTestPage();
-    
-    /**
-     * @brief Загружает текущий вопрос теста.
-     */
-    void loadCurrentQuestion();
-    
-    /**
-     * @brief Обрабатывает ответ студента.
-     * @param isCorrect true если ответ правильный, false в противном случае
-     */
-    void processAnswer(bool isCorrect);
+    void onAnswerWrong(int errors, int maxErrors);
     
+    void onTestPassed(int chapterIndex);
+    void onTestFailed(int chapterIndex, int errors);
+    void onCourseCompleted();
+    void onChapterUnreadable(int chapterIndex, const QString& error);
+
+private:
     /**
-     * @brief Возвращает к изучению теории.
+     * @brief Настраивает пользовательский интерфейс.
      */
-    void resetToTheory();
+    void setupUI();
     
     /**
-     * @brief Переходит к следующей главе курса.
+     * @brief Запрашивает прогресс студента без блокировки окна.
      */
-    void moveToNextChapter();
+    void initializeProgress();
     
     // Компоненты интерфейса
     QStackedWidget* m_stackedWidget;
@@ -112,12 +103,11 @@ private:
     QList<QRadioButton*> m_answerButtons;
     QPushButton* m_answerButton;
     
-    // Переменные состояния
     int m_userId;
-    int m_currentChapterIndex;
-    int m_currentQuestionIndex;
-    int m_errorsCount;
-    Course m_course;
+    // Ответы и итоги тестов сохраняются в базе данных
+    DatabaseQuizSink m_sink;
+    // Логика прохождения курса; окно только показывает ее состояние
+    QuizEngine* m_engine;
 };
 
 #endif // STUDENTWINDOW_H
\ No newline at end of file
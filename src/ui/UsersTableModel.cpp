@@ -0,0 +1,217 @@
+#include "ui/UsersTableModel.h"
+
+UsersTableModel::UsersTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_useCounter(0)
+    , m_rowCount(0)
+    , m_loadedPages(0)
+    , m_atEnd(false)
+    , m_sortColumn(IdColumn)
+    , m_sortOrder(Qt::AscendingOrder)
+    , m_generation(0) {
+    m_pageStarts.append(PageStart());
+}
+
+int UsersTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int UsersTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant UsersTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const int page = index.row() / PAGE_SIZE;
+    auto it = m_pages.find(page);
+    if (it == m_pages.end()) {
+        // Страница была выгружена: запрашиваем ее заново, пока показываем пустую строку
+        const_cast<UsersTableModel*>(this)->requestPage(page);
+        return QVariant();
+    }
+
+    it->lastUsed = ++m_useCounter;
+    const int row = index.row() % PAGE_SIZE;
+    if (row >= it->rows.size()) {
+        return QVariant();
+    }
+    return it->rows.at(row).value(index.column());
+}
+
+QVariant UsersTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case IdColumn: return "ID";
+    case LoginColumn: return "Login";
+    case PasswordHashColumn: return "Password Hash";
+    case RoleColumn: return "Role";
+    case CreatedAtColumn: return "Created At";
+    default: return QVariant();
+    }
+}
+
+bool UsersTableModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !m_atEnd;
+}
+
+void UsersTableModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid() || m_atEnd) {
+        return;
+    }
+    requestPage(m_loadedPages);
+}
+
+void UsersTableModel::sort(int column, Qt::SortOrder order) {
+    // Сортировка по хешу пароля не имеет смысла и не поддерживается индексом
+    if (column < 0 || column >= ColumnCount || column == PasswordHashColumn) {
+        return;
+    }
+
+    m_sortColumn = column;
+    m_sortOrder = order;
+    refresh();
+}
+
+void UsersTableModel::setLoginFilter(const QString& text) {
+    if (text == m_loginFilter) {
+        return;
+    }
+
+    m_loginFilter = text;
+    refresh();
+}
+
+void UsersTableModel::refresh() {
+    // Ответы прежней выборки больше не нужны
+    for (const auto& future : std::as_const(m_loadingPages)) {
+        DatabaseManager::getInstance().cancelAsync(future);
+    }
+
+    beginResetModel();
+    m_generation++;
+    m_pageStarts.clear();
+    m_pageStarts.append(PageStart());
+    m_pages.clear();
+    m_loadingPages.clear();
+    m_rowCount = 0;
+    m_loadedPages = 0;
+    m_atEnd = false;
+    endResetModel();
+
+    requestPage(0);
+}
+
+void UsersTableModel::requestPage(int page) {
+    if (page >= m_pageStarts.size() || m_loadingPages.contains(page)) {
+        return;
+    }
+
+    const PageStart& start = m_pageStarts.at(page);
+
+    UsersPageQuery pageQuery;
+    pageQuery.sortColumn = sortColumnName();
+    pageQuery.descending = (m_sortOrder == Qt::DescendingOrder);
+    pageQuery.hasAfter = start.valid;
+    pageQuery.afterValue = start.value;
+    pageQuery.afterId = start.id;
+    pageQuery.limit = PAGE_SIZE;
+    pageQuery.loginFilter = m_loginFilter;
+
+    const quint64 generation = m_generation;
+
+    QFuture<DatabaseResult<QList<QSqlRecord>>> future = DatabaseManager::getInstance().getUsersPageAsync(pageQuery);
+    m_loadingPages.insert(page, future);
+
+    future.then(this, [this, page, generation](const DatabaseResult<QList<QSqlRecord>>& result) {
+        if (generation != m_generation) {
+            return;
+        }
+        m_loadingPages.remove(page);
+
+        if (!result.ok()) {
+            qWarning() << "Failed to load users page" << page << ":" << result.error;
+            // Без этого представление повторяло бы запрос бесконечно
+            if (page == m_loadedPages) {
+                m_atEnd = true;
+            }
+            emit loadFailed(result.error);
+            return;
+        }
+
+        onPageLoaded(page, result.value);
+    });
+}
+
+void UsersTableModel::onPageLoaded(int page, const QList<QSqlRecord>& rows) {
+    Page loaded;
+    loaded.rows = rows;
+    loaded.lastUsed = ++m_useCounter;
+
+    if (page == m_loadedPages) {
+        // Новая страница в конце таблицы
+        if (!rows.isEmpty()) {
+            beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + static_cast<int>(rows.size()) - 1);
+            m_pages.insert(page, loaded);
+            m_rowCount += static_cast<int>(rows.size());
+            m_loadedPages++;
+            endInsertRows();
+        }
+
+        if (rows.size() == PAGE_SIZE) {
+            m_pageStarts.append(keyOf(rows.last()));
+        } else {
+            m_atEnd = true;
+        }
+    } else if (page < m_loadedPages) {
+        // Повторная загрузка выгруженной страницы; число строк таблицы не меняется,
+        // даже если с тех пор пользователи были добавлены или удалены
+        m_pages.insert(page, loaded);
+        const int firstRow = page * PAGE_SIZE;
+        const int lastRow = qMin(m_rowCount, firstRow + PAGE_SIZE) - 1;
+        emit dataChanged(index(firstRow, 0), index(lastRow, ColumnCount - 1));
+    }
+
+    evictPages(page);
+}
+
+void UsersTableModel::evictPages(int keepPage) {
+    while (m_pages.size() > MAX_CACHED_PAGES) {
+        int oldestPage = -1;
+        quint64 oldestUse = 0;
+        for (auto it = m_pages.cbegin(); it != m_pages.cend(); ++it) {
+            if (it.key() != keepPage && (oldestPage < 0 || it->lastUsed < oldestUse)) {
+                oldestPage = it.key();
+                oldestUse = it->lastUsed;
+            }
+        }
+
+        if (oldestPage < 0) {
+            return;
+        }
+        m_pages.remove(oldestPage);
+    }
+}
+
+QString UsersTableModel::sortColumnName() const {
+    switch (m_sortColumn) {
+    case LoginColumn: return "login";
+    case RoleColumn: return "role";
+    case CreatedAtColumn: return "created_at";
+    default: return "id";
+    }
+}
+
+UsersTableModel::PageStart UsersTableModel::keyOf(const QSqlRecord& record) const {
+    PageStart start;
+    start.valid = true;
+    // Не значение столбца таблицы: created_at в нем округлен до миллисекунд
+    start.value = record.value("page_key");
+    start.id = record.value(IdColumn).toInt();
+    return start;
+}
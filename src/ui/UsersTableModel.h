@@ -0,0 +1,126 @@
+#ifndef USERSTABLEMODEL_H
+#define USERSTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSqlRecord>
+#include <QVariant>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QFuture>
+
+#include "db/DatabaseManager.h"
+
+/**
+ * @brief Модель таблицы пользователей с постраничной загрузкой с сервера.
+ * Строки запрашиваются страницами по PAGE_SIZE через keyset-пагинацию
+ * (WHERE key > ? ORDER BY key LIMIT n) в рабочем потоке DatabaseManager.
+ * Представление подгружает следующие страницы через canFetchMore()/fetchMore(),
+ * сортировка и фильтр по логину выполняются в SQL.
+ *
+ * В памяти хранится не больше MAX_CACHED_PAGES страниц: давно не
+ * отображавшиеся страницы выгружаются, от них остается только ключ начала.
+ * При обращении к выгруженной странице она запрашивается заново по этому ключу.
+ *
+ * Смена фильтра или сортировки отменяет запросы прежней выборки, в том числе
+ * уже выполняемый на сервере.
+ */
+class UsersTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        LoginColumn,
+        PasswordHashColumn,
+        RoleColumn,
+        CreatedAtColumn,
+        ColumnCount
+    };
+
+    // Строк в одной странице
+    static constexpr int PAGE_SIZE = 200;
+    // Страниц, одновременно хранящихся в памяти
+    static constexpr int MAX_CACHED_PAGES = 10;
+
+    explicit UsersTableModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief Меняет порядок сортировки и загружает таблицу заново.
+     * @param column Столбец сортировки
+     * @param order Направление сортировки
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /**
+     * @brief Оставляет только пользователей, логин которых содержит текст.
+     * @param text Текст для поиска, пустая строка снимает фильтр
+     */
+    void setLoginFilter(const QString& text);
+
+    /**
+     * @brief Сбрасывает загруженные строки и запрашивает первую страницу.
+     */
+    void refresh();
+
+signals:
+    /**
+     * @brief Сигнал об ошибке загрузки страницы.
+     * @param message Текст ошибки
+     */
+    void loadFailed(const QString& message);
+
+private:
+    /**
+     * @brief Ключ строки, после которой начинается страница.
+     */
+    struct PageStart {
+        bool valid;
+        QVariant value;
+        int id;
+
+        PageStart() : valid(false), id(0) {}
+    };
+
+    struct Page {
+        QList<QSqlRecord> rows;
+        quint64 lastUsed;
+
+        Page() : lastUsed(0) {}
+    };
+
+    void requestPage(int page);
+    void onPageLoaded(int page, const QList<QSqlRecord>& rows);
+    void evictPages(int keepPage);
+    QString sortColumnName() const;
+    PageStart keyOf(const QSqlRecord& record) const;
+
+    // Ключ начала каждой загруженной страницы и следующей за ними
+    QList<PageStart> m_pageStarts;
+    // Страницы, находящиеся в памяти
+    mutable QHash<int, Page> m_pages;
+    // Запросы страниц, ожидающие ответа
+    QHash<int, QFuture<DatabaseResult<QList<QSqlRecord>>>> m_loadingPages;
+    mutable quint64 m_useCounter;
+
+    int m_rowCount;
+    int m_loadedPages;
+    bool m_atEnd;
+
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+    QString m_loginFilter;
+    // Номер выборки: ответы, пришедшие после смены сортировки или фильтра, отбрасываются
+    quint64 m_generation;
+};
+
+#endif // USERSTABLEMODEL_H
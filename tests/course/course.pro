@@ -0,0 +1,17 @@
+# Формат файла курса: чтение форматов v1-v4, ядра XOR и CRC32C,
+# замеры загрузки и шифрования
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_course
+TEMPLATE = app
+
+include(../../src/core/core.pri)
+
+# Исходный курс data/course_source.json
+DEFINES += SOURCE_DIR=\\\"$$PWD/../..\\\"
+
+SOURCES += \
+    tst_course.cpp
@@ -0,0 +1,1137 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "core/CourseManager.h"
+#include "core/CourseImage.h"
+#include "core/CourseJournal.h"
+#include "core/CourseFormat.h"
+#include "core/CryptoUtils.h"
+#include "core/ChapterCodec.h"
+#include "core/CipherPipeline.h"
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#include <malloc.h>
+#include <atomic>
+#define COURSE_TEST_HEAP_COUNTERS
+
+// Функции glibc, через которые тест считает выделения кучи
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace {
+
+// Счетчики работают только во время замера (startHeapCounting/stopHeapCounting)
+std::atomic<bool> heapCounting(false);
+std::atomic<qint64> heapAllocations(0);
+std::atomic<qint64> heapReleases(0);
+
+inline void countAllocation() {
+    if (heapCounting.load(std::memory_order_relaxed)) {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+// malloc и free исполняемого файла заменяют функции glibc для всего процесса,
+// в том числе для выделений внутри Qt и libstdc++
+extern "C" void* malloc(size_t size) {
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+    if (!pointer) {
+        countAllocation();
+    }
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer) {
+    if (pointer && heapCounting.load(std::memory_order_relaxed)) {
+        heapReleases.fetch_add(1, std::memory_order_relaxed);
+    }
+    __libc_free(pointer);
+}
+#endif
+
+/**
+ * @brief Проверки формата файла курса.
+ * Файлы v1-v3 пишутся в тесте вручную по описанию в CourseFormat.h,
+ * v4 - через CourseManager. Векторные ядра XOR и CRC32C сравниваются
+ * со скалярными эталонами, PBKDF2 - с контрольными значениями RFC 7914.
+ * Тесты corrupted* портят один байт файла или
+ * журнала и проверяют, что ошибка указывает на место повреждения.
+ * Тесты *Benchmark замеряют время до первой главы для v1 и v4 на
+ * синтетическом курсе из 5000 глав, долю проверки контрольных сумм
+ * во времени загрузки, масштабирование загрузки и сохранения по числу
+ * потоков, компиляцию большого JSON, сжатие кодеков и скорость XOR,
+ * а также число выделений кучи и резидентную память Course и
+ * CompactCourse для курса из 100 тысяч вопросов.
+ */
+class CourseFormatTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void roundTripV1();
+    void roundTripV2();
+    void roundTripV3_data();
+    void roundTripV3();
+    void roundTripV4_data();
+    void roundTripV4();
+    void compileMatchesSave();
+    void compileWithByteOrderMark();
+
+    void xorKernelMatchesScalar();
+    void xorEncryptDecryptMatchesKernel();
+    void crc32cKernelMatchesTable();
+    void pbkdf2KnownAnswer_data();
+    void pbkdf2KnownAnswer();
+    void passwordHashRoundTrip();
+    void legacySha256Password();
+    void passwordNeedsRehash();
+
+    void corruptedHeader();
+    void corruptedIndex();
+    void corruptedBlock();
+    void corruptedJournalRecord();
+
+    void firstChapterBenchmark_data();
+    void firstChapterBenchmark();
+    void checksumOverheadBenchmark();
+    void loadSaveScalingBenchmark_data();
+    void loadSaveScalingBenchmark();
+    void jsonCompileBenchmark_data();
+    void jsonCompileBenchmark();
+    void codecBenchmark_data();
+    void codecBenchmark();
+    void xorThroughputBenchmark_data();
+    void xorThroughputBenchmark();
+    void compactCourseMemoryBenchmark_data();
+    void compactCourseMemoryBenchmark();
+
+private:
+    /**
+     * @brief Записывает курс в формате v1: MAGIC_V1 и один зашифрованный QByteArray.
+     */
+    bool writeV1(const Course& course, const QString& path);
+
+    /**
+     * @brief Записывает курс в индексированном формате v2 или v3 (без контрольных сумм).
+     */
+    bool writeIndexed(const Course& course, const QString& path, quint32 version, quint32 codecId);
+
+    /**
+     * @brief Получает файл синтетического курса из 5000 глав, создает его при первом вызове.
+     */
+    QString largeCoursePath(int version);
+
+    /**
+     * @brief Записывает исправный файл v4 для теста повреждения.
+     */
+    QString corruptibleCopy(const QString& name);
+
+    static bool flipByte(const QString& path, qint64 offset);
+    static qint64 indexOffset(const QString& path);
+    static CourseFormat::IndexEntry indexEntry(const QString& path, int index);
+    static Course makeCourse(int chapterCount, int contentSize);
+    static bool sameChapter(const Chapter& left, const Chapter& right);
+    static bool sameCourse(const Course& left, const Course& right);
+    static bool readAll(const QString& path, Course& course, int expectedVersion);
+    static QByteArray randomBytes(qsizetype size);
+    static qint64 residentBytes();
+    static qint64 peakResidentBytes();
+    static void resetPeakResident();
+    static void releaseFreeHeap();
+    static void startHeapCounting();
+    static void stopHeapCounting(qint64* allocations, qint64* releases);
+    static bool writeSyntheticJson(const QString& path, qint64 targetBytes);
+
+    QTemporaryDir m_directory;
+    Course m_course;
+    Course m_largeCourse;
+    Course m_scalingCourse;
+    qint64 m_singleThreadSaveNs = 0;
+    qint64 m_singleThreadLoadNs = 0;
+    const QString m_key = QStringLiteral(COURSE_ENCRYPTION_KEY);
+};
+
+void CourseFormatTest::initTestCase() {
+    QVERIFY(m_directory.isValid());
+
+    m_course = makeCourse(3, 200);
+    // Глава без вопросов и пустые строки тоже должны пережить запись
+    m_course.chapters.append(Chapter(100, QString(), QString()));
+}
+
+void CourseFormatTest::roundTripV1() {
+    const QString path = m_directory.filePath("v1.bin");
+    QVERIFY(writeV1(m_course, path));
+
+    Course course;
+    QVERIFY(readAll(path, course, 1));
+    QVERIFY(sameCourse(course, m_course));
+
+    QString error;
+    course = CourseManager::loadCourseFromBinary(path, m_key, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY(sameCourse(course, m_course));
+}
+
+void CourseFormatTest::roundTripV2() {
+    const QString path = m_directory.filePath("v2.bin");
+    QVERIFY(writeIndexed(m_course, path, 2, ChapterCodec::None));
+
+    Course course;
+    QVERIFY(readAll(path, course, 2));
+    QVERIFY(sameCourse(course, m_course));
+}
+
+void CourseFormatTest::roundTripV3_data() {
+    QTest::addColumn<quint32>("codecId");
+    for (const ChapterCodec* codec : ChapterCodec::available()) {
+        QTest::newRow(codec->name) << codec->id;
+    }
+}
+
+void CourseFormatTest::roundTripV3() {
+    QFETCH(quint32, codecId);
+
+    const QString path = m_directory.filePath(QString("v3_%1.bin").arg(codecId));
+    QVERIFY(writeIndexed(m_course, path, 3, codecId));
+
+    Course course;
+    QVERIFY(readAll(path, course, 3));
+    QVERIFY(sameCourse(course, m_course));
+}
+
+void CourseFormatTest::roundTripV4_data() {
+    roundTripV3_data();
+}
+
+void CourseFormatTest::roundTripV4() {
+    QFETCH(quint32, codecId);
+
+    const QString path = m_directory.filePath(QString("v4_%1.bin").arg(codecId));
+    QVERIFY(CourseManager::saveCourseToBinary(m_course, path, m_key, codecId));
+
+    Course course;
+    QVERIFY(readAll(path, course, 4));
+    QVERIFY(sameCourse(course, m_course));
+
+    QStringList errors;
+    QVERIFY2(CourseManager::verifyCourseFile(path, m_key, &errors), qPrintable(errors.join("; ")));
+
+    QString error;
+    course = CourseManager::loadCourseFromBinary(path, m_key, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY(sameCourse(course, m_course));
+}
+
+void CourseFormatTest::compileMatchesSave() {
+    // Потоковая компиляция JSON должна давать тот же файл, что и загрузка с сохранением
+    const QString jsonPath = QStringLiteral(SOURCE_DIR "/data/course_source.json");
+    const Course course = CourseManager::loadCourseFromJSON(jsonPath);
+    QVERIFY(!course.chapters.isEmpty());
+
+    const QString savedPath = m_directory.filePath("saved.bin");
+    const QString compiledPath = m_directory.filePath("compiled.bin");
+    QVERIFY(CourseManager::saveCourseToBinary(course, savedPath, m_key));
+    QVERIFY(CourseManager::compileJsonToBinary(jsonPath, compiledPath, m_key));
+
+    QFile saved(savedPath);
+    QFile compiled(compiledPath);
+    QVERIFY(saved.open(QIODevice::ReadOnly));
+    QVERIFY(compiled.open(QIODevice::ReadOnly));
+    QVERIFY(saved.readAll() == compiled.readAll());
+
+    Course loaded;
+    QVERIFY(readAll(compiledPath, loaded, 4));
+    QVERIFY(sameCourse(loaded, course));
+}
+
+void CourseFormatTest::compileWithByteOrderMark() {
+    // Файл, сохраненный редактором с меткой порядка байт UTF-8
+    const QString jsonPath = QStringLiteral(SOURCE_DIR "/data/course_source.json");
+    QFile source(jsonPath);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    const QString bomPath = m_directory.filePath("bom.json");
+    QFile bomFile(bomPath);
+    QVERIFY(bomFile.open(QIODevice::WriteOnly));
+    bomFile.write("\xEF\xBB\xBF");
+    bomFile.write(source.readAll());
+    bomFile.close();
+
+    const QString plainPath = m_directory.filePath("plain.bin");
+    const QString bomBinPath = m_directory.filePath("bom.bin");
+    QVERIFY(CourseManager::compileJsonToBinary(jsonPath, plainPath, m_key));
+    QVERIFY(CourseManager::compileJsonToBinary(bomPath, bomBinPath, m_key));
+
+    QFile plain(plainPath);
+    QFile compiled(bomBinPath);
+    QVERIFY(plain.open(QIODevice::ReadOnly));
+    QVERIFY(compiled.open(QIODevice::ReadOnly));
+    QVERIFY(plain.readAll() == compiled.readAll());
+    QCOMPARE(CourseManager::loadCourseFromJSON(bomPath).chapters.size(),
+             CourseManager::loadCourseFromJSON(jsonPath).chapters.size());
+}
+
+void CourseFormatTest::xorKernelMatchesScalar() {
+    qInfo() << "XOR kernel:" << CryptoUtils::xorKernelName();
+
+    // Ключи короче, равные и длиннее вектора AVX2, в том числе многобайтовый UTF-8
+    const QStringList keys = {"k", "SECRET_KEY_123", QString(32, QLatin1Char('x')),
+                              QString::fromUtf8("ключ-шифрования-курса-длиннее-одного-вектора")};
+    const QByteArray source = randomBytes(1024);
+
+    for (const QString& keyText : keys) {
+        const XorKey key(keyText);
+        for (qsizetype size : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 255, 256, 1000}) {
+            // Невыровненное начало буфера и разные фазы ключа
+            for (int start : {0, 1, 7, 13}) {
+                for (qint64 keyOffset : {qint64(0), qint64(1), qint64(5), qint64(key.size() - 1), qint64(1) << 33}) {
+                    QByteArray expected = source;
+                    QByteArray actual = source;
+                    CryptoUtils::xorInPlaceScalar(expected.data() + start, size, key, keyOffset);
+                    CryptoUtils::xorInPlace(actual.data() + start, size, key, keyOffset);
+                    QVERIFY2(actual == expected,
+                             qPrintable(QString("key %1, size %2, start %3, key offset %4")
+                                            .arg(keyText).arg(size).arg(start).arg(keyOffset)));
+                }
+            }
+        }
+    }
+}
+
+void CourseFormatTest::xorEncryptDecryptMatchesKernel() {
+    const QByteArray source = randomBytes(4096 + 3);
+    const XorKey key(m_key);
+
+    QByteArray expected = source;
+    CryptoUtils::xorInPlaceScalar(expected.data(), expected.size(), key);
+    const QByteArray encrypted = CryptoUtils::xorEncryptDecrypt(source, m_key);
+    QVERIFY(encrypted == expected);
+    QVERIFY(CryptoUtils::xorEncryptDecrypt(encrypted, m_key) == source);
+}
+
+void CourseFormatTest::crc32cKernelMatchesTable() {
+    qInfo() << "CRC32C kernel:" << CryptoUtils::crc32cKernelName();
+
+    // Контрольное значение CRC32C из RFC 3720
+    QCOMPARE(CryptoUtils::crc32c("123456789", 9), 0xE3069283u);
+    QCOMPARE(CryptoUtils::crc32cTable("123456789", 9), 0xE3069283u);
+
+    const QByteArray source = randomBytes(4096);
+    for (qsizetype size : {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 4000}) {
+        for (int start : {0, 1, 3, 5}) {
+            const char* data = source.constData() + start;
+            QCOMPARE(CryptoUtils::crc32c(data, size), CryptoUtils::crc32cTable(data, size));
+
+            // Сумма, продолженная по частям, совпадает с суммой целиком
+            const qsizetype half = size / 2;
+            QCOMPARE(CryptoUtils::crc32c(data + half, size - half, CryptoUtils::crc32c(data, half)),
+                     CryptoUtils::crc32cTable(data, size));
+        }
+    }
+}
+
+void CourseFormatTest::pbkdf2KnownAnswer_data() {
+    QTest::addColumn<QByteArray>("password");
+    QTest::addColumn<QByteArray>("salt");
+    QTest::addColumn<int>("iterations");
+    QTest::addColumn<QByteArray>("expected");
+
+    // Контрольные значения PBKDF2-HMAC-SHA256 из RFC 7914, раздел 11
+    QTest::newRow("rfc7914 c=1") << QByteArray("passwd") << QByteArray("salt") << 1
+        << QByteArray::fromHex("55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+                               "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+    QTest::newRow("rfc7914 c=80000") << QByteArray("Password") << QByteArray("NaCl") << 80000
+        << QByteArray::fromHex("4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+                               "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d");
+    // Пароль длиннее блока HMAC заменяется своим хешем
+    QTest::newRow("long password") << QByteArray(100, 'p') << QByteArray("salt") << 2
+        << QByteArray::fromHex("7fb39a0c2291de62231e50ab5f6805b83bab97446d73dccf38114fb21c055427");
+}
+
+void CourseFormatTest::pbkdf2KnownAnswer() {
+    QFETCH(QByteArray, password);
+    QFETCH(QByteArray, salt);
+    QFETCH(int, iterations);
+    QFETCH(QByteArray, expected);
+
+    QCOMPARE(CryptoUtils::pbkdf2Sha256(password, salt, iterations, expected.size()).toHex(), expected.toHex());
+}
+
+void CourseFormatTest::passwordHashRoundTrip() {
+    const QString password = QString::fromUtf8("пароль-студента");
+    const QString hash = CryptoUtils::hashPassword(password, 1000);
+
+    QVERIFY(hash.startsWith("$pbkdf2-sha256$1000$"));
+    QVERIFY(CryptoUtils::verifyPassword(password, hash));
+    QVERIFY(!CryptoUtils::verifyPassword(password + "x", hash));
+    QVERIFY(!CryptoUtils::verifyPassword(QString(), hash));
+
+    // Соль случайная: одинаковые пароли дают разные хеши
+    const QString other = CryptoUtils::hashPassword(password, 1000);
+    QVERIFY(other != hash);
+    QVERIFY(CryptoUtils::verifyPassword(password, other));
+
+    // Поврежденный хеш не принимается
+    QVERIFY(!CryptoUtils::verifyPassword(password, "$pbkdf2-sha256$1000$broken"));
+    QVERIFY(!CryptoUtils::verifyPassword(password, "$pbkdf2-sha256$0$c2FsdA==$a2V5"));
+}
+
+void CourseFormatTest::legacySha256Password() {
+    // Прежний формат: несоленый SHA-256 в hex, регистр не важен
+    const QString legacy = "8c6976e5b5410415bde908bd4dee15dfb167a9c873fc4bb8a81f6f2ab448a918";
+    QVERIFY(CryptoUtils::verifyPassword("admin", legacy));
+    QVERIFY(CryptoUtils::verifyPassword("admin", legacy.toUpper()));
+    QVERIFY(!CryptoUtils::verifyPassword("Admin", legacy));
+    QVERIFY(!CryptoUtils::verifyPassword("admin", legacy.left(63)));
+}
+
+void CourseFormatTest::passwordNeedsRehash() {
+    const QString hash = CryptoUtils::hashPassword("secret", 1000);
+
+    QVERIFY(!CryptoUtils::needsRehash(hash, 1000));
+    QVERIFY(!CryptoUtils::needsRehash(hash, 500));
+    QVERIFY(CryptoUtils::needsRehash(hash, 1001));
+    QCOMPARE(CryptoUtils::needsRehash(hash), 1000 < CryptoUtils::passwordIterations());
+
+    // Прежний SHA-256 и неразобранные хеши пересчитываются всегда
+    QVERIFY(CryptoUtils::needsRehash("8c6976e5b5410415bde908bd4dee15dfb167a9c873fc4bb8a81f6f2ab448a918", 1));
+    QVERIFY(CryptoUtils::needsRehash("$pbkdf2-sha256$abc$c2FsdA==$a2V5", 1));
+}
+
+void CourseFormatTest::corruptedHeader() {
+    const QString path = corruptibleCopy("corrupted_header.bin");
+    QVERIFY(!path.isEmpty());
+    // Байт контрольной суммы заголовка
+    QVERIFY(flipByte(path, CourseFormat::HEADER_SIZE_V3));
+
+    CourseImage image;
+    QVERIFY(!image.open(path, m_key));
+
+    QStringList errors;
+    QVERIFY(!CourseManager::verifyCourseFile(path, m_key, &errors));
+    QCOMPARE(errors.size(), 1);
+    QVERIFY2(errors.first().contains("header is corrupted") && errors.first().contains(path),
+             qPrintable(errors.first()));
+
+    QString error;
+    QVERIFY(CourseManager::loadCourseFromBinary(path, m_key, &error).chapters.isEmpty());
+    QVERIFY2(error.contains(path), qPrintable(error));
+}
+
+void CourseFormatTest::corruptedIndex() {
+    const QString path = corruptibleCopy("corrupted_index.bin");
+    QVERIFY(!path.isEmpty());
+
+    // Младший байт длины блока главы 1: индекс покрыт суммой заголовка
+    const qint64 offset = indexOffset(path);
+    QVERIFY(offset > 0);
+    QVERIFY(flipByte(path, offset + CourseFormat::INDEX_ENTRY_SIZE + 11));
+
+    CourseImage image;
+    QVERIFY(!image.open(path, m_key));
+
+    QStringList errors;
+    QVERIFY(!CourseManager::verifyCourseFile(path, m_key, &errors));
+    QCOMPARE(errors.size(), 1);
+    QVERIFY2(errors.first().contains(path), qPrintable(errors.first()));
+}
+
+void CourseFormatTest::corruptedBlock() {
+    const QString path = corruptibleCopy("corrupted_block.bin");
+    QVERIFY(!path.isEmpty());
+    const CourseFormat::IndexEntry entry = indexEntry(path, 1);
+    QVERIFY(entry.length > 0);
+    QVERIFY(flipByte(path, static_cast<qint64>(entry.offset + entry.length / 2)));
+
+    const QString location = QString("file offset %1, length %2").arg(entry.offset).arg(entry.length);
+
+    // Заголовок цел: файл открывается, поврежденная глава обнаруживается при чтении
+    CourseImage image;
+    QVERIFY(image.open(path, m_key));
+
+    Chapter chapter;
+    QString error;
+    QVERIFY2(image.readChapter(0, chapter, &error), qPrintable(error));
+    QVERIFY(sameChapter(chapter, m_course.chapters.at(0)));
+
+    chapter = Chapter();
+    QVERIFY(!image.readChapter(1, chapter, &error));
+    QVERIFY2(error.contains("Chapter 1") && error.contains(location), qPrintable(error));
+    QCOMPARE(chapter.id, 0);
+
+    QStringList errors;
+    QVERIFY(!image.verify(&errors));
+    QCOMPARE(errors.size(), 1);
+    QVERIFY2(errors.first().contains(location), qPrintable(errors.first()));
+
+    errors.clear();
+    QVERIFY(!CourseManager::verifyCourseFile(path, m_key, &errors));
+    QCOMPARE(errors.size(), 1);
+
+    // Курс не загружается частично, ошибка называет файл и блок
+    error.clear();
+    QVERIFY(CourseManager::loadCourseFromBinary(path, m_key, &error).chapters.isEmpty());
+    QVERIFY2(error.contains(path) && error.contains(location), qPrintable(error));
+}
+
+void CourseFormatTest::corruptedJournalRecord() {
+    const QString path = corruptibleCopy("corrupted_journal.bin");
+    QVERIFY(!path.isEmpty());
+
+    Chapter edited = m_course.chapters.at(2);
+    edited.content = "Исправленное содержание";
+    QVERIFY(CourseJournal::appendChapter(path, 2, edited, m_key));
+
+    CourseImage image;
+    Chapter chapter;
+    QVERIFY(image.open(path, m_key));
+    QVERIFY(image.readChapter(2, chapter));
+    QVERIFY(sameChapter(chapter, edited));
+    image.close();
+
+    // Положение блока записи в журнале
+    QFile journal(CourseJournal::journalPath(path));
+    QVERIFY(journal.open(QIODevice::ReadOnly));
+    const QByteArray journalData = journal.readAll();
+    journal.close();
+    const QVector<CourseJournal::Record> records =
+        CourseJournal::parseRecords(reinterpret_cast<const uchar*>(journalData.constData()), journalData.size());
+    QCOMPARE(records.size(), 1);
+    const CourseJournal::Record record = records.first();
+    QVERIFY(flipByte(journal.fileName(), record.offset + record.length - 1));
+
+    const QString location = QString("journal offset %1, length %2").arg(record.offset).arg(record.length);
+
+    QVERIFY(image.open(path, m_key));
+    QVERIFY(image.readChapter(1, chapter));
+
+    QString error;
+    QVERIFY(!image.readChapter(2, chapter, &error));
+    QVERIFY2(error.contains("Chapter 2") && error.contains(location), qPrintable(error));
+
+    QStringList errors;
+    QVERIFY(!CourseManager::verifyCourseFile(path, m_key, &errors));
+    QCOMPARE(errors.size(), 1);
+    QVERIFY2(errors.first().contains(location), qPrintable(errors.first()));
+
+    error.clear();
+    QVERIFY(CourseManager::loadCourseFromBinary(path, m_key, &error).chapters.isEmpty());
+    QVERIFY2(error.contains(location), qPrintable(error));
+}
+
+void CourseFormatTest::firstChapterBenchmark_data() {
+    QTest::addColumn<int>("version");
+    QTest::newRow("v4") << 4;
+    QTest::newRow("v1") << 1;
+}
+
+void CourseFormatTest::firstChapterBenchmark() {
+    QFETCH(int, version);
+
+    const QString path = largeCoursePath(version);
+    QVERIFY(!path.isEmpty());
+
+    // Прирост резидентной памяти от открытия курса до первой прочитанной главы
+    const qint64 residentBefore = residentBytes();
+    qint64 residentGrowth = 0;
+
+    Chapter chapter;
+    QBENCHMARK {
+        CourseImage image;
+        QVERIFY(image.open(path, m_key));
+        QVERIFY(image.readChapter(0, chapter));
+        residentGrowth = qMax(residentGrowth, residentBytes() - residentBefore);
+    }
+    QVERIFY(sameChapter(chapter, m_largeCourse.chapters.first()));
+
+    if (residentBefore > 0) {
+        qInfo().noquote() << QString("v%1: file %2 MB, resident growth %3 MB")
+                                 .arg(version)
+                                 .arg(QFileInfo(path).size() / (1024.0 * 1024.0), 0, 'f', 1)
+                                 .arg(residentGrowth / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+}
+
+void CourseFormatTest::checksumOverheadBenchmark() {
+    const QString path = largeCoursePath(4);
+    QVERIFY(!path.isEmpty());
+
+    CourseImage image;
+    QVERIFY(image.open(path, m_key));
+
+    // Полная загрузка проверяет сумму каждого блока; доля проверки -
+    // время verify() относительно времени загрузки всех глав
+    QElapsedTimer timer;
+    timer.start();
+    Course course;
+    QVERIFY(image.toCourse(course));
+    const qint64 loadNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    timer.restart();
+    QVERIFY(image.verify());
+    const qint64 verifyNs = timer.nsecsElapsed();
+
+    qInfo().noquote() << QString("%1 CRC32C: load %2 ms, verify %3 ms (%4% of load)")
+                             .arg(CryptoUtils::crc32cKernelName())
+                             .arg(loadNs / 1e6, 0, 'f', 1)
+                             .arg(verifyNs / 1e6, 0, 'f', 2)
+                             .arg(100.0 * verifyNs / loadNs, 0, 'f', 2);
+
+    QBENCHMARK {
+        image.verify();
+    }
+}
+
+void CourseFormatTest::loadSaveScalingBenchmark_data() {
+    QTest::addColumn<int>("threads");
+    const int cores = QThread::idealThreadCount();
+    for (int threads = 1; threads < cores; threads *= 2) {
+        QTest::newRow(qPrintable(QString("%1 threads").arg(threads))) << threads;
+    }
+    QTest::newRow(qPrintable(QString("%1 threads").arg(cores))) << cores;
+}
+
+void CourseFormatTest::loadSaveScalingBenchmark() {
+    QFETCH(int, threads);
+
+    // Размер курса: COURSE_BENCH_COURSE_MB (цель - 1 ГБ), главы по ~40 КБ
+    const qint64 megabytes = qEnvironmentVariableIsSet("COURSE_BENCH_COURSE_MB")
+                                 ? qEnvironmentVariableIntValue("COURSE_BENCH_COURSE_MB") : 64;
+    QVERIFY(megabytes > 0);
+    if (m_scalingCourse.chapters.isEmpty()) {
+        m_scalingCourse = makeCourse(static_cast<int>(megabytes * 1024 * 1024 / 40000), 20000);
+    }
+
+    const QString path = m_directory.filePath("scaling.bin");
+    const int defaultThreads = CipherPipeline::maxThreadCount();
+    CipherPipeline::setMaxThreadCount(threads);
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool saved = CourseManager::saveCourseToBinary(m_scalingCourse, path, m_key);
+    const qint64 saveNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    timer.restart();
+    QString error;
+    const Course loaded = CourseManager::loadCourseFromBinary(path, m_key, &error);
+    const qint64 loadNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    CipherPipeline::setMaxThreadCount(defaultThreads);
+    QVERIFY(saved);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(loaded.chapters.size(), m_scalingCourse.chapters.size());
+
+    if (threads == 1) {
+        m_singleThreadSaveNs = saveNs;
+        m_singleThreadLoadNs = loadNs;
+    }
+    const qint64 baseSaveNs = m_singleThreadSaveNs > 0 ? m_singleThreadSaveNs : saveNs;
+    const qint64 baseLoadNs = m_singleThreadLoadNs > 0 ? m_singleThreadLoadNs : loadNs;
+    qInfo().noquote() << QString("%1 chapters, %2 threads: save %3 ms (x%4), load %5 ms (x%6)")
+                             .arg(m_scalingCourse.chapters.size())
+                             .arg(threads)
+                             .arg(saveNs / 1000000)
+                             .arg(double(baseSaveNs) / saveNs, 0, 'f', 2)
+                             .arg(loadNs / 1000000)
+                             .arg(double(baseLoadNs) / loadNs, 0, 'f', 2);
+}
+
+void CourseFormatTest::jsonCompileBenchmark_data() {
+    QTest::addColumn<bool>("streaming");
+    QTest::newRow("compileJsonToBinary") << true;
+    QTest::newRow("loadCourseFromJSON + saveCourseToBinary") << false;
+}
+
+void CourseFormatTest::jsonCompileBenchmark() {
+    QFETCH(bool, streaming);
+
+    // Размер исходника: COURSE_BENCH_JSON_MB (цель - сотни мегабайт)
+    const qint64 megabytes = qEnvironmentVariableIsSet("COURSE_BENCH_JSON_MB")
+                                 ? qEnvironmentVariableIntValue("COURSE_BENCH_JSON_MB") : 64;
+    QVERIFY(megabytes > 0);
+
+    const QString jsonPath = m_directory.filePath(QString("large_%1mb.json").arg(megabytes));
+    if (!QFile::exists(jsonPath)) {
+        QVERIFY(writeSyntheticJson(jsonPath, megabytes * 1024 * 1024));
+    }
+    const QString binPath = m_directory.filePath("large_json.bin");
+    const qint64 jsonBytes = QFileInfo(jsonPath).size();
+
+    resetPeakResident();
+    const qint64 peakBefore = peakResidentBytes();
+
+    QElapsedTimer timer;
+    timer.start();
+    if (streaming) {
+        QVERIFY(CourseManager::compileJsonToBinary(jsonPath, binPath, m_key));
+    } else {
+        const Course course = CourseManager::loadCourseFromJSON(jsonPath);
+        QVERIFY(!course.chapters.isEmpty());
+        QVERIFY(CourseManager::saveCourseToBinary(course, binPath, m_key));
+    }
+    const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    const qint64 peakGrowth = peakResidentBytes() - peakBefore;
+
+    qInfo().noquote() << QString("%1 MB JSON: %2 MB/s, peak resident growth %3")
+                             .arg(jsonBytes / (1024.0 * 1024.0), 0, 'f', 0)
+                             .arg(jsonBytes * 1e9 / elapsedNs / (1024.0 * 1024.0), 0, 'f', 1)
+                             .arg(peakBefore > 0 ? QString("%1 MB").arg(peakGrowth / (1024.0 * 1024.0), 0, 'f', 1)
+                                                 : QString("n/a"));
+}
+
+void CourseFormatTest::codecBenchmark_data() {
+    roundTripV3_data();
+}
+
+void CourseFormatTest::codecBenchmark() {
+    QFETCH(quint32, codecId);
+    const ChapterCodec* codec = ChapterCodec::byId(codecId);
+    QVERIFY(codec);
+
+    // Сериализованные главы настоящего курса: HTML содержимое, как в course.bin
+    const Course course = CourseManager::loadCourseFromJSON(QStringLiteral(SOURCE_DIR "/data/course_source.json"));
+    QVERIFY(!course.chapters.isEmpty());
+    QList<QByteArray> blocks;
+    qint64 rawBytes = 0;
+    for (const Chapter& chapter : course.chapters) {
+        QByteArray chapterData;
+        QDataStream chapterStream(&chapterData, QIODevice::WriteOnly);
+        chapterStream << chapter;
+        rawBytes += chapterData.size();
+        blocks.append(chapterData);
+    }
+
+    QList<QByteArray> compressed;
+    qint64 compressedBytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (const QByteArray& block : blocks) {
+        compressed.append(codec->compress(block));
+        compressedBytes += compressed.last().size();
+    }
+    const qint64 encodeNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    qint64 decodedBytes = 0;
+    timer.restart();
+    QBENCHMARK {
+        for (const QByteArray& block : compressed) {
+            bool ok = false;
+            decodedBytes += codec->decompress(block, &ok).size();
+            QVERIFY(ok);
+        }
+    }
+    const qint64 decodeNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    qInfo().noquote() << QString("%1: ratio %2, encode %3 MB/s, decode %4 MB/s")
+                             .arg(QString::fromLatin1(codec->name))
+                             .arg(double(rawBytes) / qMax<qint64>(1, compressedBytes), 0, 'f', 2)
+                             .arg(rawBytes * 1e9 / encodeNs / (1024.0 * 1024.0), 0, 'f', 1)
+                             .arg(decodedBytes * 1e9 / decodeNs / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+void CourseFormatTest::xorThroughputBenchmark_data() {
+    QTest::addColumn<QString>("kernel");
+    QTest::newRow("dispatch") << QString(CryptoUtils::xorKernelName());
+    QTest::newRow("scalar") << QString("scalar");
+    QTest::newRow("xorEncryptDecrypt") << QString("copy");
+}
+
+void CourseFormatTest::xorThroughputBenchmark() {
+    QFETCH(QString, kernel);
+
+    QByteArray data = randomBytes(16 * 1024 * 1024);
+    const XorKey key(m_key);
+
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        if (kernel == "scalar") {
+            CryptoUtils::xorInPlaceScalar(data.data(), data.size(), key);
+        } else if (kernel == "copy") {
+            data = CryptoUtils::xorEncryptDecrypt(data, m_key);
+        } else {
+            CryptoUtils::xorInPlace(data.data(), data.size(), key);
+        }
+        bytes += data.size();
+    }
+
+    const qint64 elapsed = qMax<qint64>(1, timer.nsecsElapsed());
+    qInfo().noquote() << QString("%1: %2 GB/s").arg(kernel).arg(double(bytes) / elapsed, 0, 'f', 2);
+}
+
+bool CourseFormatTest::writeV1(const Course& course, const QString& path) {
+    QByteArray courseData;
+    QDataStream courseStream(&courseData, QIODevice::WriteOnly);
+    courseStream << course;
+    CryptoUtils::xorInPlaceScalar(courseData.data(), courseData.size(), XorKey(m_key));
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QDataStream fileStream(&file);
+    fileStream << CourseFormat::MAGIC_V1 << courseData;
+    return fileStream.status() == QDataStream::Ok;
+}
+
+bool CourseFormatTest::writeIndexed(const Course& course, const QString& path, quint32 version, quint32 codecId) {
+    const ChapterCodec* codec = ChapterCodec::byId(codecId);
+    if (!codec || version < 2 || version > 3 || (version == 2 && codecId != ChapterCodec::None)) {
+        return false;
+    }
+
+    const qint64 headerSize = version == 2 ? CourseFormat::HEADER_SIZE_V2 : CourseFormat::HEADER_SIZE_V3;
+    const XorKey key(m_key);
+
+    // Блоки глав: сжатие, затем шифрование каждого блока с нулевой фазы ключа
+    QByteArray blocks;
+    QList<CourseFormat::IndexEntry> index;
+    for (const Chapter& chapter : course.chapters) {
+        QByteArray chapterData;
+        QDataStream chapterStream(&chapterData, QIODevice::WriteOnly);
+        chapterStream << chapter;
+
+        QByteArray block = codec->compress(chapterData);
+        CryptoUtils::xorInPlaceScalar(block.data(), block.size(), key);
+        index.append(CourseFormat::IndexEntry(static_cast<quint64>(headerSize + blocks.size()),
+                                              static_cast<quint32>(block.size())));
+        blocks.append(block);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QDataStream fileStream(&file);
+    fileStream << CourseFormat::MAGIC_V2 << version << static_cast<quint32>(course.chapters.size())
+               << static_cast<quint64>(headerSize + blocks.size());
+    if (version == 3) {
+        fileStream << codecId;
+    }
+    fileStream.writeRawData(blocks.constData(), static_cast<int>(blocks.size()));
+    for (const CourseFormat::IndexEntry& entry : index) {
+        fileStream << entry.offset << entry.length;
+    }
+    return fileStream.status() == QDataStream::Ok;
+}
+
+void CourseFormatTest::compactCourseMemoryBenchmark_data() {
+    QTest::addColumn<bool>("compact");
+    QTest::newRow("Course") << false;
+    QTest::newRow("CompactCourse") << true;
+}
+
+void CourseFormatTest::compactCourseMemoryBenchmark() {
+    QFETCH(bool, compact);
+
+    // 20000 глав по 5 вопросов; исходный курс освобождается до замера
+    const int questionCount = 100000;
+    const QString path = m_directory.filePath("questions_100k.bin");
+    if (!QFile::exists(path)) {
+        const Course source = makeCourse(questionCount / 5, 200);
+        QVERIFY(CourseManager::saveCourseToBinary(source, path, m_key));
+    }
+
+    CourseImage image;
+    QVERIFY(image.open(path, m_key));
+
+    releaseFreeHeap();
+    const qint64 residentBefore = residentBytes();
+    qint64 allocations = 0;
+    qint64 releases = 0;
+
+    Course course;
+    CompactCourse compactCourse;
+    QString error;
+    startHeapCounting();
+    const bool loaded = compact ? image.toCompactCourse(compactCourse, &error) : image.toCourse(course, &error);
+    stopHeapCounting(&allocations, &releases);
+    releaseFreeHeap();
+    const qint64 residentGrowth = residentBytes() - residentBefore;
+    QVERIFY2(loaded, qPrintable(error));
+
+    int loadedQuestions = compactCourse.questionCount();
+    for (const Chapter& chapter : course.chapters) {
+        loadedQuestions += static_cast<int>(chapter.questions.size());
+    }
+    QCOMPARE(loadedQuestions, questionCount);
+
+#ifdef COURSE_TEST_HEAP_COUNTERS
+    // Удержанные блоки - выделенные при загрузке и не освобожденные к ее концу
+    qInfo().noquote() << QString("%1: %2 questions, %3 heap allocations during load, %4 blocks held, "
+                                 "resident growth %5 MB%6")
+                             .arg(QTest::currentDataTag())
+                             .arg(questionCount)
+                             .arg(allocations)
+                             .arg(allocations - releases)
+                             .arg(residentGrowth / (1024.0 * 1024.0), 0, 'f', 1)
+                             .arg(compact ? QString(", arena and tables %1 MB")
+                                                .arg(compactCourse.memoryUsage() / (1024.0 * 1024.0), 0, 'f', 1)
+                                          : QString());
+#else
+    Q_UNUSED(allocations);
+    Q_UNUSED(releases);
+    qInfo().noquote() << QString("%1: resident growth %2 MB (heap counters need glibc)")
+                             .arg(QTest::currentDataTag())
+                             .arg(residentGrowth / (1024.0 * 1024.0), 0, 'f', 1);
+#endif
+}
+
+QString CourseFormatTest::largeCoursePath(int version) {
+    const QString path = m_directory.filePath(QString("large_v%1.bin").arg(version));
+    if (QFile::exists(path)) {
+        return path;
+    }
+
+    if (m_largeCourse.chapters.isEmpty()) {
+        m_largeCourse = makeCourse(5000, 2000);
+    }
+    const bool saved = version == 1 ? writeV1(m_largeCourse, path)
+                                    : CourseManager::saveCourseToBinary(m_largeCourse, path, m_key);
+    return saved ? path : QString();
+}
+
+QString CourseFormatTest::corruptibleCopy(const QString& name) {
+    const QString path = m_directory.filePath(name);
+    if (!CourseManager::saveCourseToBinary(m_course, path, m_key, ChapterCodec::Zlib)) {
+        return QString();
+    }
+    return path;
+}
+
+bool CourseFormatTest::flipByte(const QString& path, qint64 offset) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite) || offset < 0 || offset >= file.size()) {
+        return false;
+    }
+    file.seek(offset);
+    char byte = 0;
+    if (!file.getChar(&byte)) {
+        return false;
+    }
+    file.seek(offset);
+    return file.putChar(static_cast<char>(byte ^ 0x01));
+}
+
+qint64 CourseFormatTest::indexOffset(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QByteArray header = file.read(CourseFormat::HEADER_SIZE);
+    if (header.size() < CourseFormat::HEADER_SIZE) {
+        return -1;
+    }
+    return static_cast<qint64>(qFromBigEndian<quint64>(header.constData() + 12));
+}
+
+CourseFormat::IndexEntry CourseFormatTest::indexEntry(const QString& path, int index) {
+    const qint64 entryOffset = indexOffset(path) + index * CourseFormat::INDEX_ENTRY_SIZE;
+    QFile file(path);
+    if (entryOffset < CourseFormat::HEADER_SIZE || !file.open(QIODevice::ReadOnly) || !file.seek(entryOffset)) {
+        return CourseFormat::IndexEntry();
+    }
+    const QByteArray entry = file.read(CourseFormat::INDEX_ENTRY_SIZE);
+    if (entry.size() < CourseFormat::INDEX_ENTRY_SIZE) {
+        return CourseFormat::IndexEntry();
+    }
+    return CourseFormat::IndexEntry(qFromBigEndian<quint64>(entry.constData()),
+                                    qFromBigEndian<quint32>(entry.constData() + 8),
+                                    qFromBigEndian<quint32>(entry.constData() + 12));
+}
+
+Course CourseFormatTest::makeCourse(int chapterCount, int contentSize) {
+    Course course;
+    for (int i = 0; i < chapterCount; ++i) {
+        Chapter chapter(i + 1, QString("Глава %1").arg(i + 1),
+                        QString("Содержание главы %1. ").arg(i + 1).repeated(contentSize / 20 + 1).left(contentSize));
+        for (int q = 0; q < 5; ++q) {
+            chapter.questions.append(Question(QString("Вопрос %1.%2").arg(i + 1).arg(q + 1),
+                                              {"Первый", "Второй", "Третий", "Четвертый"}, (i + q) % 4));
+        }
+        course.chapters.append(chapter);
+    }
+    return course;
+}
+
+bool CourseFormatTest::sameChapter(const Chapter& left, const Chapter& right) {
+    if (left.id != right.id || left.title != right.title || left.content != right.content
+        || left.questions.size() != right.questions.size()) {
+        return false;
+    }
+    for (int i = 0; i < left.questions.size(); ++i) {
+        const Question& a = left.questions.at(i);
+        const Question& b = right.questions.at(i);
+        if (a.q_text != b.q_text || a.options != b.options || a.correct_index != b.correct_index) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CourseFormatTest::sameCourse(const Course& left, const Course& right) {
+    if (left.chapters.size() != right.chapters.size()) {
+        qWarning() << "Chapter count differs:" << left.chapters.size() << right.chapters.size();
+        return false;
+    }
+    for (int i = 0; i < left.chapters.size(); ++i) {
+        if (!sameChapter(left.chapters.at(i), right.chapters.at(i))) {
+            qWarning() << "Chapter differs:" << i;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CourseFormatTest::readAll(const QString& path, Course& course, int expectedVersion) {
+    CourseImage image;
+    if (!image.open(path, QStringLiteral(COURSE_ENCRYPTION_KEY))) {
+        qWarning() << "Cannot open" << path;
+        return false;
+    }
+    if (image.formatVersion() != expectedVersion) {
+        qWarning() << "Unexpected format version:" << image.formatVersion() << "expected" << expectedVersion;
+        return false;
+    }
+
+    // Главы читаются по одной, как при показе страницы
+    course = Course();
+    for (int i = 0; i < image.chapterCount(); ++i) {
+        Chapter chapter;
+        QString error;
+        if (!image.readChapter(i, chapter, &error)) {
+            qWarning().noquote() << error;
+            return false;
+        }
+        course.chapters.append(chapter);
+    }
+    return true;
+}
+
+QByteArray CourseFormatTest::randomBytes(qsizetype size) {
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator generator(12345);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(generator.generate() & 0xFF);
+    }
+    return data;
+}
+
+qint64 CourseFormatTest::residentBytes() {
+    // Linux: вторая колонка /proc/self/statm - резидентные страницы по 4 КБ
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * 4096 : 0;
+}
+
+qint64 CourseFormatTest::peakResidentBytes() {
+    // Linux: VmHWM в /proc/self/status - пик резидентной памяти в КБ
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    for (const QByteArray& line : status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return 0;
+}
+
+void CourseFormatTest::resetPeakResident() {
+    // Запись "5" в clear_refs сбрасывает VmHWM до текущего объема
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+}
+
+void CourseFormatTest::releaseFreeHeap() {
+#ifdef COURSE_TEST_HEAP_COUNTERS
+    // Свободная память кучи возвращается системе, иначе прирост RSS занижен
+    malloc_trim(0);
+#endif
+}
+
+void CourseFormatTest::startHeapCounting() {
+#ifdef COURSE_TEST_HEAP_COUNTERS
+    heapAllocations = 0;
+    heapReleases = 0;
+    heapCounting = true;
+#endif
+}
+
+void CourseFormatTest::stopHeapCounting(qint64* allocations, qint64* releases) {
+#ifdef COURSE_TEST_HEAP_COUNTERS
+    heapCounting = false;
+    *allocations = heapAllocations;
+    *releases = heapReleases;
+#else
+    *allocations = 0;
+    *releases = 0;
+#endif
+}
+
+bool CourseFormatTest::writeSyntheticJson(const QString& path, qint64 targetBytes) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    // Главы в формате data/course_source.json пишутся по одной
+    file.write("[\n");
+    for (int id = 1; file.pos() < targetBytes; ++id) {
+        QJsonArray questions;
+        for (int q = 0; q < 5; ++q) {
+            questions.append(QJsonObject{{"q_text", QString("Вопрос %1.%2").arg(id).arg(q + 1)},
+                                         {"options", QJsonArray{"Первый", "Второй", "Третий", "Четвертый"}},
+                                         {"correct_index", (id + q) % 4}});
+        }
+        const QJsonObject chapter{{"id", id},
+                                  {"title", QString("Глава %1").arg(id)},
+                                  {"content", QString("<p>Содержание главы %1.</p>").arg(id).repeated(200)},
+                                  {"questions", questions}};
+        if (id > 1) {
+            file.write(",\n");
+        }
+        file.write(QJsonDocument(chapter).toJson(QJsonDocument::Compact));
+    }
+    file.write("\n]\n");
+    return file.error() == QFile::NoError;
+}
+
+QTEST_MAIN(CourseFormatTest)
+
+#include "tst_course.moc"
@@ -0,0 +1,18 @@
+# Асинхронные запросы DatabaseManager на SQLite: цикл событий не блокируется
+# на время запросов с искусственной задержкой COURSE_DB_LATENCY_MS
+QT = core sql testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_database
+TEMPLATE = app
+
+include(../../src/core/core.pri)
+include(../../src/db/db.pri)
+
+# Миграции читаются из data/migrations исходного дерева
+DEFINES += SOURCE_DIR=\\\"$$PWD/../..\\\"
+
+SOURCES += \
+    tst_database.cpp
@@ -0,0 +1,124 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+#include "db/DatabaseManager.h"
+
+/**
+ * @brief Проверки асинхронного API DatabaseManager на SQLite.
+ * Каждый запрос рабочего потока задерживается на COURSE_DB_LATENCY_MS
+ * (500 мс), как на удаленном или нагруженном сервере. Пока запросы
+ * выполняются, таймер в потоке теста должен срабатывать без пропусков:
+ * так проверяется, что вызывающий поток не ждет базу данных.
+ */
+class DatabaseManagerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void eventLoopResponsiveDuringQueries();
+    void asyncResultsDelivered();
+
+private:
+    static constexpr int LATENCY_MS = 500;
+    static constexpr int TICK_INTERVAL_MS = 15;
+
+    QTemporaryDir m_directory;
+};
+
+void DatabaseManagerTest::initTestCase() {
+    QVERIFY(m_directory.isValid());
+
+    // Настройки читаются при создании DatabaseManager, до первого getInstance()
+    qputenv("COURSE_DB_BACKEND", "sqlite");
+    qputenv("COURSE_DB_PATH", m_directory.filePath("course.sqlite").toUtf8());
+    qputenv("COURSE_DB_LATENCY_MS", QByteArray::number(LATENCY_MS));
+
+    // Миграции ищутся в data/migrations относительно текущего каталога
+    QVERIFY(QDir::setCurrent(QStringLiteral(SOURCE_DIR)));
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    QVERIFY2(db.connectToDatabase(), qPrintable(db.getLastError()));
+    QVERIFY2(db.initDatabase(), qPrintable(db.getLastError()));
+}
+
+void DatabaseManagerTest::eventLoopResponsiveDuringQueries() {
+    DatabaseManager& db = DatabaseManager::getInstance();
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 lastTick = 0;
+    qint64 maxGap = 0;
+    int ticks = 0;
+
+    QTimer timer;
+    timer.setInterval(TICK_INTERVAL_MS);
+    connect(&timer, &QTimer::timeout, this, [&]() {
+        const qint64 now = clock.elapsed();
+        maxGap = qMax(maxGap, now - lastTick);
+        lastTick = now;
+        ++ticks;
+    });
+    timer.start();
+
+    // Запросы выполняются по очереди: вместе не меньше 4 * LATENCY_MS
+    QList<QFuture<DatabaseResult<QList<QSqlRecord>>>> futures;
+    for (int i = 0; i < 4; ++i) {
+        futures << db.executeSelectQueryAsync(QString("SELECT %1").arg(i));
+    }
+    const qint64 issueMs = clock.elapsed();
+    QVERIFY2(issueMs < LATENCY_MS / 5, qPrintable(QString("issuing took %1 ms").arg(issueMs)));
+
+    const auto allFinished = [&futures]() {
+        return std::all_of(futures.cbegin(), futures.cend(),
+                           [](const QFuture<DatabaseResult<QList<QSqlRecord>>>& future) { return future.isFinished(); });
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(allFinished(), 20 * LATENCY_MS);
+    timer.stop();
+    const qint64 totalMs = clock.elapsed();
+
+    for (int i = 0; i < futures.size(); ++i) {
+        const DatabaseResult<QList<QSqlRecord>> result = futures[i].result();
+        QVERIFY2(result.ok(), qPrintable(result.error));
+        QCOMPARE(result.value.size(), 1);
+        QCOMPARE(result.value.first().value(0).toInt(), i);
+    }
+
+    qInfo().noquote() << QString("%1 queries in %2 ms: %3 timer ticks, longest gap %4 ms")
+                             .arg(futures.size()).arg(totalMs).arg(ticks).arg(maxGap);
+
+    // Задержка действительно действовала, а таймер не стоял дольше нескольких интервалов
+    QVERIFY2(totalMs >= 4 * LATENCY_MS - 50, qPrintable(QString("finished in %1 ms").arg(totalMs)));
+    QVERIFY2(maxGap < LATENCY_MS / 2, qPrintable(QString("event loop stalled for %1 ms").arg(maxGap)));
+    QVERIFY2(ticks >= totalMs / TICK_INTERVAL_MS / 2, qPrintable(QString("only %1 timer ticks").arg(ticks)));
+}
+
+void DatabaseManagerTest::asyncResultsDelivered() {
+    DatabaseManager& db = DatabaseManager::getInstance();
+
+    // Результат доставляется в поток вызывающего через then(), как в окнах приложения
+    bool delivered = false;
+    bool inCallerThread = false;
+    QStringList tables;
+    db.getTableListAsync().then(this, [&](const DatabaseResult<QStringList>& result) {
+        delivered = true;
+        inCallerThread = QThread::currentThread() == thread();
+        tables = result.value;
+    });
+
+    QVERIFY(!delivered);
+    QTRY_VERIFY_WITH_TIMEOUT(delivered, 10 * LATENCY_MS);
+    QVERIFY(inCallerThread);
+    QVERIFY(tables.contains("users"));
+}
+
+QTEST_GUILESS_MAIN(DatabaseManagerTest)
+
+#include "tst_database.moc"
@@ -0,0 +1,13 @@
+# Логика прохождения курса QuizEngine: интерактивный и пакетный интерфейсы
+QT = core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_quiz
+TEMPLATE = app
+
+include(../../src/core/core.pri)
+
+SOURCES += \
+    tst_quiz.cpp
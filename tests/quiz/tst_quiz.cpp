@@ -0,0 +1,404 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <memory>
+
+#include "core/CourseImage.h"
+#include "core/CourseManager.h"
+#include "core/QuizEngine.h"
+
+/**
+ * @brief Получатель ответов для тестов: запоминает все вызовы.
+ */
+class RecordingSink : public QuizSink
+{
+public:
+    void recordAnswer(const QuizAnswer& answer) override {
+        answers.append(answer);
+    }
+
+    void recordOutcome(int chapterIndex, QuizOutcome outcome) override {
+        outcomes.append(qMakePair(chapterIndex, outcome));
+    }
+
+    QList<QuizAnswer> answers;
+    QList<QPair<int, QuizOutcome>> outcomes;
+};
+
+/**
+ * @brief Проверки QuizEngine без интерфейса.
+ * Курс из трех глав по три вопроса сохраняется в файл v4 и открывается
+ * через CourseImage, как в приложении. Интерактивный интерфейс
+ * проверяется по сигналам и вызовам RecordingSink, пакетный - сравнением
+ * с интерактивным на случайных последовательностях ответов.
+ * gradeBatchBenchmark выводит число проверенных последовательностей в секунду.
+ */
+class QuizEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void wrongAnswerStaysOnQuestion();
+    void threeStrikesFailTest();
+    void invalidOptionRejected();
+    void courseCompletion();
+    void progressRestore_data();
+    void progressRestore();
+    void gradeMatchesInteractive();
+    void gradeBatchRejectsInvalidOffsets();
+
+    void gradeBatchBenchmark();
+
+private:
+    static constexpr int CHAPTERS = 3;
+    static constexpr int QUESTIONS = 3;
+    static constexpr int OPTIONS = 3;
+
+    std::unique_ptr<QuizEngine> makeEngine(RecordingSink* sink);
+    static int correctOption(int chapterIndex, int questionIndex);
+    static int wrongOption(int chapterIndex, int questionIndex);
+
+    QTemporaryDir m_directory;
+    Course m_course;
+    QuizEngine::CourseSnapshot m_snapshot;
+};
+
+void QuizEngineTest::initTestCase() {
+    QVERIFY(m_directory.isValid());
+
+    for (int c = 0; c < CHAPTERS; ++c) {
+        Chapter chapter(c + 1, QString("Глава %1").arg(c + 1), QString("Теория главы %1").arg(c + 1));
+        for (int q = 0; q < QUESTIONS; ++q) {
+            chapter.questions.append(Question(QString("Вопрос %1.%2").arg(c + 1).arg(q + 1),
+                                              {"Первый", "Второй", "Третий"}, correctOption(c, q)));
+        }
+        m_course.chapters.append(chapter);
+    }
+
+    const QString path = m_directory.filePath("quiz.bin");
+    const QString key = QStringLiteral(COURSE_ENCRYPTION_KEY);
+    QVERIFY(CourseManager::saveCourseToBinary(m_course, path, key));
+
+    auto image = std::make_shared<CourseImage>();
+    QVERIFY(image->open(path, key));
+    m_snapshot = image;
+}
+
+void QuizEngineTest::wrongAnswerStaysOnQuestion() {
+    RecordingSink sink;
+    std::unique_ptr<QuizEngine> engine = makeEngine(&sink);
+    QSignalSpy shown(engine.get(), &QuizEngine::questionShown);
+    QSignalSpy wrong(engine.get(), &QuizEngine::answerWrong);
+
+    engine->start(-1, QString());
+    QVERIFY(engine->startTest());
+    QCOMPARE(shown.count(), 1);
+
+    QVERIFY(engine->answer(correctOption(0, 0)));
+    QCOMPARE(engine->questionIndex(), 1);
+    QCOMPARE(shown.count(), 2);
+
+    // Неверный ответ не переводит к следующему вопросу и не показывает его заново
+    QVERIFY(engine->answer(wrongOption(0, 1)));
+    QCOMPARE(engine->questionIndex(), 1);
+    QCOMPARE(engine->errorCount(), 1);
+    QCOMPARE(engine->phase(), QuizEngine::Phase::Testing);
+    QCOMPARE(shown.count(), 2);
+    QCOMPARE(wrong.count(), 1);
+    QCOMPARE(wrong.at(0).at(0).toInt(), 1);
+    QCOMPARE(wrong.at(0).at(1).toInt(), QuizEngine::MAX_ERRORS);
+
+    QVERIFY(engine->answer(correctOption(0, 1)));
+    QCOMPARE(engine->questionIndex(), 2);
+
+    QCOMPARE(sink.answers.size(), 3);
+    QCOMPARE(sink.answers.at(1).questionIndex, 1);
+    QVERIFY(!sink.answers.at(1).correct);
+    QCOMPARE(sink.answers.at(2).questionIndex, 1);
+    QVERIFY(sink.answers.at(2).correct);
+    QVERIFY(sink.outcomes.isEmpty());
+}
+
+void QuizEngineTest::threeStrikesFailTest() {
+    RecordingSink sink;
+    std::unique_ptr<QuizEngine> engine = makeEngine(&sink);
+    QSignalSpy failed(engine.get(), &QuizEngine::testFailed);
+    QSignalSpy opened(engine.get(), &QuizEngine::chapterOpened);
+
+    engine->start(-1, QString());
+    QVERIFY(engine->startTest());
+    QVERIFY(engine->answer(correctOption(0, 0)));
+
+    for (int strike = 1; strike < QuizEngine::MAX_ERRORS; ++strike) {
+        QVERIFY(engine->answer(wrongOption(0, 1)));
+        QCOMPARE(engine->errorCount(), strike);
+        QCOMPARE(failed.count(), 0);
+    }
+    QVERIFY(engine->answer(wrongOption(0, 1)));
+
+    // Третья ошибка завершает тест и возвращает к теории той же главы
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(0).toInt(), 0);
+    QCOMPARE(failed.at(0).at(1).toInt(), QuizEngine::MAX_ERRORS);
+    QCOMPARE(engine->phase(), QuizEngine::Phase::Theory);
+    QCOMPARE(engine->chapterIndex(), 0);
+    QCOMPARE(engine->errorCount(), 0);
+    QCOMPARE(opened.count(), 2);
+
+    QCOMPARE(sink.answers.size(), 1 + QuizEngine::MAX_ERRORS);
+    QCOMPARE(sink.answers.constLast().outcome, QuizOutcome::Failed);
+    QCOMPARE(sink.outcomes.size(), 1);
+    QCOMPARE(sink.outcomes.at(0).first, 0);
+    QCOMPARE(sink.outcomes.at(0).second, QuizOutcome::Failed);
+
+    // После провала ответы не принимаются до нового теста
+    QVERIFY(!engine->answer(correctOption(0, 0)));
+    QVERIFY(engine->startTest());
+    QCOMPARE(engine->questionIndex(), 0);
+}
+
+void QuizEngineTest::invalidOptionRejected() {
+    RecordingSink sink;
+    std::unique_ptr<QuizEngine> engine = makeEngine(&sink);
+    engine->start(-1, QString());
+
+    // Ответ без начатого теста
+    QVERIFY(!engine->answer(correctOption(0, 0)));
+
+    QVERIFY(engine->startTest());
+    QVERIFY(!engine->startTest());
+    QVERIFY(!engine->answer(-1));
+    QVERIFY(!engine->answer(OPTIONS));
+    QCOMPARE(engine->errorCount(), 0);
+    QCOMPARE(engine->questionIndex(), 0);
+    QVERIFY(sink.answers.isEmpty());
+}
+
+void QuizEngineTest::courseCompletion() {
+    RecordingSink sink;
+    std::unique_ptr<QuizEngine> engine = makeEngine(&sink);
+    QSignalSpy passed(engine.get(), &QuizEngine::testPassed);
+    QSignalSpy completed(engine.get(), &QuizEngine::courseCompleted);
+
+    engine->start(-1, QString());
+    for (int c = 0; c < CHAPTERS; ++c) {
+        QCOMPARE(engine->chapterIndex(), c);
+        QCOMPARE(engine->currentChapter().id, c + 1);
+        QVERIFY(engine->startTest());
+        for (int q = 0; q < QUESTIONS; ++q) {
+            QVERIFY(engine->answer(correctOption(c, q)));
+        }
+        QCOMPARE(passed.count(), c + 1);
+        QCOMPARE(passed.at(c).at(0).toInt(), c);
+    }
+
+    // После последней главы курс пройден, открыта последняя глава
+    QCOMPARE(completed.count(), 1);
+    QCOMPARE(engine->chapterIndex(), CHAPTERS - 1);
+    QCOMPARE(engine->phase(), QuizEngine::Phase::Theory);
+
+    QCOMPARE(sink.answers.size(), CHAPTERS * QUESTIONS);
+    QCOMPARE(sink.outcomes.size(), CHAPTERS);
+    for (int c = 0; c < CHAPTERS; ++c) {
+        QCOMPARE(sink.outcomes.at(c).first, c);
+        QCOMPARE(sink.outcomes.at(c).second, QuizOutcome::Passed);
+    }
+}
+
+void QuizEngineTest::progressRestore_data() {
+    QTest::addColumn<int>("lastChapter");
+    QTest::addColumn<QString>("lastStatus");
+    QTest::addColumn<int>("expectedChapter");
+    QTest::addColumn<bool>("completed");
+
+    QTest::newRow("no progress") << -1 << QString() << 0 << false;
+    QTest::newRow("first completed") << 0 << "completed" << 1 << false;
+    QTest::newRow("second failed") << 1 << "fail" << 1 << false;
+    QTest::newRow("second started") << 1 << "started" << 1 << false;
+    QTest::newRow("last completed") << CHAPTERS - 1 << "completed" << CHAPTERS - 1 << true;
+    QTest::newRow("chapter removed") << CHAPTERS + 4 << "fail" << 0 << false;
+}
+
+void QuizEngineTest::progressRestore() {
+    QFETCH(int, lastChapter);
+    QFETCH(QString, lastStatus);
+    QFETCH(int, expectedChapter);
+    QFETCH(bool, completed);
+
+    std::unique_ptr<QuizEngine> engine = makeEngine(nullptr);
+    QSignalSpy opened(engine.get(), &QuizEngine::chapterOpened);
+    QSignalSpy courseCompleted(engine.get(), &QuizEngine::courseCompleted);
+    QCOMPARE(engine->phase(), QuizEngine::Phase::Idle);
+
+    engine->start(lastChapter, lastStatus);
+    QCOMPARE(engine->phase(), QuizEngine::Phase::Theory);
+    QCOMPARE(engine->chapterIndex(), expectedChapter);
+    QCOMPARE(opened.count(), 1);
+    QCOMPARE(opened.at(0).at(0).toInt(), expectedChapter);
+    QCOMPARE(courseCompleted.count(), completed ? 1 : 0);
+}
+
+void QuizEngineTest::gradeMatchesInteractive() {
+    const int chapterIndex = 1;
+    const QuizEngine::AnswerKey key = QuizEngine::answerKey(m_course.chapters.at(chapterIndex));
+
+    // Случайные последовательности, в том числе с несуществующими вариантами
+    QRandomGenerator random(12345);
+    QList<int> options;
+    QList<qsizetype> offsets = {0};
+    for (int sequence = 0; sequence < 500; ++sequence) {
+        const int length = random.bounded(12);
+        for (int i = 0; i < length; ++i) {
+            options.append(random.bounded(-1, OPTIONS + 1));
+        }
+        offsets.append(options.size());
+    }
+
+    QList<QuizEngine::GradeResult> results;
+    const QuizEngine::BatchSummary summary = QuizEngine::gradeBatch(key, options, offsets, &results);
+    QCOMPARE(results.size(), offsets.size() - 1);
+    QCOMPARE(summary.passed + summary.failed + summary.incomplete, qint64(results.size()));
+
+    qint64 passed = 0;
+    qint64 failed = 0;
+    for (qsizetype sequence = 0; sequence + 1 < offsets.size(); ++sequence) {
+        RecordingSink sink;
+        std::unique_ptr<QuizEngine> engine = makeEngine(&sink);
+        engine->start(chapterIndex - 1, "completed");
+        QVERIFY(engine->startTest());
+
+        // Ответы подаются, пока тест не завершен, как в окне студента
+        int answered = 0;
+        for (qsizetype i = offsets.at(sequence); i < offsets.at(sequence + 1) && sink.outcomes.isEmpty(); ++i) {
+            engine->answer(options.at(i));
+            ++answered;
+        }
+
+        QuizEngine::GradeResult expected;
+        expected.answered = answered;
+        if (sink.outcomes.isEmpty()) {
+            expected.errors = engine->errorCount();
+            expected.questionIndex = engine->questionIndex();
+        } else {
+            expected.outcome = sink.outcomes.constFirst().second;
+            for (const QuizAnswer& answer : sink.answers) {
+                if (answer.correct) {
+                    ++expected.questionIndex;
+                } else {
+                    ++expected.errors;
+                }
+            }
+        }
+
+        const QuizEngine::GradeResult& actual = results.at(sequence);
+        const QByteArray context = QString("sequence %1").arg(sequence).toUtf8();
+        QVERIFY2(actual.outcome == expected.outcome, context.constData());
+        QVERIFY2(actual.answered == expected.answered, context.constData());
+        QVERIFY2(actual.errors == expected.errors, context.constData());
+        QVERIFY2(actual.questionIndex == expected.questionIndex, context.constData());
+
+        // grade() для одной последовательности дает тот же итог, что и пакет
+        const QuizEngine::GradeResult single = QuizEngine::grade(
+            key, options.constData() + offsets.at(sequence), offsets.at(sequence + 1) - offsets.at(sequence));
+        QVERIFY2(single.outcome == actual.outcome && single.answered == actual.answered, context.constData());
+
+        passed += expected.outcome == QuizOutcome::Passed;
+        failed += expected.outcome == QuizOutcome::Failed;
+    }
+
+    QCOMPARE(summary.passed, passed);
+    QCOMPARE(summary.failed, failed);
+    QVERIFY(passed > 0);
+    QVERIFY(failed > 0);
+}
+
+void QuizEngineTest::gradeBatchRejectsInvalidOffsets() {
+    const QuizEngine::AnswerKey key = QuizEngine::answerKey(m_course.chapters.at(0));
+    const QList<int> options(10, 0);
+
+    const QList<QList<qsizetype>> invalid = {
+        {-1, 2},
+        {0, 5, 3},
+        {0, 11},
+    };
+    for (const QList<qsizetype>& offsets : invalid) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Quiz batch: "));
+        QList<QuizEngine::GradeResult> results;
+        const QuizEngine::BatchSummary summary = QuizEngine::gradeBatch(key, options, offsets, &results);
+        QCOMPARE(summary.passed + summary.failed + summary.incomplete, qint64(0));
+        QVERIFY(results.isEmpty());
+    }
+
+    // Пустые последовательности допустимы и не завершают тест; десять
+    // ответов "0" - верный первый и три ошибки на втором вопросе
+    const QuizEngine::BatchSummary summary = QuizEngine::gradeBatch(key, options, {0, 0, 10, 10});
+    QCOMPARE(summary.incomplete, qint64(2));
+    QCOMPARE(summary.failed, qint64(1));
+    QCOMPARE(summary.passed, qint64(0));
+
+    // Ключ главы без вопросов: тест не начинается
+    const QuizEngine::GradeResult empty = QuizEngine::grade(QuizEngine::AnswerKey(), options.constData(), 3);
+    QCOMPARE(empty.outcome, QuizOutcome::None);
+    QCOMPARE(empty.answered, 0);
+}
+
+void QuizEngineTest::gradeBatchBenchmark() {
+    // Число последовательностей: COURSE_BENCH_QUIZ_SEQUENCES
+    const int sequences = qEnvironmentVariableIsSet("COURSE_BENCH_QUIZ_SEQUENCES")
+                              ? qEnvironmentVariableIntValue("COURSE_BENCH_QUIZ_SEQUENCES") : 1000000;
+    QVERIFY(sequences > 0);
+
+    const QuizEngine::AnswerKey key = QuizEngine::answerKey(m_course.chapters.at(0));
+    QRandomGenerator random(54321);
+    QList<int> options;
+    QList<qsizetype> offsets;
+    options.reserve(qsizetype(sequences) * 6);
+    offsets.reserve(sequences + 1);
+    offsets.append(0);
+    for (int sequence = 0; sequence < sequences; ++sequence) {
+        const int length = 1 + random.bounded(10);
+        for (int i = 0; i < length; ++i) {
+            options.append(random.bounded(OPTIONS));
+        }
+        offsets.append(options.size());
+    }
+
+    QuizEngine::BatchSummary summary;
+    QElapsedTimer timer;
+    timer.start();
+    summary = QuizEngine::gradeBatch(key, options, offsets);
+    const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    QCOMPARE(summary.passed + summary.failed + summary.incomplete, qint64(sequences));
+    qInfo().noquote() << QString("Graded %1 sequences (%2 answers) in %3 ms: %4 sequences/s, "
+                                 "%5 passed, %6 failed, %7 incomplete")
+                             .arg(sequences)
+                             .arg(options.size())
+                             .arg(elapsedNs / 1000000)
+                             .arg(qRound64(sequences * 1e9 / elapsedNs))
+                             .arg(summary.passed)
+                             .arg(summary.failed)
+                             .arg(summary.incomplete);
+}
+
+std::unique_ptr<QuizEngine> QuizEngineTest::makeEngine(RecordingSink* sink) {
+    const QuizEngine::CourseSnapshot snapshot = m_snapshot;
+    return std::make_unique<QuizEngine>([snapshot]() { return snapshot; }, sink);
+}
+
+int QuizEngineTest::correctOption(int chapterIndex, int questionIndex) {
+    return (chapterIndex + questionIndex) % OPTIONS;
+}
+
+int QuizEngineTest::wrongOption(int chapterIndex, int questionIndex) {
+    return (correctOption(chapterIndex, questionIndex) + 1) % OPTIONS;
+}
+
+QTEST_GUILESS_MAIN(QuizEngineTest)
+
+#include "tst_quiz.moc"
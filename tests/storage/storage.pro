@@ -0,0 +1,18 @@
+# Общие проверки хранилищ: SQLite всегда, PostgreSQL - в базе из
+# COURSE_TEST_PG_DATABASE, если переменная задана
+QT = core sql testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_storage
+TEMPLATE = app
+
+include(../../src/core/core.pri)
+include(../../src/db/db.pri)
+
+# Миграции читаются из data/migrations исходного дерева
+DEFINES += SOURCE_DIR=\\\"$$PWD/../..\\\"
+
+SOURCES += \
+    tst_storage.cpp
@@ -0,0 +1,801 @@
+#include <QtTest>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <memory>
+
+#include "db/Storage.h"
+#include "db/ConnectionPool.h"
+#include "db/SchemaMigrator.h"
+#include "db/StatementCache.h"
+#include "core/CryptoUtils.h"
+
+/**
+ * @brief Общие проверки Storage для SQLite и PostgreSQL.
+ * Одни и те же тесты выполняются для каждого хранилища: SQLite - всегда,
+ * во временном файле; PostgreSQL - если переменная COURSE_TEST_PG_DATABASE
+ * задает отдельную базу для тестов. В PostgreSQL схема создается
+ * миграциями в собственной схеме storage_test_<pid>, которая удаляется
+ * после тестов. Тесты *Latency замеряют время запросов (QBENCHMARK),
+ * тесты *Benchmark выводят пропускную способность (qInfo).
+ */
+class StorageTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StorageTest(Storage::Backend backend) : m_backend(backend) {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void registerAndCredentials();
+    void updatePasswordHash();
+    void progressBatchUpsert();
+    void usersPageKeyset();
+    void usersPageSameCreatedAt();
+    void importUsers();
+    void attemptsRollup();
+
+    void credentialsLatency();
+    void usersPageLatency();
+    void statementCacheLatency_data();
+    void statementCacheLatency();
+    void usersSearchBenchmark();
+    void importBenchmark();
+    void progressWriteBenchmark_data();
+    void progressWriteBenchmark();
+
+private:
+    /**
+     * @brief Читает все страницы выборки, как UsersTableModel.
+     * @param ids ID строк в порядке выдачи
+     * @return false при ошибке или если страницы не заканчиваются
+     */
+    bool readAllPages(const QString& sortColumn, bool descending, const QString& loginFilter,
+                      int limit, QList<int>& ids, QString* errorMessage);
+
+    int userId(const QString& login);
+    QVariant scalar(const QString& sql, const QVariantList& values);
+    static QuestionAttempt attempt(int chapterId, int questionIndex, bool correct, int latencyMs,
+                                   const QString& outcome = QString());
+
+    Storage::Backend m_backend;
+    std::unique_ptr<Storage> m_storage;
+    QSqlDatabase m_database;
+    StatementCache m_statements;
+    QTemporaryDir m_directory;
+    QString m_schema;
+};
+
+void StorageTest::initTestCase() {
+    // Миграции ищутся в data/migrations относительно текущего каталога
+    QVERIFY(QDir::setCurrent(QStringLiteral(SOURCE_DIR)));
+
+    m_storage = Storage::create(m_backend);
+    ConnectionPool::Settings settings;
+
+    if (m_backend == Storage::Backend::SQLite) {
+        QVERIFY(m_directory.isValid());
+        qputenv("COURSE_DB_PATH", m_directory.filePath("course.sqlite").toUtf8());
+        settings = m_storage->connectionSettings();
+    } else {
+        const QString databaseName = qEnvironmentVariable("COURSE_TEST_PG_DATABASE");
+        if (databaseName.isEmpty()) {
+            QSKIP("COURSE_TEST_PG_DATABASE is not set, PostgreSQL storage is not tested");
+        }
+        settings = m_storage->connectionSettings();
+        settings.databaseName = databaseName;
+        // Таблицы создаются в своей схеме; public остается в пути для pg_trgm
+        m_schema = QString("storage_test_%1").arg(QCoreApplication::applicationPid());
+        settings.initStatements << QString("CREATE SCHEMA IF NOT EXISTS %1").arg(m_schema)
+                                << QString("SET search_path TO %1, public").arg(m_schema);
+    }
+
+    qInfo().noquote() << "Testing" << m_storage->description();
+
+    m_database = QSqlDatabase::addDatabase(settings.driver, "storage_test");
+    QString error;
+    if (!ConnectionPool::openDatabase(m_database, settings, &error)) {
+        if (m_backend == Storage::Backend::PostgreSQL) {
+            QSKIP(qPrintable(QString("PostgreSQL is not available: %1").arg(error)));
+        }
+        QFAIL(qPrintable(error));
+    }
+
+    QVERIFY2(m_storage->initSchema(m_database, &error), qPrintable(error));
+}
+
+void StorageTest::cleanupTestCase() {
+    m_statements.clear();
+    if (!m_schema.isEmpty() && m_database.isOpen()) {
+        QSqlQuery query(m_database);
+        if (!query.exec(QString("DROP SCHEMA %1 CASCADE").arg(m_schema))) {
+            qWarning() << "Failed to drop test schema:" << query.lastError().text();
+        }
+    }
+    m_database.close();
+    m_database = QSqlDatabase();
+    QSqlDatabase::removeDatabase("storage_test");
+}
+
+void StorageTest::registerAndCredentials() {
+    QString error;
+    QVERIFY2(m_storage->registerUser(m_database, m_statements, "reg_alice", "hash-1", "student", &error),
+             qPrintable(error));
+
+    const UserCredentials credentials = m_storage->getCredentials(m_database, m_statements, "reg_alice", &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY(credentials.id > 0);
+    QCOMPARE(credentials.role, QString("student"));
+    QCOMPARE(credentials.passwordHash, QString("hash-1"));
+
+    // Логин уникален
+    QVERIFY(!m_storage->registerUser(m_database, m_statements, "reg_alice", "hash-2", "admin", &error));
+    QVERIFY(!error.isEmpty());
+
+    error.clear();
+    QCOMPARE(m_storage->getCredentials(m_database, m_statements, "reg_nobody", &error).id, -1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void StorageTest::updatePasswordHash() {
+    QString error;
+    QVERIFY2(m_storage->registerUser(m_database, m_statements, "rehash_bob", "old", "student", &error),
+             qPrintable(error));
+    const int id = userId("rehash_bob");
+
+    QVERIFY2(m_storage->updatePasswordHash(m_database, m_statements, id, "old", "new", &error), qPrintable(error));
+    QCOMPARE(m_storage->getCredentials(m_database, m_statements, "rehash_bob", &error).passwordHash, QString("new"));
+
+    // Хеш, успевший смениться, не перезаписывается
+    QVERIFY2(m_storage->updatePasswordHash(m_database, m_statements, id, "old", "stale", &error), qPrintable(error));
+    QCOMPARE(m_storage->getCredentials(m_database, m_statements, "rehash_bob", &error).passwordHash, QString("new"));
+}
+
+void StorageTest::progressBatchUpsert() {
+    QString error;
+    QVERIFY2(m_storage->registerUser(m_database, m_statements, "progress_carol", "hash", "student", &error),
+             qPrintable(error));
+    const int id = userId("progress_carol");
+
+    // Больше строк, чем помещается в один запрос SQLite (999 параметров)
+    QList<ProgressUpdate> updates;
+    for (int chapter = 0; chapter < 600; ++chapter) {
+        updates.append(ProgressUpdate(id, chapter, chapter % 100, "completed"));
+    }
+    QVERIFY2(m_storage->saveProgressBatch(m_database, updates, &error), qPrintable(error));
+    QCOMPARE(scalar("SELECT COUNT(*) FROM study_progress WHERE user_id = ?", {id}).toInt(), 600);
+
+    const QPair<int, QString> last = m_storage->getLastProgress(m_database, m_statements, id, &error);
+    QCOMPARE(last.first, 599);
+    QCOMPARE(last.second, QString("completed"));
+
+    // Повторная запись обновляет строку, а не добавляет новую
+    QVERIFY2(m_storage->saveProgressBatch(m_database, {ProgressUpdate(id, 2, 90, "fail")}, &error),
+             qPrintable(error));
+    QCOMPARE(scalar("SELECT COUNT(*) FROM study_progress WHERE user_id = ?", {id}).toInt(), 600);
+    QCOMPARE(scalar("SELECT last_score FROM study_progress WHERE user_id = ? AND chapter_id = ?", {id, 2}).toInt(), 90);
+    QCOMPARE(scalar("SELECT status FROM study_progress WHERE user_id = ? AND chapter_id = ?", {id, 2}).toString(),
+             QString("fail"));
+
+    QVERIFY2(m_storage->saveProgress(m_database, m_statements, ProgressUpdate(id, 600, 10, "started"), &error),
+             qPrintable(error));
+    QCOMPARE(m_storage->getLastProgress(m_database, m_statements, id, &error).first, 600);
+}
+
+void StorageTest::usersPageKeyset() {
+    QList<NewUser> users;
+    for (int i = 0; i < 450; ++i) {
+        users.append({QString("page_%1").arg(i, 3, 10, QLatin1Char('0')), "hash", i % 3 == 0 ? "admin" : "student"});
+    }
+    QString error;
+    QVERIFY2(m_storage->importUsers(m_database, users, &error), qPrintable(error));
+
+    for (const QString& column : {QString("id"), QString("login"), QString("role")}) {
+        for (bool descending : {false, true}) {
+            // Порядок одного большого запроса - эталон для постраничного чтения
+            QList<int> expected;
+            QVERIFY2(readAllPages(column, descending, "page_", 1000, expected, &error), qPrintable(error));
+            QCOMPARE(expected.size(), 450);
+
+            QList<int> paged;
+            QVERIFY2(readAllPages(column, descending, "page_", 200, paged, &error), qPrintable(error));
+            QCOMPARE(paged, expected);
+        }
+    }
+
+    // Символы шаблона LIKE в тексте поиска ищутся буквально
+    QList<int> ids;
+    QVERIFY2(readAllPages("id", false, "page%", 200, ids, &error), qPrintable(error));
+    QVERIFY(ids.isEmpty());
+    QVERIFY2(readAllPages("id", false, "PAGE_04", 200, ids, &error), qPrintable(error));
+    QCOMPARE(ids.size(), 10);
+}
+
+void StorageTest::usersPageSameCreatedAt() {
+    QList<NewUser> users;
+    for (int i = 0; i < 450; ++i) {
+        users.append({QString("same_time_%1").arg(i, 3, 10, QLatin1Char('0')), "hash", "student"});
+    }
+    QString error;
+    QVERIFY2(m_storage->importUsers(m_database, users, &error), qPrintable(error));
+
+    // Время с микросекундами: граница страницы, округленная до миллисекунд,
+    // повторяла или пропускала строки, а при одинаковом времени у всех строк
+    // следующая страница не сдвигалась. Две группы отличаются на 1 мкс
+    QSqlQuery query(m_database);
+    QVERIFY2(query.exec("UPDATE users SET created_at = '2026-01-02 03:04:05.123456' WHERE login LIKE 'same_time_%'"),
+             qPrintable(query.lastError().text()));
+    QVERIFY2(query.exec("UPDATE users SET created_at = '2026-01-02 03:04:05.123457' WHERE login LIKE 'same_time_3%'"),
+             qPrintable(query.lastError().text()));
+
+    for (bool descending : {false, true}) {
+        QList<int> expected;
+        QVERIFY2(readAllPages("created_at", descending, "same_time_", 1000, expected, &error), qPrintable(error));
+        QCOMPARE(expected.size(), 450);
+
+        QList<int> paged;
+        QVERIFY2(readAllPages("created_at", descending, "same_time_", 200, paged, &error), qPrintable(error));
+        QCOMPARE(paged, expected);
+        QCOMPARE(QSet<int>(paged.cbegin(), paged.cend()).size(), 450);
+    }
+}
+
+void StorageTest::importUsers() {
+    QString error;
+    const QList<NewUser> users = {
+        {"import_1", "hash-1", "student"},
+        {"import_2", "hash-2", "student"},
+        {"import_3", "hash-3", "admin"}
+    };
+    QVERIFY2(m_storage->importUsers(m_database, users, &error), qPrintable(error));
+    QCOMPARE(m_storage->getCredentials(m_database, m_statements, "import_3", &error).role, QString("admin"));
+
+    const QSet<QString> existing =
+        m_storage->findExistingLogins(m_database, {"import_1", "import_missing", "import_3"}, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(existing, QSet<QString>({"import_1", "import_3"}));
+
+    // Занятый логин отменяет весь пакет
+    QVERIFY(!m_storage->importUsers(m_database, {{"import_4", "hash", "student"}, {"import_2", "hash", "student"}},
+                                    &error));
+    QVERIFY(!error.isEmpty());
+    error.clear();
+    QVERIFY(m_storage->findExistingLogins(m_database, {"import_4"}, &error).isEmpty());
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void StorageTest::attemptsRollup() {
+    const int chapter = 900;
+    QString error;
+
+    QVERIFY2(m_storage->saveAttempts(m_database, {attempt(chapter, 0, true, 100),
+                                                  attempt(chapter, 0, false, 300),
+                                                  attempt(chapter, 1, true, 200, "passed")}, &error),
+             qPrintable(error));
+    QVERIFY2(m_storage->saveAttempts(m_database, {attempt(chapter, 1, false, 400, "failed")}, &error),
+             qPrintable(error));
+
+    QCOMPARE(scalar("SELECT COUNT(*) FROM question_attempts WHERE chapter_id = ?", {chapter}).toInt(), 4);
+
+    const QList<QSqlRecord> questions = m_storage->getQuestionStats(m_database, m_statements, chapter, &error);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QCOMPARE(questions.size(), 2);
+    QCOMPARE(questions.at(0).value("question_index").toInt(), 0);
+    QCOMPARE(questions.at(0).value("attempts").toLongLong(), 2);
+    QCOMPARE(questions.at(0).value("correct").toLongLong(), 1);
+    QCOMPARE(questions.at(0).value("avg_latency_ms").toLongLong(), 200);
+    QCOMPARE(questions.at(1).value("question_index").toInt(), 1);
+    QCOMPARE(questions.at(1).value("attempts").toLongLong(), 2);
+    QCOMPARE(questions.at(1).value("correct").toLongLong(), 1);
+    QCOMPARE(questions.at(1).value("avg_latency_ms").toLongLong(), 300);
+
+    bool found = false;
+    for (const QSqlRecord& record : m_storage->getChapterStats(m_database, m_statements, &error)) {
+        if (record.value("chapter_id").toInt() == chapter) {
+            found = true;
+            QCOMPARE(record.value("tests_passed").toLongLong(), 1);
+            QCOMPARE(record.value("tests_failed").toLongLong(), 1);
+        }
+    }
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY(found);
+}
+
+void StorageTest::credentialsLatency() {
+    QString error;
+    QVERIFY2(m_storage->registerUser(m_database, m_statements, "latency_dave", "hash", "student", &error),
+             qPrintable(error));
+
+    QBENCHMARK {
+        m_storage->getCredentials(m_database, m_statements, "latency_dave", &error);
+    }
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void StorageTest::usersPageLatency() {
+    UsersPageQuery query;
+    query.sortColumn = "login";
+    query.loginFilter = "page_1";
+    query.limit = 50;
+
+    QString error;
+    QBENCHMARK {
+        m_storage->getUsersPage(m_database, m_statements, query, &error);
+    }
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void StorageTest::statementCacheLatency_data() {
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("credentials, cached") << QString("credentials") << true;
+    QTest::newRow("credentials, uncached") << QString("credentials") << false;
+    QTest::newRow("progress, cached") << QString("progress") << true;
+    QTest::newRow("progress, uncached") << QString("progress") << false;
+}
+
+void StorageTest::statementCacheLatency() {
+    QFETCH(QString, path);
+    QFETCH(bool, cached);
+
+    QString error;
+    int id = m_storage->getCredentials(m_database, m_statements, "latency_cache", &error).id;
+    if (id < 0) {
+        QVERIFY2(m_storage->registerUser(m_database, m_statements, "latency_cache", "hash", "student", &error),
+                 qPrintable(error));
+        id = userId("latency_cache");
+    }
+    const ProgressUpdate update(id, 1, 50, "completed");
+
+    // Без кэша каждый вызов заново готовит запрос, как до StatementCache
+    QBENCHMARK {
+        if (!cached) {
+            m_statements.clear();
+        }
+        if (path == "credentials") {
+            m_storage->getCredentials(m_database, m_statements, "latency_cache", &error);
+        } else {
+            m_storage->saveProgress(m_database, m_statements, update, &error);
+            m_storage->getLastProgress(m_database, m_statements, id, &error);
+        }
+    }
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
+
+void StorageTest::usersSearchBenchmark() {
+    // Размер таблицы: COURSE_BENCH_USERS (цель - 1M пользователей)
+    const int userCount = qEnvironmentVariableIsSet("COURSE_BENCH_USERS")
+                              ? qEnvironmentVariableIntValue("COURSE_BENCH_USERS") : 20000;
+    QVERIFY(userCount > 0);
+
+    QString error;
+    QList<NewUser> users;
+    for (int i = 0; i < userCount; ++i) {
+        users.append({QString("search_%1").arg(i, 7, 10, QLatin1Char('0')), "hash", "student"});
+        if (users.size() == 10000 || i == userCount - 1) {
+            QVERIFY2(m_storage->importUsers(m_database, users, &error), qPrintable(error));
+            users.clear();
+        }
+    }
+    if (m_backend == Storage::Backend::PostgreSQL) {
+        QSqlQuery analyze(m_database);
+        QVERIFY2(analyze.exec("ANALYZE users"), qPrintable(analyze.lastError().text()));
+    }
+
+    // Набор логина по буквам, как в поиске AdminWindow: первая страница
+    // для каждого префикса длиной от трех символов
+    QList<qint64> latencies;
+    QRandomGenerator generator(2024);
+    for (int sample = 0; sample < 50; ++sample) {
+        const QString login = QString("search_%1").arg(generator.bounded(userCount), 7, 10, QLatin1Char('0'));
+        for (int length = 3; length <= login.size(); ++length) {
+            UsersPageQuery query;
+            query.sortColumn = "login";
+            query.loginFilter = login.left(length);
+            query.limit = 50;
+
+            QElapsedTimer timer;
+            timer.start();
+            const QList<QSqlRecord> rows = m_storage->getUsersPage(m_database, m_statements, query, &error);
+            latencies.append(timer.nsecsElapsed());
+            QVERIFY2(error.isEmpty(), qPrintable(error));
+            QVERIFY(!rows.isEmpty());
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double fraction) {
+        return latencies.at(qMin(latencies.size() - 1, static_cast<qsizetype>(latencies.size() * fraction))) / 1e6;
+    };
+    qInfo().noquote() << QString("Login search over %1 users, %2 keystrokes: p50 %3 ms, p99 %4 ms")
+                             .arg(userCount)
+                             .arg(latencies.size())
+                             .arg(percentile(0.50), 0, 'f', 2)
+                             .arg(percentile(0.99), 0, 'f', 2);
+}
+
+void StorageTest::importBenchmark() {
+    // Число строк: COURSE_BENCH_IMPORT_USERS. Время определяет хеширование с
+    // полной стоимостью: около 80 мс на пароль на ядро при 100000 итераций
+    const int userCount = qEnvironmentVariableIsSet("COURSE_BENCH_IMPORT_USERS")
+                              ? qEnvironmentVariableIntValue("COURSE_BENCH_IMPORT_USERS") : 2000;
+    QVERIFY(userCount > 0);
+
+    QStringList logins;
+    for (int i = 0; i < userCount; ++i) {
+        logins << QString("bench_import_%1").arg(i, 7, 10, QLatin1Char('0'));
+    }
+
+    // Те же этапы, что в UserImporter: параллельное хеширование, затем
+    // проверка занятых логинов и одна транзакция
+    QElapsedTimer timer;
+    timer.start();
+    const QList<NewUser> users = QtConcurrent::blockingMapped<QList<NewUser>>(logins, [](const QString& login) {
+        return NewUser{login, CryptoUtils::hashPassword(login), "student"};
+    });
+    const qint64 hashNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    QString error;
+    timer.restart();
+    QVERIFY(m_storage->findExistingLogins(m_database, logins, &error).isEmpty());
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY2(m_storage->importUsers(m_database, users, &error), qPrintable(error));
+    const qint64 insertNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    QCOMPARE(scalar("SELECT COUNT(*) FROM users WHERE login LIKE 'bench_import_%'", {}).toInt(), userCount);
+
+    qInfo().noquote() << QString("Import of %1 users: hashing %2 users/s on %3 threads, insert %4 rows/s, "
+                                 "%5 users/minute overall")
+                             .arg(userCount)
+                             .arg(qRound64(userCount * 1e9 / hashNs))
+                             .arg(QThreadPool::globalInstance()->maxThreadCount())
+                             .arg(qRound64(userCount * 1e9 / insertNs))
+                             .arg(qRound64(userCount * 60e9 / (hashNs + insertNs)));
+}
+
+void StorageTest::progressWriteBenchmark_data() {
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("single") << false;
+    QTest::newRow("batch") << true;
+}
+
+void StorageTest::progressWriteBenchmark() {
+    QFETCH(bool, batched);
+
+    const QString login = batched ? "bench_progress_batch" : "bench_progress_single";
+    QString error;
+    QVERIFY2(m_storage->registerUser(m_database, m_statements, login, "hash", "student", &error), qPrintable(error));
+    const int id = userId(login);
+
+    // Одна отложенная запись прогресса: ответы на 500 глав
+    QList<ProgressUpdate> updates;
+    for (int chapter = 0; chapter < 500; ++chapter) {
+        updates.append(ProgressUpdate(id, chapter, chapter % 100, "completed"));
+    }
+
+    qint64 writes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        if (batched) {
+            QVERIFY2(m_storage->saveProgressBatch(m_database, updates, &error), qPrintable(error));
+        } else {
+            // Прежний путь: запрос и фиксация на каждую главу
+            for (const ProgressUpdate& update : updates) {
+                QVERIFY2(m_storage->saveProgress(m_database, m_statements, update, &error), qPrintable(error));
+            }
+        }
+        writes += updates.size();
+    }
+
+    const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    qInfo().noquote() << QString("%1 progress writes: %2 writes/s")
+                             .arg(batched ? "Batched" : "Single-row")
+                             .arg(qRound64(writes * 1e9 / elapsedNs));
+}
+
+bool StorageTest::readAllPages(const QString& sortColumn, bool descending, const QString& loginFilter,
+                               int limit, QList<int>& ids, QString* errorMessage) {
+    ids.clear();
+
+    UsersPageQuery query;
+    query.sortColumn = sortColumn;
+    query.descending = descending;
+    query.loginFilter = loginFilter;
+    query.limit = limit;
+
+    // Ограничение числа страниц ловит выборку, которая не сдвигается
+    for (int page = 0; page < 1000; ++page) {
+        const QList<QSqlRecord> rows = m_storage->getUsersPage(m_database, m_statements, query, errorMessage);
+        if (!errorMessage->isEmpty()) {
+            return false;
+        }
+        for (const QSqlRecord& row : rows) {
+            ids.append(row.value("id").toInt());
+        }
+        if (rows.size() < limit) {
+            return true;
+        }
+
+        query.hasAfter = true;
+        query.afterValue = rows.last().value("page_key");
+        query.afterId = rows.last().value("id").toInt();
+    }
+
+    *errorMessage = QString("Users pages sorted by %1 do not end").arg(sortColumn);
+    return false;
+}
+
+int StorageTest::userId(const QString& login) {
+    return scalar("SELECT id FROM users WHERE login = ?", {login}).toInt();
+}
+
+QVariant StorageTest::scalar(const QString& sql, const QVariantList& values) {
+    QSqlQuery query(m_database);
+    query.prepare(sql);
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
+    }
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Query failed:" << sql << query.lastError().text();
+        return QVariant();
+    }
+    return query.value(0);
+}
+
+QuestionAttempt StorageTest::attempt(int chapterId, int questionIndex, bool correct, int latencyMs,
+                                     const QString& outcome) {
+    QuestionAttempt attempt;
+    attempt.userId = 1;
+    attempt.chapterId = chapterId;
+    attempt.questionIndex = questionIndex;
+    attempt.chosenOption = correct ? 0 : 1;
+    attempt.correct = correct;
+    attempt.latencyMs = latencyMs;
+    attempt.answeredAt = QDateTime::currentDateTime();
+    attempt.outcome = outcome;
+    return attempt;
+}
+
+/**
+ * @brief Проверки разбора миграций, не зависящие от СУБД.
+ */
+class SchemaMigratorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void splitStatements_data();
+    void splitStatements();
+};
+
+void SchemaMigratorTest::splitStatements_data() {
+    QTest::addColumn<QString>("sql");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("plain") << "CREATE TABLE a (id INT);\nCREATE TABLE b (id INT);\n"
+                           << QStringList{"CREATE TABLE a (id INT)", "CREATE TABLE b (id INT)"};
+    QTest::newRow("no trailing semicolon") << "SELECT 1;\n  SELECT 2  \n" << QStringList{"SELECT 1", "SELECT 2"};
+    QTest::newRow("empty statements") << ";;\n;SELECT 1;;" << QStringList{"SELECT 1"};
+
+    // Удвоенная кавычка внутри строки не закрывает ее
+    QTest::newRow("escaped quote") << "INSERT INTO t VALUES ('it''s; fine', 'a''''b;');\nSELECT 2;"
+                                   << QStringList{"INSERT INTO t VALUES ('it''s; fine', 'a''''b;')", "SELECT 2"};
+    QTest::newRow("quoted identifier") << "SELECT \"odd;\"\"name\" FROM t; SELECT 3"
+                                       << QStringList{"SELECT \"odd;\"\"name\" FROM t", "SELECT 3"};
+
+    // Комментарии вырезаются вместе с точками с запятой в них
+    QTest::newRow("line comment") << "-- создание; таблицы\nCREATE TABLE c (id INT); -- хвост; комментария\n"
+                                     "SELECT 4 -- a;b\n;"
+                                  << QStringList{"CREATE TABLE c (id INT)", "SELECT 4"};
+    QTest::newRow("block comment") << "/* блок; комментария */ SELECT 5; SELECT /* ; */ 6;"
+                                   << QStringList{"SELECT 5", "SELECT   6"};
+    QTest::newRow("dashes in string") << "SELECT '--;'; SELECT 7;" << QStringList{"SELECT '--;'", "SELECT 7"};
+
+    // Тела DO и функций в $$-строках выполняются одним оператором
+    QTest::newRow("do block") << "DO $$\nBEGIN\n    PERFORM 1;\n    RAISE NOTICE 'done;';\nEND\n$$;\nSELECT 8;"
+                              << QStringList{"DO $$\nBEGIN\n    PERFORM 1;\n    RAISE NOTICE 'done;';\nEND\n$$",
+                                             "SELECT 8"};
+    QTest::newRow("tagged dollar quote")
+        << "CREATE FUNCTION f() RETURNS INT AS $body$ SELECT 1; $$ ; $body$ LANGUAGE sql; SELECT 9;"
+        << QStringList{"CREATE FUNCTION f() RETURNS INT AS $body$ SELECT 1; $$ ; $body$ LANGUAGE sql", "SELECT 9"};
+    QTest::newRow("positional parameter") << "PREPARE p AS SELECT $1; EXECUTE p(1);"
+                                          << QStringList{"PREPARE p AS SELECT $1", "EXECUTE p(1)"};
+}
+
+void SchemaMigratorTest::splitStatements() {
+    QFETCH(QString, sql);
+    QFETCH(QStringList, expected);
+
+    QCOMPARE(SchemaMigrator::splitStatements(sql), expected);
+}
+
+/**
+ * @brief Проверки ConnectionPool на SQLite во временном файле.
+ */
+class ConnectionPoolTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void acquireTimesOut();
+    void waitsForReleasedConnection();
+    void healthCheckReconnects();
+    void idleConnectionReopened();
+
+private:
+    ConnectionPool::Settings settings() const;
+
+    QTemporaryDir m_directory;
+};
+
+void ConnectionPoolTest::initTestCase() {
+    QVERIFY(m_directory.isValid());
+}
+
+ConnectionPool::Settings ConnectionPoolTest::settings() const {
+    ConnectionPool::Settings settings;
+    settings.driver = "QSQLITE";
+    settings.databaseName = m_directory.filePath("pool.sqlite");
+    settings.maxSize = 1;
+    settings.acquireTimeoutMs = 5000;
+    return settings;
+}
+
+void ConnectionPoolTest::acquireTimesOut() {
+    ConnectionPool::Settings poolSettings = settings();
+    poolSettings.acquireTimeoutMs = 200;
+    ConnectionPool pool(poolSettings);
+
+    ConnectionPool::Connection held = pool.acquire();
+    QVERIFY(held.isValid());
+
+    bool valid = true;
+    QString error;
+    qint64 waitedMs = 0;
+    std::unique_ptr<QThread> thread(QThread::create([&]() {
+        QElapsedTimer timer;
+        timer.start();
+        ConnectionPool::Connection connection = pool.acquire();
+        waitedMs = timer.elapsed();
+        valid = connection.isValid();
+        error = connection.errorString();
+    }));
+    thread->start();
+    QVERIFY(thread->wait(10000));
+
+    QVERIFY(!valid);
+    QVERIFY2(error.contains("exhausted"), qPrintable(error));
+    QVERIFY2(waitedMs >= 150, qPrintable(QString("waited %1 ms").arg(waitedMs)));
+    QCOMPARE(pool.openCount(), 1);
+    QCOMPARE(pool.waitingCount(), 0);
+}
+
+void ConnectionPoolTest::waitsForReleasedConnection() {
+    ConnectionPool pool(settings());
+
+    ConnectionPool::Connection held = pool.acquire();
+    QVERIFY(held.isValid());
+    const quint64 heldGeneration = held.generation();
+
+    bool valid = false;
+    bool queried = false;
+    std::unique_ptr<QThread> thread(QThread::create([&]() {
+        ConnectionPool::Connection connection = pool.acquire();
+        valid = connection.isValid();
+        if (valid) {
+            QSqlQuery query(connection.database());
+            queried = query.exec("SELECT 1") && query.next();
+        }
+    }));
+    thread->start();
+
+    // Поток ждет, пока основной поток держит единственное соединение
+    QTRY_COMPARE(pool.waitingCount(), 1);
+
+    // Возврат при ожидающем потоке закрывает соединение и отдает место
+    held.release();
+    QVERIFY(thread->wait(10000));
+    QVERIFY(valid);
+    QVERIFY(queried);
+    QTRY_COMPARE(pool.openCount(), 0);
+
+    // Основной поток получает новое подключение
+    ConnectionPool::Connection again = pool.acquire();
+    QVERIFY(again.isValid());
+    QVERIFY(again.generation() != heldGeneration);
+}
+
+void ConnectionPoolTest::healthCheckReconnects() {
+    ConnectionPool::Settings poolSettings = settings();
+    poolSettings.healthCheckIntervalMs = 0;
+    ConnectionPool pool(poolSettings);
+
+    quint64 generation = 0;
+    {
+        ConnectionPool::Connection connection = pool.acquire();
+        QVERIFY(connection.isValid());
+        generation = connection.generation();
+    }
+
+    // Исправное соединение проходит SELECT 1 и выдается повторно
+    QTest::qSleep(5);
+    {
+        ConnectionPool::Connection connection = pool.acquire();
+        QVERIFY(connection.isValid());
+        QCOMPARE(connection.generation(), generation);
+
+        // Разрыв соединения, пока оно простаивает
+        connection.database().close();
+    }
+
+    QTest::qSleep(5);
+    ConnectionPool::Connection connection = pool.acquire();
+    QVERIFY(connection.isValid());
+    QVERIFY(connection.generation() != generation);
+    QCOMPARE(pool.openCount(), 1);
+
+    QSqlQuery query(connection.database());
+    QVERIFY(query.exec("SELECT 1"));
+}
+
+void ConnectionPoolTest::idleConnectionReopened() {
+    ConnectionPool::Settings poolSettings = settings();
+    poolSettings.idleTimeoutMs = 50;
+    ConnectionPool pool(poolSettings);
+
+    quint64 generation = 0;
+    {
+        ConnectionPool::Connection connection = pool.acquire();
+        QVERIFY(connection.isValid());
+        generation = connection.generation();
+        StatementCache* statements = pool.currentStatements();
+        QVERIFY(statements);
+        QVERIFY(statements->prepare(connection.database(), "SELECT ?"));
+        QCOMPARE(statements->size(), 1);
+    }
+
+    // До истечения простоя выдается то же соединение с тем же кэшем
+    {
+        ConnectionPool::Connection connection = pool.acquire();
+        QCOMPARE(connection.generation(), generation);
+        QCOMPARE(pool.currentStatements()->size(), 1);
+    }
+
+    // После простоя соединение переоткрывается, подготовленные запросы сбрасываются
+    QTest::qSleep(100);
+    ConnectionPool::Connection connection = pool.acquire();
+    QVERIFY(connection.isValid());
+    QVERIFY(connection.generation() != generation);
+    QCOMPARE(pool.currentStatements()->size(), 0);
+    QCOMPARE(pool.openCount(), 1);
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    SchemaMigratorTest migratorTest;
+    int status = QTest::qExec(&migratorTest, argc, argv);
+    ConnectionPoolTest poolTest;
+    status |= QTest::qExec(&poolTest, argc, argv);
+    for (Storage::Backend backend : {Storage::Backend::SQLite, Storage::Backend::PostgreSQL}) {
+        StorageTest test(backend);
+        status |= QTest::qExec(&test, argc, argv);
+    }
+    return status;
+}
+
+#include "tst_storage.moc"
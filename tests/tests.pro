@@ -0,0 +1,4 @@
+# Автоматические тесты (QtTest): make check
+TEMPLATE = subdirs
+
+SUBDIRS = storage course database quiz
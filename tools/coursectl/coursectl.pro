@@ -0,0 +1,17 @@
+# Утилита командной строки для CI и ночных задач: компиляция и проверка
+# курса, статистика, отчеты и импорт пользователей без дисплея
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = coursectl
+TEMPLATE = app
+
+DESTDIR = ../../bin
+
+include(../../src/core/core.pri)
+include(../../src/db/db.pri)
+
+SOURCES += \
+    main.cpp
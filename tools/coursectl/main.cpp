@@ -0,0 +1,847 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QThread>
+#include <QThreadPool>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSqlRecord>
+#include <QTextStream>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrentMap>
+#include <functional>
+#include <algorithm>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "core/CourseManager.h"
+#include "core/CourseImage.h"
+#include "core/ChapterCodec.h"
+#include "core/QuizEngine.h"
+#include "core/CryptoUtils.h"
+#include "core/PasswordHasher.h"
+#include "db/DatabaseManager.h"
+#include "db/ReportGenerator.h"
+#include "db/UserImporter.h"
+
+namespace {
+
+// Коды завершения, как у --import-users приложения
+const int EXIT_OK = 0;
+const int EXIT_FAILED = 1;
+const int EXIT_PARTIAL = 2;
+
+// Предел одного запуска в bench-startup
+const int STARTUP_TIMEOUT_MS = 120000;
+
+/**
+ * @brief Итог команды для одного файла.
+ * details - дополнительные поля вывода (размер, число глав и т.п.).
+ */
+struct FileResult {
+    QString file;
+    bool ok;
+    QStringList errors;
+    QJsonObject details;
+
+    FileResult() : ok(false) {}
+};
+
+/**
+ * @brief Параметры вывода и выполнения, общие для команд.
+ */
+struct Options {
+    bool json;
+    int jobs;
+    QString key;
+
+    Options() : json(false), jobs(1) {}
+};
+
+QTextStream& standardOutput() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+/**
+ * @brief Выводит итог: строку JSON (JSON Lines) или строку текста.
+ */
+void printResult(const QString& command, const FileResult& result, const Options& options) {
+    QTextStream& out = standardOutput();
+
+    if (options.json) {
+        QJsonObject object = result.details;
+        object.insert("command", command);
+        if (!result.file.isEmpty()) {
+            object.insert("file", result.file);
+        }
+        object.insert("ok", result.ok);
+        object.insert("errors", QJsonArray::fromStringList(result.errors));
+        out << QJsonDocument(object).toJson(QJsonDocument::Compact) << '\n';
+        out.flush();
+        return;
+    }
+
+    QStringList fields;
+    for (auto it = result.details.constBegin(); it != result.details.constEnd(); ++it) {
+        const QJsonValue value = it.value();
+        if (value.isArray() || value.isObject()) {
+            continue;
+        }
+        fields << QString("%1=%2").arg(it.key(), value.toVariant().toString());
+    }
+
+    out << (result.ok ? "OK   " : "FAIL ") << (result.file.isEmpty() ? command : result.file);
+    if (!fields.isEmpty()) {
+        out << "  " << fields.join(' ');
+    }
+    out << '\n';
+    for (const QString& error : result.errors) {
+        out << "     " << error << '\n';
+    }
+
+    // Строки таблиц (db-stats) выводятся под итогом
+    for (auto it = result.details.constBegin(); it != result.details.constEnd(); ++it) {
+        if (!it.value().isArray()) {
+            continue;
+        }
+        for (const QJsonValue& row : it.value().toArray()) {
+            QStringList rowFields;
+            const QJsonObject rowObject = row.toObject();
+            for (auto field = rowObject.constBegin(); field != rowObject.constEnd(); ++field) {
+                rowFields << QString("%1=%2").arg(field.key(), field.value().toVariant().toString());
+            }
+            out << "     " << rowFields.join(' ') << '\n';
+        }
+    }
+    out.flush();
+}
+
+/**
+ * @brief Обрабатывает файлы параллельно, не больше options.jobs одновременно.
+ * Итоги выводятся в порядке файлов в командной строке.
+ * @return Код завершения: EXIT_FAILED, если хотя бы один файл не обработан
+ */
+int runForFiles(const QString& command, const QStringList& files, const Options& options,
+                std::function<FileResult(const QString&)> function) {
+    if (files.isEmpty()) {
+        qCritical().noquote() << "coursectl" << command << ": no input files";
+        return EXIT_FAILED;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, options.jobs));
+    const QList<FileResult> results = QtConcurrent::blockingMapped<QList<FileResult>>(&pool, files, function);
+
+    int exitCode = EXIT_OK;
+    for (const FileResult& result : results) {
+        printResult(command, result, options);
+        if (!result.ok) {
+            exitCode = EXIT_FAILED;
+        }
+    }
+    return exitCode;
+}
+
+FileResult compileCourse(const QString& jsonPath, const QString& outputDir, const QString& key, quint32 codecId) {
+    FileResult result;
+    result.file = jsonPath;
+
+    const QFileInfo info(jsonPath);
+    const QDir directory(outputDir.isEmpty() ? info.absolutePath() : outputDir);
+    const QString binPath = directory.filePath(info.completeBaseName() + ".bin");
+
+    QElapsedTimer timer;
+    timer.start();
+    result.ok = CourseManager::compileJsonToBinary(jsonPath, binPath, key, codecId);
+    result.details.insert("output", binPath);
+    result.details.insert("elapsedMs", timer.elapsed());
+    if (result.ok) {
+        result.details.insert("bytes", QFileInfo(binPath).size());
+    } else {
+        result.errors << "Failed to compile course";
+    }
+    return result;
+}
+
+FileResult verifyCourse(const QString& binPath, const QString& key) {
+    FileResult result;
+    result.file = binPath;
+    result.ok = CourseManager::verifyCourseFile(binPath, key, &result.errors);
+    return result;
+}
+
+FileResult courseStats(const QString& binPath, const QString& key) {
+    FileResult result;
+    result.file = binPath;
+
+    CourseImage image;
+    if (!image.open(binPath, key)) {
+        result.errors << "Cannot open course file";
+        return result;
+    }
+
+    qint64 questions = 0;
+    for (int i = 0; i < image.chapterCount(); ++i) {
+        Chapter chapter;
+        QString error;
+        if (!image.readChapter(i, chapter, &error)) {
+            result.errors << error;
+            continue;
+        }
+        questions += chapter.questions.size();
+    }
+
+    result.ok = result.errors.isEmpty();
+    result.details.insert("version", image.formatVersion());
+    result.details.insert("codec", image.codec() ? QString::fromLatin1(image.codec()->name) : QString("none"));
+    result.details.insert("chapters", image.chapterCount());
+    result.details.insert("questions", questions);
+    result.details.insert("bytes", QFileInfo(binPath).size());
+    result.details.insert("journalBytes", image.journalLength());
+    return result;
+}
+
+/**
+ * @brief Записанные последовательности ответов одной главы подряд в одном
+ * массиве, как их принимает QuizEngine::gradeBatch().
+ */
+struct RecordedAnswers {
+    QList<int> options;
+    QList<qsizetype> offsets;
+
+    RecordedAnswers() : offsets({0}) {}
+};
+
+/**
+ * @brief Читает последовательности ответов: строки "chapter,option option ...",
+ * необязательный заголовок и строки, начинающиеся с #, пропускаются.
+ * @return Последовательности по индексам глав
+ */
+bool readAnswerSequences(const QString& filePath, QMap<int, RecordedAnswers>& sequences, QString* errorMessage) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *errorMessage = QString("Cannot open answers file: %1").arg(file.errorString());
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#') || (lineNumber == 1 && line.startsWith("chapter"))) {
+            continue;
+        }
+
+        const int comma = line.indexOf(',');
+        bool ok = false;
+        const int chapter = line.left(comma).trimmed().toInt(&ok);
+        if (comma < 0 || !ok || chapter < 0) {
+            *errorMessage = QString("Invalid chapter on line %1").arg(lineNumber);
+            return false;
+        }
+
+        RecordedAnswers& answers = sequences[chapter];
+        for (const QByteArray& option : line.mid(comma + 1).simplified().split(' ')) {
+            if (option.isEmpty()) {
+                continue;
+            }
+            answers.options.append(option.toInt(&ok));
+            if (!ok) {
+                *errorMessage = QString("Invalid option on line %1").arg(lineNumber);
+                return false;
+            }
+        }
+        answers.offsets.append(answers.options.size());
+    }
+    return true;
+}
+
+FileResult gradeCourse(const QString& binPath, const QString& key, const QMap<int, RecordedAnswers>& sequences) {
+    FileResult result;
+    result.file = binPath;
+
+    CourseImage image;
+    if (!image.open(binPath, key)) {
+        result.errors << "Cannot open course file";
+        return result;
+    }
+
+    // Ключи ответов готовятся до замера: в пакет входит только проверка
+    QMap<int, QuizEngine::AnswerKey> answerKeys;
+    for (auto it = sequences.constBegin(); it != sequences.constEnd(); ++it) {
+        Chapter chapter;
+        QString error;
+        if (it.key() >= image.chapterCount()) {
+            result.errors << QString("Chapter %1 is not in the course").arg(it.key());
+        } else if (!image.readChapter(it.key(), chapter, &error)) {
+            result.errors << error;
+        } else {
+            answerKeys.insert(it.key(), QuizEngine::answerKey(chapter));
+        }
+    }
+
+    QJsonArray chapters;
+    QuizEngine::BatchSummary total;
+    qint64 graded = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (auto it = answerKeys.constBegin(); it != answerKeys.constEnd(); ++it) {
+        const RecordedAnswers& answers = sequences.constFind(it.key()).value();
+        const QuizEngine::BatchSummary summary = QuizEngine::gradeBatch(it.value(), answers.options, answers.offsets);
+        total.passed += summary.passed;
+        total.failed += summary.failed;
+        total.incomplete += summary.incomplete;
+        graded += answers.offsets.size() - 1;
+
+        QJsonObject chapter;
+        chapter.insert("chapter", it.key());
+        chapter.insert("passed", summary.passed);
+        chapter.insert("failed", summary.failed);
+        chapter.insert("incomplete", summary.incomplete);
+        chapters.append(chapter);
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    result.ok = result.errors.isEmpty();
+    result.details.insert("sequences", graded);
+    result.details.insert("passed", total.passed);
+    result.details.insert("failed", total.failed);
+    result.details.insert("incomplete", total.incomplete);
+    result.details.insert("sequencesPerSecond", elapsedNs > 0 ? qRound64(graded * 1e9 / elapsedNs) : graded);
+    result.details.insert("chapters", chapters);
+    return result;
+}
+
+/**
+ * @brief Открывает соединение потока и применяет миграции, как приложение.
+ */
+bool openDatabase(FileResult& result) {
+    DatabaseManager& db = DatabaseManager::getInstance();
+    if (!db.connectToDatabase() || !db.initDatabase()) {
+        result.errors << db.getLastError();
+        return false;
+    }
+    return true;
+}
+
+QJsonArray recordsToJson(const QList<QSqlRecord>& records) {
+    QJsonArray rows;
+    for (const QSqlRecord& record : records) {
+        QJsonObject row;
+        for (int i = 0; i < record.count(); ++i) {
+            row.insert(record.fieldName(i), QJsonValue::fromVariant(record.value(i)));
+        }
+        rows.append(row);
+    }
+    return rows;
+}
+
+FileResult databaseStats(int chapterId) {
+    FileResult result;
+    if (!openDatabase(result)) {
+        return result;
+    }
+
+    DatabaseManager& db = DatabaseManager::getInstance();
+    const QList<QSqlRecord> records = chapterId >= 0 ? db.getQuestionStats(chapterId) : db.getChapterStats();
+    if (!db.getLastError().isEmpty()) {
+        result.errors << db.getLastError();
+        return result;
+    }
+
+    result.ok = true;
+    if (chapterId >= 0) {
+        result.details.insert("chapter", chapterId);
+    }
+    result.details.insert(chapterId >= 0 ? "questions" : "chapters", recordsToJson(records));
+    return result;
+}
+
+FileResult exportReport(const QString& filePath, ReportGenerator::Format format) {
+    FileResult result;
+    result.file = filePath;
+    if (!openDatabase(result)) {
+        return result;
+    }
+
+    // Отчет строится в потоке ReportGenerator, сигналы принимает этот цикл событий
+    ReportGenerator generator;
+    QEventLoop loop;
+    QObject::connect(&generator, &ReportGenerator::finished, &loop, [&](const QString&, qint64 totalRows) {
+        result.ok = true;
+        result.details.insert("rows", totalRows);
+        loop.quit();
+    });
+    QObject::connect(&generator, &ReportGenerator::failed, &loop, [&](const QString& error) {
+        result.errors << error;
+        loop.quit();
+    });
+    QObject::connect(&generator, &ReportGenerator::canceled, &loop, [&]() {
+        result.errors << "Report canceled";
+        loop.quit();
+    });
+
+    if (!generator.start(filePath, format)) {
+        result.errors << "Report generation is already running";
+        return result;
+    }
+    loop.exec();
+    return result;
+}
+
+FileResult importUsers(const QString& csvPath, int* exitCode) {
+    FileResult result;
+    result.file = csvPath;
+    if (!openDatabase(result)) {
+        *exitCode = EXIT_FAILED;
+        return result;
+    }
+
+    UserImporter importer;
+    const UserImporter::Result imported = importer.importFile(csvPath);
+    if (!imported.rejected.isEmpty()) {
+        result.details.insert("rejected", static_cast<qint64>(imported.rejected.size()));
+        result.details.insert("errorReport", UserImporter::errorReportPath(csvPath));
+    }
+    if (!imported.ok()) {
+        result.errors << imported.error;
+        *exitCode = EXIT_FAILED;
+        return result;
+    }
+
+    result.ok = true;
+    result.details.insert("rows", imported.rowsRead);
+    result.details.insert("imported", imported.imported);
+    result.details.insert("rejected", static_cast<qint64>(imported.rejected.size()));
+    *exitCode = imported.rejected.isEmpty() ? EXIT_OK : EXIT_PARTIAL;
+    return result;
+}
+
+/**
+ * @brief Замеряет вход в начале занятия: logins одновременных проверок
+ * пароля в PasswordHasher для хеша с заданным числом итераций.
+ * Каждая проверка стоит ровно iterations итераций: пересчет хеша до
+ * текущей стоимости (configuredIterations) в замер не входит.
+ */
+FileResult benchmarkLogins(int iterations, int logins) {
+    FileResult result;
+    result.details.insert("iterations", iterations);
+    result.details.insert("configuredIterations", CryptoUtils::passwordIterations());
+    result.details.insert("logins", logins);
+
+    const QString password = QStringLiteral("bench-password");
+    const QString storedHash = CryptoUtils::hashPassword(password, iterations);
+
+    PasswordHasher& hasher = PasswordHasher::getInstance();
+    QList<QFuture<PasswordHasher::Verification>> futures;
+    futures.reserve(logins);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < logins; ++i) {
+        // Стоимость строки задается явно: иначе verify() пересчитывает хеш
+        // с текущей стоимостью, и замер смешивает две стоимости
+        futures.append(hasher.verify(password, storedHash, iterations));
+    }
+
+    qint64 accepted = 0;
+    for (QFuture<PasswordHasher::Verification>& future : futures) {
+        const PasswordHasher::Verification verification = future.result();
+        if (!verification.accepted) {
+            continue;
+        }
+        accepted++;
+        if (!verification.valid) {
+            result.errors << "Password verification failed";
+            return result;
+        }
+    }
+    const qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    // Отклоненные входы - очередь заполнена (COURSE_HASH_QUEUE)
+    result.ok = true;
+    result.details.insert("accepted", accepted);
+    result.details.insert("rejected", logins - accepted);
+    result.details.insert("elapsedMs", elapsedNs / 1000000);
+    result.details.insert("loginsPerSecond", qRound64(accepted * 1e9 / elapsedNs));
+    return result;
+}
+
+
+/**
+ * @brief Времена одного холодного запуска приложения, мс.
+ * course и ready - из --startup-trace, process - до завершения процесса.
+ */
+struct StartupRun {
+    qint64 processMs;
+    qint64 courseMs;
+    qint64 readyMs;
+};
+
+/**
+ * @brief Сбрасывает страничный кэш перед холодным запуском.
+ * Нужны права root: запись в /proc/sys/vm/drop_caches.
+ */
+bool dropPageCache(QString* errorMessage) {
+#ifdef Q_OS_LINUX
+    ::sync();
+    QFile dropCaches("/proc/sys/vm/drop_caches");
+    if (dropCaches.open(QIODevice::WriteOnly | QIODevice::Unbuffered) && dropCaches.write("3\n") == 2) {
+        return true;
+    }
+    *errorMessage = QString("Cannot drop page cache (run as root): %1").arg(dropCaches.errorString());
+    return false;
+#else
+    *errorMessage = "Cold page cache is supported on Linux only";
+    return false;
+#endif
+}
+
+/**
+ * @brief Запускает приложение с --startup-trace --startup-exit и
+ * извлекает из отчета время этапа course и отметки ready.
+ */
+bool runStartup(const QString& executable, StartupRun& run, QString* errorMessage) {
+    static const QRegularExpression coursePhase(R"(^\s+course\s+\d+\s+\d+\s+(\d+)\s+finished\b)",
+                                                QRegularExpression::MultilineOption);
+    static const QRegularExpression readyMark(R"(^\s+ready\s+(\d+)\s*$)", QRegularExpression::MultilineOption);
+
+    // Окно входа не показывается, но QApplication нужна платформа без дисплея
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    if (!environment.contains("QT_QPA_PLATFORM")) {
+        environment.insert("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProcessChannelMode(QProcess::MergedChannels);
+
+    QElapsedTimer timer;
+    timer.start();
+    process.start(executable, {"--startup-trace", "--startup-exit"});
+    if (!process.waitForFinished(STARTUP_TIMEOUT_MS)) {
+        process.kill();
+        process.waitForFinished();
+        *errorMessage = QString("Startup did not finish in %1 ms: %2")
+                            .arg(STARTUP_TIMEOUT_MS)
+                            .arg(process.errorString());
+        return false;
+    }
+    run.processMs = timer.elapsed();
+
+    const QString output = QString::fromLocal8Bit(process.readAll());
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        *errorMessage = QString("Startup failed (exit code %1): %2")
+                            .arg(process.exitCode())
+                            .arg(output.trimmed().section('\n', -3));
+        return false;
+    }
+
+    const QRegularExpressionMatch course = coursePhase.match(output);
+    const QRegularExpressionMatch ready = readyMark.match(output);
+    if (!course.hasMatch() || !ready.hasMatch()) {
+        *errorMessage = "No startup trace in the output (debug messages disabled?)";
+        return false;
+    }
+    run.courseMs = course.captured(1).toLongLong();
+    run.readyMs = ready.captured(1).toLongLong();
+    return true;
+}
+
+qint64 median(QList<qint64> values) {
+    std::sort(values.begin(), values.end());
+    return values.isEmpty() ? 0 : values.at(values.size() / 2);
+}
+
+/**
+ * @brief Сравнивает холодный запуск нескольких сборок приложения
+ * (например, с файлом курса и со встроенным курсом). Перед каждым
+ * запуском сбрасывается страничный кэш; запуски сборок чередуются.
+ * Первый запуск каждой сборки не учитывается: он проверяет сборку и
+ * при необходимости создает data/course.bin.
+ * @return Итог для каждой сборки; медианы времен и ускорение
+ * относительно первой сборки
+ */
+QList<FileResult> benchmarkStartup(const QStringList& executables, int runs) {
+    QList<FileResult> results;
+    QList<QList<StartupRun>> samples;
+    for (const QString& executable : executables) {
+        FileResult result;
+        result.file = executable;
+        StartupRun warmup;
+        QString error;
+        if (!runStartup(executable, warmup, &error)) {
+            result.errors << error;
+        }
+        results.append(result);
+        samples.append(QList<StartupRun>());
+    }
+
+    for (int i = 0; i < runs; ++i) {
+        for (int e = 0; e < executables.size(); ++e) {
+            if (!results.at(e).errors.isEmpty()) {
+                continue;
+            }
+            StartupRun run;
+            QString error;
+            if (!dropPageCache(&error) || !runStartup(executables.at(e), run, &error)) {
+                results[e].errors << error;
+                continue;
+            }
+            samples[e].append(run);
+        }
+    }
+
+    qint64 firstCourseMs = 0;
+    qint64 firstProcessMs = 0;
+    for (int e = 0; e < results.size(); ++e) {
+        FileResult& result = results[e];
+        if (!result.errors.isEmpty()) {
+            continue;
+        }
+
+        QList<qint64> processMs;
+        QList<qint64> courseMs;
+        QList<qint64> readyMs;
+        for (const StartupRun& run : samples.at(e)) {
+            processMs.append(run.processMs);
+            courseMs.append(run.courseMs);
+            readyMs.append(run.readyMs);
+        }
+
+        result.ok = true;
+        result.details.insert("runs", runs);
+        result.details.insert("courseMs", median(courseMs));
+        result.details.insert("readyMs", median(readyMs));
+        result.details.insert("processMs", median(processMs));
+        if (e == 0) {
+            firstCourseMs = median(courseMs);
+            firstProcessMs = median(processMs);
+        } else {
+            const qint64 courseMedian = qMax<qint64>(1, median(courseMs));
+            const qint64 processMedian = qMax<qint64>(1, median(processMs));
+            result.details.insert("courseSpeedup", qRound(100.0 * firstCourseMs / courseMedian) / 100.0);
+            result.details.insert("processSpeedup", qRound(100.0 * firstProcessMs / processMedian) / 100.0);
+        }
+    }
+    return results;
+}
+
+} // namespace
+
+/**
+ * @brief Утилита командной строки для CI и ночных задач.
+ * Не требует дисплея (QCoreApplication); --json выводит по одному
+ * JSON объекту на строку.
+ * @param argc количество аргументов командной строки
+ * @param argv массив аргументов командной строки
+ * @return код завершения: 0 - успех, 1 - ошибка, 2 - импорт с отклоненными строками
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("coursectl");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless course and database tool.\n\n"
+        "Commands:\n"
+        "  compile <course.json>...    Compile JSON courses to encrypted .bin files\n"
+        "  verify <course.bin>...      Verify header and chapter checksums\n"
+        "  stats <course.bin>...       Print course format, chapter and question counts\n"
+        "  db-stats [--chapter N]      Print per-chapter (or per-question) test statistics\n"
+        "  report <file>               Export the users report (--format text|csv|json)\n"
+        "  import-users <file.csv>     Register users from CSV (login,password[,role])\n"
+        "  grade <answers.csv> <course.bin>...\n"
+        "                              Grade recorded answer sequences (chapter,option option ...)\n"
+        "                              against each course file\n"
+        "  bench-login                 Measure logins per second at several PBKDF2 costs\n"
+        "                              (--iterations, --logins)\n"
+        "  bench-startup <CourseProject>...\n"
+        "                              Compare cold starts of application builds via --startup-trace\n"
+        "                              (--runs; drops the page cache, needs root)");
+    parser.addHelpOption();
+
+    QCommandLineOption jsonOption("json", "Machine-readable output: one JSON object per line.");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "Course files processed in parallel.", "n",
+                                  QString::number(QThread::idealThreadCount()));
+    QCommandLineOption keyOption("key", "Course encryption key.", "key", QStringLiteral(COURSE_ENCRYPTION_KEY));
+    QCommandLineOption outputDirOption(QStringList() << "o" << "output-dir",
+                                       "compile: output directory (default: next to the input).", "dir");
+    QCommandLineOption codecOption("codec", "compile: chapter codec (none, zlib, zlib-fast).", "codec", "zlib");
+    QCommandLineOption formatOption("format", "report: text, csv or json.", "format", "text");
+    QCommandLineOption chapterOption("chapter", "db-stats: print question statistics of one chapter.", "id");
+    QCommandLineOption iterationsOption("iterations", "bench-login: comma-separated PBKDF2 iteration counts.",
+                                        "list", "10000,100000,300000");
+    QCommandLineOption loginsOption("logins", "bench-login: simultaneous logins per cost.", "n", "300");
+    QCommandLineOption runsOption("runs", "bench-startup: cold starts per build.", "n", "5");
+    QCommandLineOption verboseOption("verbose", "Print debug messages to stderr.");
+    parser.addOptions({jsonOption, jobsOption, keyOption, outputDirOption, codecOption, formatOption,
+                       chapterOption, iterationsOption, loginsOption, runsOption, verboseOption});
+    parser.addPositionalArgument("command",
+                                 "compile, verify, stats, db-stats, report, import-users, grade, "
+                                 "bench-login or bench-startup.");
+    parser.addPositionalArgument("files", "Input files.", "[files...]");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(EXIT_FAILED);
+    }
+    const QString command = args.takeFirst();
+
+    // Журнал отладки библиотек не смешивается с выводом для CI
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+    }
+
+    Options options;
+    options.json = parser.isSet(jsonOption);
+    options.jobs = parser.value(jobsOption).toInt();
+    options.key = parser.value(keyOption);
+
+    if (command == "compile") {
+        const ChapterCodec* codec = ChapterCodec::byName(parser.value(codecOption));
+        if (!codec) {
+            qCritical().noquote() << "Unknown codec:" << parser.value(codecOption);
+            return EXIT_FAILED;
+        }
+        const QString outputDir = parser.value(outputDirOption);
+        if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+            qCritical().noquote() << "Cannot create output directory:" << outputDir;
+            return EXIT_FAILED;
+        }
+        const quint32 codecId = codec->id;
+        return runForFiles(command, args, options, [outputDir, options, codecId](const QString& file) {
+            return compileCourse(file, outputDir, options.key, codecId);
+        });
+    }
+
+    if (command == "verify") {
+        return runForFiles(command, args, options, [options](const QString& file) {
+            return verifyCourse(file, options.key);
+        });
+    }
+
+    if (command == "stats") {
+        return runForFiles(command, args, options, [options](const QString& file) {
+            return courseStats(file, options.key);
+        });
+    }
+
+    if (command == "grade") {
+        if (args.size() < 2) {
+            qCritical() << "Usage: coursectl grade <answers.csv> <course.bin>...";
+            return EXIT_FAILED;
+        }
+        QMap<int, RecordedAnswers> sequences;
+        QString error;
+        if (!readAnswerSequences(args.takeFirst(), sequences, &error)) {
+            qCritical().noquote() << error;
+            return EXIT_FAILED;
+        }
+        return runForFiles(command, args, options, [options, &sequences](const QString& file) {
+            return gradeCourse(file, options.key, sequences);
+        });
+    }
+
+    if (command == "db-stats") {
+        int chapterId = -1;
+        if (parser.isSet(chapterOption)) {
+            bool ok = false;
+            chapterId = parser.value(chapterOption).toInt(&ok);
+            if (!ok || chapterId < 0) {
+                qCritical().noquote() << "Invalid chapter id:" << parser.value(chapterOption);
+                return EXIT_FAILED;
+            }
+        }
+        const FileResult result = databaseStats(chapterId);
+        printResult(command, result, options);
+        return result.ok ? EXIT_OK : EXIT_FAILED;
+    }
+
+    if (command == "report") {
+        static const QStringList formats = {"text", "csv", "json"};
+        const int formatIndex = formats.indexOf(parser.value(formatOption));
+        if (args.size() != 1 || formatIndex < 0) {
+            qCritical() << "Usage: coursectl report <file> [--format text|csv|json]";
+            return EXIT_FAILED;
+        }
+        const ReportGenerator::Format format = formatIndex == 1 ? ReportGenerator::Format::Csv
+                                             : formatIndex == 2 ? ReportGenerator::Format::Json
+                                                                : ReportGenerator::Format::Text;
+        const FileResult result = exportReport(args.first(), format);
+        printResult(command, result, options);
+        return result.ok ? EXIT_OK : EXIT_FAILED;
+    }
+
+    if (command == "import-users") {
+        if (args.size() != 1) {
+            qCritical() << "Usage: coursectl import-users <file.csv>";
+            return EXIT_FAILED;
+        }
+        int exitCode = EXIT_OK;
+        const FileResult result = importUsers(args.first(), &exitCode);
+        printResult(command, result, options);
+        return exitCode;
+    }
+
+    if (command == "bench-login") {
+        bool ok = false;
+        const int logins = parser.value(loginsOption).toInt(&ok);
+        if (!ok || logins <= 0) {
+            qCritical().noquote() << "Invalid login count:" << parser.value(loginsOption);
+            return EXIT_FAILED;
+        }
+
+        int exitCode = EXIT_OK;
+        for (const QString& value : parser.value(iterationsOption).split(',', Qt::SkipEmptyParts)) {
+            const int iterations = value.trimmed().toInt(&ok);
+            if (!ok || iterations <= 0) {
+                qCritical().noquote() << "Invalid iteration count:" << value;
+                return EXIT_FAILED;
+            }
+            const FileResult result = benchmarkLogins(iterations, logins);
+            printResult(command, result, options);
+            if (!result.ok) {
+                exitCode = EXIT_FAILED;
+            }
+        }
+        return exitCode;
+    }
+
+    if (command == "bench-startup") {
+        bool ok = false;
+        const int runs = parser.value(runsOption).toInt(&ok);
+        if (!ok || runs <= 0) {
+            qCritical().noquote() << "Invalid run count:" << parser.value(runsOption);
+            return EXIT_FAILED;
+        }
+        if (args.isEmpty()) {
+            qCritical() << "Usage: coursectl bench-startup <CourseProject>... [--runs N]";
+            return EXIT_FAILED;
+        }
+
+        int exitCode = EXIT_OK;
+        for (const FileResult& result : benchmarkStartup(args, runs)) {
+            printResult(command, result, options);
+            if (!result.ok) {
+                exitCode = EXIT_FAILED;
+            }
+        }
+        return exitCode;
+    }
+
+    qCritical().noquote() << "Unknown command:" << command;
+    parser.showHelp(EXIT_FAILED);
+}
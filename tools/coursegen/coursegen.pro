@@ -0,0 +1,13 @@
+# Генератор встроенного курса: JSON -> образ курса в виде исходника C++
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = coursegen
+TEMPLATE = app
+
+include(../../src/core/core.pri)
+
+SOURCES += \
+    main.cpp
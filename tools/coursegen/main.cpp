@@ -0,0 +1,117 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+
+#include "core/CourseManager.h"
+
+namespace {
+
+// Байт в строке сгенерированного массива
+const int BYTES_PER_LINE = 16;
+
+/**
+ * @brief Формирует исходник C++ с образом курса и реализацией EmbeddedCourse.
+ * @param image Образ курса в формате course.bin
+ * @param sourceName Имя исходного JSON файла для комментария
+ * @return Текст исходного файла
+ */
+QByteArray generateSource(const QByteArray& image, const QString& sourceName) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    QByteArray source;
+    // "0x00," на каждый байт плюс переводы строк и обрамление
+    source.reserve(image.size() * 5 + image.size() / BYTES_PER_LINE * 5 + 1024);
+
+    source += "// Generated by coursegen from " + sourceName.toUtf8() + ". Do not edit.\n";
+    source += "#include \"core/EmbeddedCourse.h\"\n\n";
+    source += "namespace {\n\n";
+    source += "alignas(64) const uchar courseImage[] = {";
+
+    for (qsizetype i = 0; i < image.size(); ++i) {
+        if (i % BYTES_PER_LINE == 0) {
+            source += "\n    ";
+        }
+        uchar byte = static_cast<uchar>(image[i]);
+        source += "0x";
+        source += HEX_DIGITS[byte >> 4];
+        source += HEX_DIGITS[byte & 0x0F];
+        source += ',';
+    }
+
+    source += "\n};\n\n";
+    source += "} // namespace\n\n";
+    source += "const uchar* EmbeddedCourse::data() {\n    return courseImage;\n}\n\n";
+    source += "qint64 EmbeddedCourse::size() {\n    return static_cast<qint64>(sizeof(courseImage));\n}\n";
+    return source;
+}
+
+} // namespace
+
+/**
+ * @brief Преобразует JSON файл курса в исходник C++ со встроенным образом курса.
+ * Вызывается при сборке приложения с CONFIG+=embed_course.
+ * @param argc количество аргументов командной строки
+ * @param argv массив аргументов командной строки
+ * @return код завершения
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("coursegen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compiles a JSON course into an embedded C++ course image.");
+    parser.addHelpOption();
+    QCommandLineOption keyOption("key", "Course encryption key.", "key");
+    parser.addOption(keyOption);
+    parser.addPositionalArgument("input", "Course source JSON file.");
+    parser.addPositionalArgument("output", "Generated C++ source file.");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2 || !parser.isSet(keyOption)) {
+        parser.showHelp(1);
+    }
+
+    const QString jsonPath = args.at(0);
+    const QString outputPath = args.at(1);
+
+    // Образ собирается тем же CourseWriter, что и data/course.bin
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        qCritical() << "Cannot create temporary directory:" << tempDir.errorString();
+        return 1;
+    }
+
+    const QString binPath = tempDir.filePath("course.bin");
+    if (!CourseManager::compileJsonToBinary(jsonPath, binPath, parser.value(keyOption))) {
+        qCritical() << "Failed to compile course:" << jsonPath;
+        return 1;
+    }
+
+    QFile binFile(binPath);
+    if (!binFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot read compiled course:" << binPath;
+        return 1;
+    }
+    const QByteArray image = binFile.readAll();
+    binFile.close();
+
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly)) {
+        qCritical() << "Cannot open output file:" << outputPath;
+        return 1;
+    }
+
+    output.write(generateSource(image, QFileInfo(jsonPath).fileName()));
+    if (!output.commit()) {
+        qCritical() << "Failed to write output file:" << output.errorString();
+        return 1;
+    }
+
+    qDebug() << "Embedded course image:" << image.size() << "bytes ->" << outputPath;
+    return 0;
+}